@@ -0,0 +1,189 @@
+#include "Pipeline/TopoPipeline.h"
+
+#include <tbb/tbb.h>
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <mutex>
+
+#if defined(GCC_VERSION_LESS_8)
+#include <experimental/filesystem>
+    using namespace std::experimental::filesystem;
+#else
+#include <filesystem>
+using namespace std::filesystem;
+#endif
+
+void printUsage()
+{
+    std::cerr << "Usage: TopoBatch [options] inputs...\n"
+              << "  Run the cross mesh -> structure -> contact graph -> interlocking pipeline on every input\n"
+              << "  and write one JSON line per input. An input is a .xml/.json project, a .puz voxel puzzle or a directory:\n"
+              << "  a directory with .obj files is one part set, otherwise its .xml/.json/.puz inputs are processed.\n\n"
+              << "  -j, --threads N       use at most N threads (default: all the cores)\n"
+              << "  -s, --solver NAME     clp_simplex (default), clp_barrier or pdhg\n"
+              << "  -t, --translational   check the translational instead of the rotational interlocking\n"
+              << "  -e, --contact-eps E   contact tolerance in the unit box (default: 1e-3)\n"
+              << "  -b, --boundary A,B    stems of the .obj parts fixed as boundary, besides the \"*boundary*\" ones\n"
+              << "                        (part_k for the label k of a puzzle)\n"
+              << "  -o, --output FILE     write the JSON lines into FILE instead of the standard output\n";
+}
+
+vector<std::string> split(const std::string &text, char separator)
+{
+    vector<std::string> tokens;
+    std::stringstream stream(text);
+    std::string token;
+    while(std::getline(stream, token, separator)){
+        if(!token.empty()) tokens.push_back(token);
+    }
+    return tokens;
+}
+
+// std::stoi/stof without the exceptions, the whole text must be a number
+bool parseInt(const std::string &text, int &value)
+{
+    try{
+        size_t end;
+        value = std::stoi(text, &end);
+        return end == text.size();
+    }
+    catch(const std::logic_error &){     // std::invalid_argument and std::out_of_range
+        return false;
+    }
+}
+
+bool parseFloat(const std::string &text, float &value)
+{
+    try{
+        size_t end;
+        value = std::stof(text, &end);
+        return end == text.size();
+    }
+    catch(const std::logic_error &){
+        return false;
+    }
+}
+
+// a directory with .obj files is one job, otherwise each of its projects is
+void collectInputs(const std::string &input, vector<std::string> &inputs)
+{
+    if(!is_directory(input)){
+        inputs.push_back(input);
+        return;
+    }
+
+    vector<std::string> projects;
+    for(const auto &entry: directory_iterator(input))
+    {
+        std::string extension = entry.path().extension().string();
+        if(extension == ".obj"){
+            inputs.push_back(input);
+            return;
+        }
+        if(extension == ".xml" || extension == ".json" || extension == ".puz") projects.push_back(entry.path().string());
+    }
+    std::sort(projects.begin(), projects.end());
+    inputs.insert(inputs.end(), projects.begin(), projects.end());
+}
+
+int main(int argc, char **argv)
+{
+    PipelineJob jobSetting;
+    int num_threads = tbb::this_task_arena::max_concurrency();
+    std::string output;
+    vector<std::string> inputs;
+
+    for(int id = 1; id < argc; id++)
+    {
+        std::string arg = argv[id];
+        bool hasValue = id + 1 < argc;
+        if((arg == "-j" || arg == "--threads") && hasValue){
+            if(!parseInt(argv[++id], num_threads)){
+                std::cerr << "invalid number of threads: " << argv[id] << std::endl;
+                printUsage();
+                return 2;
+            }
+            num_threads = std::max(1, num_threads);
+        }
+        else if((arg == "-s" || arg == "--solver") && hasValue){
+            std::string name = argv[++id];
+            if(name == "clp_simplex") jobSetting.solverType = TopoPipeline<double>::CLP_SIMPLEX;
+            else if(name == "clp_barrier") jobSetting.solverType = TopoPipeline<double>::CLP_BARRIER;
+            else if(name == "pdhg") jobSetting.solverType = TopoPipeline<double>::PDHG;
+            else{
+                std::cerr << "unknown solver: " << name << std::endl;
+                return 2;
+            }
+        }
+        else if(arg == "-t" || arg == "--translational"){
+            jobSetting.rotational = false;
+        }
+        else if((arg == "-e" || arg == "--contact-eps") && hasValue){
+            if(!parseFloat(argv[++id], jobSetting.contactEps)){
+                std::cerr << "invalid contact tolerance: " << argv[id] << std::endl;
+                printUsage();
+                return 2;
+            }
+        }
+        else if((arg == "-b" || arg == "--boundary") && hasValue){
+            jobSetting.boundaryParts = split(argv[++id], ',');
+        }
+        else if((arg == "-o" || arg == "--output") && hasValue){
+            output = argv[++id];
+        }
+        else if(arg == "-h" || arg == "--help"){
+            printUsage();
+            return 0;
+        }
+        else if(!arg.empty() && arg[0] == '-'){
+            printUsage();
+            return 2;
+        }
+        else{
+            collectInputs(arg, inputs);
+        }
+    }
+
+    if(inputs.empty()){
+        printUsage();
+        return 2;
+    }
+
+    // the library reports its progress on std::cout, it goes to stderr so that stdout only has the JSON lines
+    std::ofstream fileout;
+    if(!output.empty()){
+        fileout.open(output);
+        if(fileout.fail()){
+            std::cerr << "cannot open " << output << std::endl;
+            return 2;
+        }
+    }
+    std::ostream out(output.empty() ? std::cout.rdbuf() : fileout.rdbuf());
+    std::streambuf *coutbuf = std::cout.rdbuf(std::cerr.rdbuf());
+
+    std::mutex outMutex;
+    std::atomic<int> num_failed(0);
+
+    // the inputs and the parallel loops inside the pipeline share the same bounded arena
+    tbb::task_arena arena(num_threads);
+    arena.execute([&]{
+        tbb::parallel_for(tbb::blocked_range<size_t>(0, inputs.size(), 1), [&](const tbb::blocked_range<size_t>& r)
+        {
+            for(size_t id = r.begin(); id != r.end(); ++id)
+            {
+                PipelineJob job = jobSetting;
+                job.input = inputs[id];
+                TopoPipeline<double> pipeline;
+                PipelineResult result = pipeline.run(job);
+                if(!result.success) num_failed++;
+
+                std::lock_guard<std::mutex> lock(outMutex);
+                out << result.to_json().dump() << std::endl;
+            }
+        });
+    });
+
+    std::cout.rdbuf(coutbuf);
+    return num_failed > 0 ? 1 : 0;
+}
@@ -0,0 +1,253 @@
+#include "Pipeline/PipelineQueue.h"
+
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <csignal>
+#include <unistd.h>
+
+#include <atomic>
+#include <iostream>
+#include <list>
+#include <string>
+#include <thread>
+
+/*
+ * A local job server on a Unix domain socket. Every request and every response is one JSON line:
+ *   {"cmd": "submit", "input": FILE_OR_DIR, "priority": 0, "solver": "clp_simplex", "rotational": true,
+ *    "contact_eps": 1e-3, "boundary": [STEMS]}                      -> {"id": ID, "status": "queued"}
+ *   {"cmd": "submit", "parts": [{"V": [[x, y, z]...], "F": [[v0, v1, v2...]...], "boundary": false}...], ...}
+ *   {"cmd": "status", "id": ID}                                     -> {"id": ID, "status": STATUS}
+ *   {"cmd": "result", "id": ID, "wait": true}                       -> {"id": ID, "status": STATUS, "result": {...}}
+ *   {"cmd": "cancel", "id": ID}                                     -> {"id": ID, "cancelled": true}
+ *   {"cmd": "release", "id": ID}                                    -> {"id": ID, "released": true}
+ *   {"cmd": "shutdown"}
+ * A failed request is answered with {"error": MESSAGE}.
+ */
+
+int listenSocket = -1;
+
+// the socket is closed by main once the thread is joined, so that a shutdown never hits a reused descriptor
+struct Connection{
+    int socket;
+    std::thread thread;
+    std::atomic<bool> finished;
+};
+
+void printUsage()
+{
+    std::cerr << "Usage: TopoServer [options]\n"
+              << "  -s, --socket PATH     the Unix domain socket (default: /tmp/topolite.sock)\n"
+              << "  -w, --workers N       number of jobs running at the same time (default: 2)\n"
+              << "  -j, --threads N       threads shared by all the jobs (default: all the cores)\n"
+              << "  -c, --cache N         number of projects whose parts are kept (default: 16)\n";
+}
+
+// std::stoi without the exceptions, the whole text must be a number
+bool parseInt(const std::string &text, int &value)
+{
+    try{
+        size_t end;
+        value = std::stoi(text, &end);
+        return end == text.size();
+    }
+    catch(const std::logic_error &){     // std::invalid_argument and std::out_of_range
+        return false;
+    }
+}
+
+int solverType(const std::string &name)
+{
+    if(name == "clp_barrier") return TopoPipeline<double>::CLP_BARRIER;
+    if(name == "pdhg") return TopoPipeline<double>::PDHG;
+    if(name == "clp_simplex") return TopoPipeline<double>::CLP_SIMPLEX;
+    throw std::invalid_argument("unknown solver: " + name);
+}
+
+// the parts are given in the unit box, as the .obj part sets once scaled
+void readParts(const nlohmann::json &parts_json, PipelineJob &job)
+{
+    shared_ptr<InputVarList> varList = make_shared<InputVarList>();
+    InitVar(varList.get());
+    for(const nlohmann::json &part_json: parts_json)
+    {
+        vector<vector<double>> V = part_json.at("V").get<vector<vector<double>>>();
+        vector<vector<int>> F = part_json.at("F").get<vector<vector<int>>>();
+        for(const vector<double> &v: V){
+            if(v.size() != 3) throw std::invalid_argument("a vertex should have 3 coordinates");
+        }
+        for(const vector<int> &f: F){
+            for(int vid: f) if(vid < 0 || vid >= V.size()) throw std::out_of_range("a face refers to a missing vertex");
+        }
+
+        shared_ptr<PolyMesh<double>> mesh = make_shared<PolyMesh<double>>(varList);
+        mesh->readOBJModel(V, vector<vector<double>>(), F, vector<vector<int>>(F.size()), false);
+        job.parts.push_back(mesh);
+        job.partAtBoundary.push_back(part_json.value("boundary", false));
+    }
+}
+
+nlohmann::json handleRequest(const nlohmann::json &request, PipelineQueue &queue)
+{
+    std::string cmd = request.at("cmd").get<std::string>();
+    nlohmann::json response;
+
+    if(cmd == "submit")
+    {
+        PipelineJob job;
+        job.input = request.value("input", std::string());
+        if(request.contains("parts")) readParts(request["parts"], job);
+        job.solverType = solverType(request.value("solver", std::string("clp_simplex")));
+        job.rotational = request.value("rotational", true);
+        job.contactEps = request.value("contact_eps", 1e-3f);
+        job.boundaryParts = request.value("boundary", vector<std::string>());
+
+        int jobID = queue.submit(job, request.value("priority", 0));
+        response["id"] = jobID;
+        response["status"] = PipelineQueue::statusName(queue.status(jobID));
+    }
+    else if(cmd == "status")
+    {
+        int jobID = request.at("id").get<int>();
+        response["id"] = jobID;
+        response["status"] = PipelineQueue::statusName(queue.status(jobID));
+    }
+    else if(cmd == "result")
+    {
+        int jobID = request.at("id").get<int>();
+        PipelineResult result;
+        bool finished = queue.result(jobID, result, request.value("wait", true));
+        response["id"] = jobID;
+        response["status"] = PipelineQueue::statusName(queue.status(jobID));
+        if(finished) response["result"] = result.to_json();
+    }
+    else if(cmd == "cancel")
+    {
+        int jobID = request.at("id").get<int>();
+        response["id"] = jobID;
+        response["cancelled"] = queue.cancel(jobID);
+    }
+    else if(cmd == "release")
+    {
+        int jobID = request.at("id").get<int>();
+        response["id"] = jobID;
+        response["released"] = queue.release(jobID);
+    }
+    else if(cmd == "shutdown")
+    {
+        response["shutdown"] = true;
+        shutdown(listenSocket, SHUT_RDWR);
+    }
+    else{
+        response["error"] = "unknown command: " + cmd;
+    }
+    return response;
+}
+
+void serveConnection(Connection &connection, PipelineQueue &queue)
+{
+    std::string buffer;
+    char chunk[4096];
+    ssize_t size;
+    while((size = read(connection.socket, chunk, sizeof(chunk))) > 0)
+    {
+        buffer.append(chunk, size);
+        size_t end;
+        while((end = buffer.find('\n')) != std::string::npos)
+        {
+            std::string line = buffer.substr(0, end);
+            buffer.erase(0, end + 1);
+            if(line.empty()) continue;
+
+            nlohmann::json response;
+            try{
+                response = handleRequest(nlohmann::json::parse(line), queue);
+            }
+            catch (const std::exception &e){
+                response["error"] = e.what();
+            }
+
+            // a client gone before its answer fails the send instead of raising SIGPIPE
+            std::string text = response.dump() + "\n";
+            for(size_t sent = 0; sent < text.size();){
+                ssize_t written = send(connection.socket, text.data() + sent, text.size() - sent, MSG_NOSIGNAL);
+                if(written <= 0) break;
+                sent += written;
+            }
+        }
+    }
+    connection.finished = true;
+}
+
+int main(int argc, char **argv)
+{
+    std::string socketPath = "/tmp/topolite.sock";
+    int num_workers = 2;
+    int num_threads = tbb::this_task_arena::max_concurrency();
+    int cache_capacity = 16;
+
+    for(int id = 1; id < argc; id++)
+    {
+        std::string arg = argv[id];
+        bool hasValue = id + 1 < argc;
+        if((arg == "-s" || arg == "--socket") && hasValue) socketPath = argv[++id];
+        else if((arg == "-w" || arg == "--workers") && hasValue && parseInt(argv[++id], num_workers)) num_workers = std::max(1, num_workers);
+        else if((arg == "-j" || arg == "--threads") && hasValue && parseInt(argv[++id], num_threads)) num_threads = std::max(1, num_threads);
+        else if((arg == "-c" || arg == "--cache") && hasValue && parseInt(argv[++id], cache_capacity)) cache_capacity = std::max(0, cache_capacity);
+        else{
+            printUsage();
+            return arg == "-h" || arg == "--help" ? 0 : 2;
+        }
+    }
+
+    signal(SIGPIPE, SIG_IGN);
+
+    sockaddr_un address = {};
+    address.sun_family = AF_UNIX;
+    if(socketPath.size() >= sizeof(address.sun_path)){
+        std::cerr << "the socket path is too long" << std::endl;
+        return 2;
+    }
+    std::copy(socketPath.begin(), socketPath.end(), address.sun_path);
+
+    listenSocket = socket(AF_UNIX, SOCK_STREAM, 0);
+    unlink(socketPath.c_str());
+    if(listenSocket < 0
+       || bind(listenSocket, (sockaddr *)&address, sizeof(address)) < 0
+       || listen(listenSocket, 16) < 0){
+        std::cerr << "cannot listen on " << socketPath << std::endl;
+        return 1;
+    }
+    std::cerr << "TopoServer:\tlistening on " << socketPath << ",\t" << num_workers << " workers,\t" << num_threads << " threads" << std::endl;
+
+    PipelineQueue queue(num_workers, num_threads, cache_capacity);
+
+    // a connection may wait for a result as long as it needs, so each one has its own thread
+    std::list<Connection> connections;
+    int client;
+    while((client = accept(listenSocket, nullptr, nullptr)) >= 0)
+    {
+        for(auto it = connections.begin(); it != connections.end();){
+            if(!it->finished) { ++it; continue; }
+            it->thread.join();
+            close(it->socket);
+            it = connections.erase(it);
+        }
+
+        connections.emplace_back();
+        Connection &connection = connections.back();
+        connection.socket = client;
+        connection.finished = false;
+        connection.thread = std::thread(serveConnection, std::ref(connection), std::ref(queue));
+    }
+
+    // wake the waiting results and the blocked reads, the queue outlives every connection thread
+    queue.stop();
+    for(Connection &connection: connections) shutdown(connection.socket, SHUT_RDWR);
+    for(Connection &connection: connections){
+        connection.thread.join();
+        close(connection.socket);
+    }
+    close(listenSocket);
+    unlink(socketPath.c_str());
+    return 0;
+}
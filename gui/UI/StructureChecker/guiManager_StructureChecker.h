@@ -6,9 +6,11 @@
 #define TOPOLITE_GUIMANAGER_STRUCTURECHECKER_H
 
 
+#include "IO/OBJReader.h"
 #include "Interlocking/ContactGraph.h"
 #include "Interlocking/InterlockingSolver.h"
 #include "Interlocking/InterlockingSolver_Clp.h"
+#include "Interlocking/InterlockingSolver_PDHG.h"
 #if defined(IPOPT_INSTALLED)
     #include "Interlocking/InterlockingSolver_Ipopt.h"
 #endif
@@ -37,8 +39,9 @@ private:
         CLP_SIMPLEX = 0,
         CLP_BARRIER = 1,
 #if defined(IPOPT_INSTALLED)
-        IPOPT = 2
+        IPOPT = 2,
 #endif
+        PDHG = 3
     };
 
 
@@ -72,6 +75,9 @@ public:
                     return nullptr;
             }
         }
+        else if(type == PDHG){
+            return make_shared<InterlockingSolver_PDHG<double>>(graph, varList);
+        }
         else{
         #if defined(IPOPT_INSTALLED)
             return make_shared<InterlockingSolver_Ipopt<double>>(graph, varList);
@@ -223,10 +229,11 @@ public:
 
     void load_meshList(std::vector<std::string> OBJFileList, bool atBoundary)
     {
-        for(std::string name: OBJFileList)
+        vector<shared_ptr<PolyMesh<double>>> meshes;
+        OBJReader::readMeshes(OBJFileList, varList, meshes, false);
+        for(shared_ptr<PolyMesh<double>> polyMesh: meshes)
         {
-            shared_ptr<PolyMesh<double>> polyMesh = make_shared<PolyMesh<double>>(varList);
-            polyMesh->readOBJModel(name.c_str(), false);
+            if(polyMesh == nullptr) continue;
             meshLists.push_back(polyMesh);
             atboundary.push_back(atBoundary);
         }
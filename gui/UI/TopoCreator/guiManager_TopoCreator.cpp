@@ -14,6 +14,9 @@ bool guiManager_TopoCreator::load_from_xmlfile(string xmlFileName)
     clear();
     iodata = make_shared<IOData>();
     if(IO.XMLReader(xmlFileName, *iodata) && iodata->varList) {
+        for(auto &[filename, time]: IO.loadTimes){
+            std::cout << "Load:\t" << filename << ",\t" << time << "s" << std::endl;
+        }
         iodata->varList->add((int)1, "layerOfBoundary",  "");
         iodata->varList->add((float)0.002, "wireframe_linewidth",  "");
         iodata->varList->add((float)0.003, "augmentedvectors_linewidth",  "");
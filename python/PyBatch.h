@@ -0,0 +1,175 @@
+#ifndef TOPOLITE_PYBATCH_H
+#define TOPOLITE_PYBATCH_H
+
+#include "PyPolyMesh.h"
+#include "PyContactGraph.h"
+#include "PyInterlockChecker.h"
+#include "PyNumpy.h"
+
+#include <tbb/tbb.h>
+#include <pybind11/numpy.h>
+#include <pybind11/pybind11.h>
+
+namespace py = pybind11;
+using namespace pybind11::literals; // to bring in the `_a` literal
+
+/**
+ * @brief one row of the result table of checkInterlockingBatch, registered as a numpy structured dtype.
+ */
+struct PyBatchResult{
+    int status;             // 1: interlocking, 0: not interlocking, -1: failed (no parts or an invalid mesh)
+    int num_parts;
+    int num_contacts;
+    double objective;       // total separation speed of the returned motion over the contacts, zero when interlocking
+    double contact_time;    // seconds spent building the contact graph
+    double solve_time;      // seconds spent in the interlocking solver
+};
+
+/**
+ * @brief Check many assemblies in one call: the arrays are read once under the GIL,
+ *        then the meshes, contact graphs and interlocking checks of all the assemblies run concurrently in tbb without it.
+ */
+class PyBatchCheck{
+public:
+    typedef shared_ptr<PolyMesh<double>> pPolyMesh;
+    typedef shared_ptr<ContactGraph<double>> pContactGraph;
+    typedef shared_ptr<InterlockingSolver<double>> pInterlockingSolver;
+    typedef shared_ptr<InterlockingSolver<double>::InterlockingData> pInterlockingData;
+    typedef py::array_t<double, py::array::c_style | py::array::forcecast> ArrayXd;
+    typedef py::array_t<int, py::array::c_style | py::array::forcecast> ArrayXi;
+
+    // a part viewing the buffers of its numpy arrays, which are kept alive by the arrays themselves
+    struct PartArrays{
+        ArrayXd V;
+        ArrayXi F, offsets;
+        bool atBoundary;
+    };
+
+public:
+
+    /**
+     * @param assemblies a list of assemblies, each a list of parts (V, F, offsets, atBoundary) as in PyPolyMesh
+     * @return a numpy structured array with one PyBatchResult per assembly
+     */
+    static py::array_t<PyBatchResult> check(const py::list &assemblies,
+                                            const PyParamList &varList,
+                                            float contact_eps,
+                                            bool convexhull,
+                                            PyInterlockCheck::OptSolverType solver_type,
+                                            PyInterlockCheck::InterlockType interlock_type)
+    {
+        vector<vector<PartArrays>> inputs;
+        for(py::handle assembly: assemblies)
+        {
+            inputs.push_back(vector<PartArrays>());
+            if(!py::isinstance<py::iterable>(assembly)) throw py::type_error("an assembly should be a list of parts");
+            for(py::handle part: py::reinterpret_borrow<py::iterable>(assembly))
+            {
+                if(!py::isinstance<py::sequence>(part)) throw py::type_error("a part should be (V, F, offsets, atBoundary)");
+                py::sequence arrays = py::reinterpret_borrow<py::sequence>(part);
+                if(arrays.size() != 4) throw std::invalid_argument("a part should be (V, F, offsets, atBoundary)");
+                PartArrays input{ArrayXd::ensure(arrays[0]), ArrayXi::ensure(arrays[1]), ArrayXi::ensure(arrays[2]), arrays[3].cast<bool>()};
+                if(!input.V || !input.F || !input.offsets) throw std::invalid_argument("V, F and offsets should be arrays");
+                if(input.V.ndim() != 2 || input.V.shape(1) != 3) throw std::invalid_argument("V should have the shape (n, 3)");
+                if(input.F.ndim() != 1 || input.offsets.ndim() != 1 || input.offsets.shape(0) < 1) throw std::invalid_argument("F and offsets should be flat arrays");
+                inputs.back().push_back(input);
+            }
+        }
+
+        vector<PyBatchResult> results(inputs.size());
+        {
+            py::gil_scoped_release release;
+            tbb::parallel_for(tbb::blocked_range<size_t>(0, inputs.size(), 1), [&](const tbb::blocked_range<size_t>& r)
+            {
+                for(size_t id = r.begin(); id != r.end(); ++id){
+                    results[id] = checkAssembly(inputs[id], varList.data_, contact_eps, convexhull, solver_type, interlock_type);
+                }
+            });
+        }
+
+        // the arrays of the inputs must be released while the GIL is held
+        inputs.clear();
+        return toNumpy(std::move(results));
+    }
+
+    static PyBatchResult checkAssembly(const vector<PartArrays> &parts,
+                                       shared_ptr<InputVarList> varList,
+                                       float contact_eps,
+                                       bool convexhull,
+                                       PyInterlockCheck::OptSolverType solver_type,
+                                       PyInterlockCheck::InterlockType interlock_type)
+    {
+        PyBatchResult result{-1, (int)parts.size(), 0, 0, 0, 0};
+        try{
+            tbb::tick_count sta = tbb::tick_count::now();
+
+            vector<pPolyMesh> meshes;
+            vector<bool> atBoundary;
+            for(const PartArrays &part: parts){
+                meshes.push_back(PyPolyMesh::buildMesh(part.V.data(), part.V.shape(0),
+                                                       part.F.data(), part.F.shape(0),
+                                                       part.offsets.data(), part.offsets.shape(0) - 1, varList));
+                atBoundary.push_back(part.atBoundary);
+            }
+            if(meshes.empty()) return result;
+
+            pContactGraph graph = make_shared<ContactGraph<double>>(varList);
+            graph->buildFromMeshes(meshes, atBoundary, contact_eps, convexhull);
+            graph->finalize();
+            result.num_contacts = graph->edges.size();
+            result.contact_time = (tbb::tick_count::now() - sta).seconds();
+
+            sta = tbb::tick_count::now();
+            pInterlockingSolver solver = PyInterlockCheck::createSolver(graph, solver_type);
+            silence(solver);
+
+            pInterlockingData data;
+            bool rotational = (interlock_type == PyInterlockCheck::Rotational);
+            bool is_interlocking = rotational ? solver->isRotationalInterlocking(data) : solver->isTranslationalInterlocking(data);
+            result.solve_time = (tbb::tick_count::now() - sta).seconds();
+
+            result.status = is_interlocking ? 1 : 0;
+            if(!is_interlocking && data) result.objective = computeObjective(solver, data, rotational);
+        }
+        catch (const std::exception &){
+            result.status = -1;
+        }
+        return result;
+    }
+
+    /**
+     * @brief the objective of the interlocking LP at the returned motion: the sum of the contact rows of A x.
+     */
+    static double computeObjective(pInterlockingSolver solver, pInterlockingData data, bool rotational)
+    {
+        vector<InterlockingSolver<double>::EigenTriple> tris;
+        Eigen::Vector2i size;
+        if(rotational) solver->computeRotationalInterlockingMatrix(tris, size);
+        else solver->computeTranslationalInterlockingMatrix(tris, size);
+
+        // pack the motion by dynamicID, the rotation is stored negated by unpackSolution
+        int dimension = rotational ? 6 : 3;
+        Eigen::VectorXd x = Eigen::VectorXd::Zero(size[1]);
+        for(size_t id = 0; id < solver->graph->nodes.size(); id++)
+        {
+            int dynamicID = solver->graph->nodes[id]->dynamicID;
+            if(dynamicID == -1) continue;
+            x.segment(dimension * dynamicID, 3) = data->traslation[id];
+            if(rotational) x.segment(dimension * dynamicID + 3, 3) = -data->rotation[id];
+        }
+
+        double objective = 0;
+        for(const auto &tri: tris) objective += tri.value() * x[tri.col()];
+        return objective;
+    }
+
+private:
+
+    // the assemblies are solved concurrently, their logs would interleave
+    static void silence(pInterlockingSolver solver)
+    {
+        solver->verbose = false;
+    }
+};
+
+#endif //TOPOLITE_PYBATCH_H
@@ -9,6 +9,7 @@
 
 #include "PyParamList.h"
 #include "PyPolyMesh.h"
+#include "PyNumpy.h"
 
 #include "igl/writeOBJ.h"
 #include "IO/InputVar.h"
@@ -46,6 +47,8 @@ public:
             atBoundary.push_back(pyPolymeshes[id].atBoundary_);
         }
 
+        // the contacts are computed in parallel by tbb, python threads may run meanwhile
+        py::gil_scoped_release release;
         graph->buildFromMeshes(meshes, atBoundary, contact_eps, convexhull);
         graph->finalize();
     }
@@ -63,6 +66,45 @@ public:
         return pyPolyMesh;
     }
 
+    /**
+     * @brief the contacts as arrays, the edge k of the graph joins parts[k] with normals[k]:
+     *        "vertices" (n, 3), "faces" and "offsets" (the contact polygon j is faces[offsets[j] : offsets[j + 1]]),
+     *        "polygon_contacts" (the edge of each polygon), "parts" (m, 2) and "normals" (m, 3).
+     */
+    py::dict getContactArrays()
+    {
+        vector<double> positions, normals;
+        vector<int> faces, offsets(1, 0), polygon_contacts, parts;
+        if(graph)
+        {
+            py::gil_scoped_release release;
+            for(size_t id = 0; id < graph->edges.size(); id++)
+            {
+                shared_ptr<ContactGraphEdge<double>> edge = graph->edges[id];
+                parts.push_back(edge->partIDA);
+                parts.push_back(edge->partIDB);
+                normals.insert(normals.end(), edge->normal.data(), edge->normal.data() + 3);
+                for(shared_ptr<_Polygon<double>> poly: edge->polygons)
+                {
+                    for(size_t jd = 0; jd < poly->vers.size(); jd++){
+                        faces.push_back(positions.size() / 3);
+                        positions.insert(positions.end(), poly->vers[jd]->pos.data(), poly->vers[jd]->pos.data() + 3);
+                    }
+                    offsets.push_back(faces.size());
+                    polygon_contacts.push_back(id);
+                }
+            }
+        }
+
+        ssize_t num_vertices = positions.size() / 3, num_edges = parts.size() / 2;
+        return py::dict("vertices"_a = toNumpy(std::move(positions), {num_vertices, 3}),
+                        "faces"_a = toNumpy(std::move(faces)),
+                        "offsets"_a = toNumpy(std::move(offsets)),
+                        "polygon_contacts"_a = toNumpy(std::move(polygon_contacts)),
+                        "parts"_a = toNumpy(std::move(parts), {num_edges, 2}),
+                        "normals"_a = toNumpy(std::move(normals), {num_edges, 3}));
+    }
+
     bool mergeParts(int partI, int partJ){
         if(partI >= 0 && partI < graph->nodes.size() && partJ >= 0 && partJ < graph->nodes.size()){
             pContactGraphNode nodeI, nodeJ;
@@ -8,7 +8,8 @@
 #include "PyContactGraph.h"
 #include "Interlocking/InterlockingSolver.h"
 #include "Interlocking/InterlockingSolver_Clp.h"
-#include "Interlocking/InterlockingSolver_AffineScaling.h"
+#include "Interlocking/InterlockingSolver_PDHG.h"
+#include "PyNumpy.h"
 #include <pybind11/eigen.h>
 #include <pybind11/pybind11.h>
 #include <pybind11/stl.h>
@@ -20,7 +21,7 @@ public:
     enum OptSolverType{
         CLP_SIMPLEX = 0,
         CLP_BARRIER = 1,
-        AFFINE_SCALING = 2,
+        PDHG = 3,
     };
 
     enum InterlockType{
@@ -33,36 +34,62 @@ public:
 public:
 
     PyInterlockCheck(const PyContactGraph &pygraph, OptSolverType solver_type)
+    {
+        solver = createSolver(pygraph.graph, solver_type);
+    }
+
+    static shared_ptr<InterlockingSolver<double>> createSolver(shared_ptr<ContactGraph<double>> graph, OptSolverType solver_type)
     {
         switch (solver_type){
             case CLP_SIMPLEX:
-                solver = make_shared<InterlockingSolver_Clp<double>>(pygraph.graph, pygraph.graph->getVarList(), SIMPLEX);
-                break;
+                return make_shared<InterlockingSolver_Clp<double>>(graph, graph->getVarList(), SIMPLEX);
             case CLP_BARRIER:
-                solver = make_shared<InterlockingSolver_Clp<double>>(pygraph.graph, pygraph.graph->getVarList(), BARRIER);
-                break;
-            case AFFINE_SCALING:
-                solver = make_shared<InterlockingSolver_AffineScaling<double>>(pygraph.graph, pygraph.graph->getVarList());
-                break;
+                return make_shared<InterlockingSolver_Clp<double>>(graph, graph->getVarList(), BARRIER);
+            case PDHG:
+                return make_shared<InterlockingSolver_PDHG<double>>(graph, graph->getVarList());
             default:
-                solver = make_shared<InterlockingSolver<double>>(pygraph.graph, pygraph.graph->getVarList());
-                break;
+                return make_shared<InterlockingSolver<double>>(graph, graph->getVarList());
         }
     }
 
 public:
 
-    Eigen::MatrixXd getInterlockingMat(bool Rotation = true)
+    /**
+     * @brief the interlocking matrix as a scipy.sparse.csr_matrix, its buffers are shared with numpy.
+     */
+    py::object getInterlockingMat(bool Rotation = true)
     {
-        Eigen::MatrixXd mat;
+        PyCSRMatrix mat;
         if(solver)
         {
+            py::gil_scoped_release release;
+            vector<InterlockingSolver<double>::EigenTriple> tris;
+            Eigen::Vector2i size;
             if(Rotation)
-                solver->computeRotationalInterlockingMatrixDense(mat);
+                solver->computeRotationalInterlockingMatrix(tris, size);
             else
-                solver->computeTranslationalInterlockingMatrixDense(mat);
+                solver->computeTranslationalInterlockingMatrix(tris, size);
+            mat.resize(size[0], size[1]);
+            mat.setFromTriplets(tris.begin(), tris.end());
+        }
+        return toScipyCSR(std::move(mat));
+    }
+
+    /**
+     * @brief the equilibrium matrix as a scipy.sparse.csr_matrix.
+     *        the solver assembles it densely, it is sparsified once here.
+     */
+    py::object getEquilibriumMat(bool withFriction = false)
+    {
+        PyCSRMatrix mat;
+        if(solver)
+        {
+            py::gil_scoped_release release;
+            Eigen::MatrixXd dense;
+            solver->computeEquilibriumMatrix(dense, withFriction);
+            mat = dense.sparseView();
         }
-        return mat;
+        return toScipyCSR(std::move(mat));
     }
 
     py::object checkInterlocking(InterlockType interlock_type){
@@ -71,47 +98,45 @@ public:
         {
             shared_ptr<InterlockingSolver<double>::InterlockingData> data;
             bool is_interlocking = false;
-            if(interlock_type == Rotational)
-                is_interlocking = solver->isRotationalInterlocking(data);
-            else
-                is_interlocking = solver->isTranslationalInterlocking(data);
-
-            py::list py_trans, py_rot,py_center;
+            {
+                py::gil_scoped_release release;
+                if(interlock_type == Rotational)
+                    is_interlocking = solver->isRotationalInterlocking(data);
+                else
+                    is_interlocking = solver->isTranslationalInterlocking(data);
+            }
 
             if(is_interlocking)
             {
                 result = py::dict("is_interlocking"_a = true);
             }
+            else if(interlock_type == Rotational){
+                result = py::dict("is_interlocking"_a = false,
+                                  "translation"_a = toNumpyVectors(data->traslation),
+                                  "rotation"_a = toNumpyVectors(data->rotation),
+                                  "rotation_center"_a = toNumpyVectors(data->center));
+            }
             else{
-
-                for(int id = 0;id < data->traslation.size(); id++){
-                    py::list vec;
-                    vec.append(data->traslation[id].x());vec.append(data->traslation[id].y());vec.append(data->traslation[id].z());
-                    py_trans.append(vec);
-                }
-
-                if(interlock_type == Rotational)
-                {
-                    for(int id = 0;id < data->rotation.size(); id++){
-                        py::list vec;
-                        vec.append(data->rotation[id].x());vec.append(data->rotation[id].y());vec.append(data->rotation[id].z());
-                        py_rot.append(vec);
-                    }
-
-                    for(int id = 0;id < data->center.size(); id++){
-                        py::list vec;
-                        vec.append(data->center[id].x());vec.append(data->center[id].y());vec.append(data->center[id].z());
-                        py_center.append(vec);
-                    }
-                    result = py::dict("is_interlocking"_a = false, "translation"_a = py_trans, "rotation"_a = py_rot, "rotation_center"_a = py_center);
-                }
-                else{
-                    result = py::dict("is_interlocking"_a = false, "translation"_a = py_trans);
-                }
+                result = py::dict("is_interlocking"_a = false, "translation"_a = toNumpyVectors(data->traslation));
             }
         }
         return result;
     }
+
+private:
+
+    // a (n, 3) array of the vectors
+    template<typename Vectors>
+    static py::array_t<double> toNumpyVectors(const Vectors &vecs)
+    {
+        vector<double> buffer(vecs.size() * 3);
+        for(size_t id = 0; id < vecs.size(); id++){
+            buffer[3 * id] = vecs[id].x();
+            buffer[3 * id + 1] = vecs[id].y();
+            buffer[3 * id + 2] = vecs[id].z();
+        }
+        return toNumpy(std::move(buffer), {(ssize_t)vecs.size(), 3});
+    }
 };
 
 #endif //TOPOLITE_PYINTERLOCKCHECKER_H
@@ -0,0 +1,52 @@
+#ifndef TOPOLITE_PYNUMPY_H
+#define TOPOLITE_PYNUMPY_H
+
+#include <Eigen/Sparse>
+#include <pybind11/pybind11.h>
+#include <pybind11/numpy.h>
+#include <vector>
+#include <memory>
+
+namespace py = pybind11;
+using namespace pybind11::literals; // to bring in the `_a` literal
+
+typedef Eigen::SparseMatrix<double, Eigen::RowMajor, int> PyCSRMatrix;
+
+/**
+ * @brief Hand a std::vector over to NumPy without copying it.
+ *        The vector is moved to the heap and freed by a capsule when the array is garbage collected.
+ * @param shape the shape of the array, C-contiguous; a flat array by default
+ */
+template<typename T>
+py::array_t<T> toNumpy(std::vector<T> &&buffer, std::vector<ssize_t> shape = std::vector<ssize_t>())
+{
+    if(shape.empty()) shape.push_back(buffer.size());
+    std::vector<T> *owner = new std::vector<T>(std::move(buffer));
+    py::capsule free_when_done(owner, [](void *ptr){
+        delete reinterpret_cast<std::vector<T> *>(ptr);
+    });
+    return py::array_t<T>(shape, owner->data(), free_when_done);
+}
+
+/**
+ * @brief Return a row-major Eigen matrix as a scipy.sparse.csr_matrix which views its CSR buffers.
+ */
+inline py::object toScipyCSR(PyCSRMatrix &&mat)
+{
+    PyCSRMatrix *owner = new PyCSRMatrix(std::move(mat));
+    owner->makeCompressed();
+    py::capsule free_when_done(owner, [](void *ptr){
+        delete reinterpret_cast<PyCSRMatrix *>(ptr);
+    });
+
+    py::array_t<double> data(owner->nonZeros(), owner->valuePtr(), free_when_done);
+    py::array_t<int> indices(owner->nonZeros(), owner->innerIndexPtr(), free_when_done);
+    py::array_t<int> indptr(owner->rows() + 1, owner->outerIndexPtr(), free_when_done);
+
+    py::object csr_matrix = py::module::import("scipy.sparse").attr("csr_matrix");
+    return csr_matrix(py::make_tuple(data, indices, indptr),
+                      "shape"_a = py::make_tuple(owner->rows(), owner->cols()),
+                      "copy"_a = false);
+}
+
+#endif //TOPOLITE_PYNUMPY_H
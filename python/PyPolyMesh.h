@@ -9,6 +9,7 @@
 #include "Utility/TopoObject.h"
 
 #include "PyParamList.h"
+#include "PyNumpy.h"
 
 #include <pybind11/eigen.h>
 #include <pybind11/pybind11.h>
@@ -41,6 +42,30 @@ public:
         atBoundary_ = atBoundary;
     }
 
+    /**
+     * @brief build the mesh from arrays in bulk
+     * @param V (n, 3) vertex positions
+     * @param F the vertex indices of all the faces, face k is F[offsets[k] : offsets[k + 1]]
+     */
+    PyPolyMesh(py::array_t<double, py::array::c_style | py::array::forcecast> V,
+               py::array_t<int, py::array::c_style | py::array::forcecast> F,
+               py::array_t<int, py::array::c_style | py::array::forcecast> offsets,
+               bool atBoundary,
+               const PyParamList &varList)
+    {
+        if(V.ndim() != 2 || V.shape(1) != 3) throw std::invalid_argument("V should have the shape (n, 3)");
+        if(F.ndim() != 1 || offsets.ndim() != 1 || offsets.shape(0) < 1) throw std::invalid_argument("F and offsets should be flat arrays");
+
+        const double *v = V.data();
+        const int *f = F.data(), *o = offsets.data();
+        int num_vertices = V.shape(0), num_indices = F.shape(0), num_faces = offsets.shape(0) - 1;
+
+        // the arrays stay alive with the arguments, python is not needed any more
+        py::gil_scoped_release release;
+        mesh_ = buildMesh(v, num_vertices, f, num_indices, o, num_faces, varList.data_);
+        atBoundary_ = atBoundary;
+    }
+
     PyPolyMesh(pPolyMesh polymesh, bool atBoundary){
         mesh_ = make_shared<PolyMesh<double>>(*polymesh);
         atBoundary_ = false;
@@ -54,6 +79,71 @@ public:
         mesh_->mergeFaces();
     }
 
+    // (n, 3) vertex positions, owned by the returned array
+    py::array_t<double> getVertices()
+    {
+        vector<double> positions;
+        if(mesh_ != nullptr)
+        {
+            positions.reserve(mesh_->vertexList.size() * 3);
+            for(pVertex vertex: mesh_->vertexList){
+                positions.insert(positions.end(), vertex->pos.data(), vertex->pos.data() + 3);
+            }
+        }
+        ssize_t num_vertices = positions.size() / 3;
+        return toNumpy(std::move(positions), {num_vertices, 3});
+    }
+
+    // (F, offsets): the vertex indices of all the faces, face k is F[offsets[k] : offsets[k + 1]]
+    py::tuple getFaces()
+    {
+        vector<int> indices, offsets(1, 0);
+        if(mesh_ != nullptr)
+        {
+            for(pPolygon poly: mesh_->polyList){
+                for(pVertex vertex: poly->vers) indices.push_back(vertex->verID);
+                offsets.push_back(indices.size());
+            }
+        }
+        return py::make_tuple(toNumpy(std::move(indices)), toNumpy(std::move(offsets)));
+    }
+
+    /**
+     * @brief build a mesh from raw C-contiguous buffers, it does not touch python and can run without the GIL.
+     * @param V num_vertices x 3 positions
+     * @param F the vertex indices of all the faces, face k is F[offsets[k] : offsets[k + 1]]
+     */
+    static pPolyMesh buildMesh(const double *V, int num_vertices,
+                               const int *F, int num_indices,
+                               const int *offsets, int num_faces,
+                               shared_ptr<InputVarList> varList)
+    {
+        pPolyMesh mesh = make_shared<PolyMesh<double>>(varList);
+
+        vector<pVertex> vertices(num_vertices);
+        for(int id = 0; id < num_vertices; id++){
+            vertices[id] = make_shared<VPoint<double>>(Vector3(V[3 * id], V[3 * id + 1], V[3 * id + 2]));
+            vertices[id]->verID = id;
+        }
+
+        mesh->polyList.reserve(num_faces);
+        for(int id = 0; id < num_faces; id++)
+        {
+            if(offsets[id] < 0 || offsets[id] > offsets[id + 1] || offsets[id + 1] > num_indices) throw std::out_of_range("offsets are not increasing in F");
+            pPolygon poly = make_shared<_Polygon<double>>();
+            for(int kd = offsets[id]; kd < offsets[id + 1]; kd++)
+            {
+                int vid = F[kd];
+                if(vid < 0 || vid >= num_vertices) throw std::out_of_range("F refers to a missing vertex");
+                poly->vers.push_back(vertices[vid]);
+            }
+            mesh->polyList.push_back(poly);
+        }
+
+        mesh->removeDuplicatedVertices();
+        return mesh;
+    }
+
     py::object getCompasMesh()
     {
         if(mesh_ == nullptr) return py::object();
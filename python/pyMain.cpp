@@ -6,10 +6,12 @@
 #include <pybind11/pybind11.h>
 #include <pybind11/stl.h>
 #include <pybind11/eigen.h>
+#include <pybind11/numpy.h>
 #include <string>
 #include "IO/JsonIOReader.h"
 #include "PyContactGraph.h"
 #include "PyInterlockChecker.h"
+#include "PyBatch.h"
 
 
 namespace py = pybind11;
@@ -31,28 +33,45 @@ PYBIND11_MODULE(pyTopo, m)
     py::class_<PyPolyMesh>(m, "PyPolyMesh")
             .def(py::init<const py::object &, bool, const PyParamList &>())
             .def(py::init<PyPolyMesh::pPolyMesh , bool>())
+            .def(py::init<py::array_t<double, py::array::c_style | py::array::forcecast>,
+                          py::array_t<int, py::array::c_style | py::array::forcecast>,
+                          py::array_t<int, py::array::c_style | py::array::forcecast>,
+                          bool, const PyParamList &>(),
+                 "V"_a, "F"_a, "offsets"_a, "atBoundary"_a, "paramList"_a)
             .def("mergeFaces", &PyPolyMesh::mergeFaces)
-            .def("getCompasMesh", &PyPolyMesh::getCompasMesh);
+            .def("getCompasMesh", &PyPolyMesh::getCompasMesh)
+            .def("getVertices", &PyPolyMesh::getVertices)
+            .def("getFaces", &PyPolyMesh::getFaces);
 
     py::class_<PyContactGraph>(m, "PyContactGraph")
             .def(py::init<const vector<PyPolyMesh> &, float, bool>())
             .def("getContacts", &PyContactGraph::getContacts)
+            .def("getContactArrays", &PyContactGraph::getContactArrays)
             .def("numContacts", &PyContactGraph::numContacts)
             .def("mergeParts", &PyContactGraph::mergeParts);
 
     py::class_<PyInterlockCheck> interlockCheck(m, "PyInterlockCheck");
 
     interlockCheck.def(py::init<const PyContactGraph &, PyInterlockCheck::OptSolverType>())
-                    .def("getInterlockingMat", &PyInterlockCheck::getInterlockingMat)
+                    .def("getInterlockingMat", &PyInterlockCheck::getInterlockingMat, "Rotation"_a = true)
+                    .def("getEquilibriumMat", &PyInterlockCheck::getEquilibriumMat, "withFriction"_a = false)
                     .def("checkInterlocking", &PyInterlockCheck::checkInterlocking);
 
     py::enum_<PyInterlockCheck::OptSolverType>(interlockCheck, "OptSolverType")
             .value("CLP_SIMPLEX", PyInterlockCheck::OptSolverType::CLP_SIMPLEX)
             .value("CLP_BARRIER", PyInterlockCheck::OptSolverType::CLP_BARRIER)
+            .value("PDHG", PyInterlockCheck::OptSolverType::PDHG)
             .export_values();
 
     py::enum_<PyInterlockCheck::InterlockType>(interlockCheck, "InterlockType")
             .value("Rotational", PyInterlockCheck::InterlockType::Rotational)
             .value("Translational", PyInterlockCheck::InterlockType::Translational)
             .export_values();
+
+    PYBIND11_NUMPY_DTYPE(PyBatchResult, status, num_parts, num_contacts, objective, contact_time, solve_time);
+
+    m.def("checkInterlockingBatch", &PyBatchCheck::check,
+          "check a list of assemblies, each a list of parts (V, F, offsets, atBoundary), concurrently",
+          "assemblies"_a, "paramList"_a, "contact_eps"_a, "convexhull"_a,
+          "solver"_a = PyInterlockCheck::CLP_SIMPLEX, "interlock_type"_a = PyInterlockCheck::Rotational);
 }
\ No newline at end of file
@@ -11,11 +11,60 @@
 #include "Structure/StrucCreator.h"
 #include "Interlocking/ContactGraph.h"
 #include "Interlocking/InterlockingSolver_AffineScaling.h"
+#include "tbb/tbb.h"
+#include <map>
+#include <mutex>
+
+// the flat buffers of many meshes, mesh k owns the vertices [vertexOffsets[k], vertexOffsets[k + 1])
+// and the faces [faceOffsets[k], faceOffsets[k + 1]), its face indices are local to the mesh.
+struct CMeshBuffers{
+    vector<float> points;
+    vector<int> faces;
+    vector<int> vertexOffsets;
+    vector<int> faceOffsets;
+    vector<int> atBoundary;
+};
 
 /*
  * GLOBAL VARIABLES
  */
 
+// the stages of the pipeline, a dirty stage is recomputed together with all the later ones
+enum RefreshStage{
+    STAGE_TEXTURE = 0,      // the transform of the pattern on the reference surface
+    STAGE_CROSSMESH = 1,    // the reference surface, the pattern and the cross mesh parameters
+    STAGE_AUGMENTED = 2,    // the tilt angles of the augmented vectors
+    STAGE_BLOCKS = 3,       // the part geometry
+    STAGE_NONE = 4,
+};
+
+struct RefreshState{
+    int dirtyStage = STAGE_TEXTURE;     // the earliest stage which changed since the last refresh
+    bool hasBlocks = false;             // the last update was a refresh, not a preview
+    int version = 0;                    // incremented by every update which recomputed something
+    vector<size_t> partHashes;          // the geometry of the parts at the last update
+    vector<int> partVersions;           // the version in which each part last changed
+};
+
+// the plugin may update several structures from different threads
+std::map<XMLData*, RefreshState> refreshStates;
+std::mutex refreshStatesMutex;
+
+void markDirty(XMLData* data, int stage)
+{
+    std::lock_guard<std::mutex> lock(refreshStatesMutex);
+    RefreshState &state = refreshStates[data];
+    state.dirtyStage = std::min(state.dirtyStage, stage);
+}
+
+int parameterStage(const std::string &name)
+{
+    if(name.compare(0, 4, "show") == 0) return STAGE_NONE;
+    if(name == "tiltAngle" || name == "tilt_face_angle_min") return STAGE_AUGMENTED;
+    if(name == "cutUpper" || name == "cutLower" || name == "only_cut_bdry") return STAGE_BLOCKS;
+    return STAGE_CROSSMESH;
+}
+
 void getInteractMatrix(XMLData* data, double *interactMat)
 {
     LoadIdentityMatrix(interactMat);
@@ -86,27 +135,34 @@ ContactGraphData* initContactGraph(){
     return graphData;
 }
 
+bool convertPartMesh(int partID, XMLData *data, PolyMeshRhino *mesh)
+{
+    shared_ptr<Part> part = data->strucCreator->struc->partList[partID];
+    if(part && part->polyMesh)
+    {
+        pPolyMesh polyMesh = make_shared<PolyMesh>(*part->polyMesh);
+
+        if(data->varList->get<bool>("texturedModel") == false)
+        {
+            polyMesh->ScaleMesh(1.0 / data->normalizedData.scale);
+            polyMesh->TranslateMesh(-data->normalizedData.trans);
+        }
+
+        MeshConverter converter(data->varList);
+        converter.Convert2EigenMesh(polyMesh.get(), mesh);
+        return true;
+    }
+    return false;
+}
+
 PolyMeshRhino *initPartMeshPtr(int partID, XMLData *data){
     PolyMeshRhino *mesh = NULL;
     if(data && data->strucCreator && data->strucCreator->struc){
         if(0 <= partID && partID < data->strucCreator->struc->partList.size())
         {
-            shared_ptr<Part> part = data->strucCreator->struc->partList[partID];
-            if(part && part->polyMesh)
-            {
-                pPolyMesh polyMesh = make_shared<PolyMesh>(*part->polyMesh);
-
-                if(data->varList->get<bool>("texturedModel") == false)
-                {
-                    polyMesh->ScaleMesh(1.0 / data->normalizedData.scale);
-                    polyMesh->TranslateMesh(-data->normalizedData.trans);
-                }
-
-                MeshConverter converter(data->varList);
-                mesh = new PolyMeshRhino();
-                converter.Convert2EigenMesh(polyMesh.get(), mesh);
-                return mesh;
-            }
+            mesh = new PolyMeshRhino();
+            if(convertPartMesh(partID, data, mesh)) return mesh;
+            delete mesh;
         }
     }
     return NULL;
@@ -234,6 +290,10 @@ int testInterlocking(ContactGraphData *data){
 
 int deleteStructure(XMLData* data){
     if(data){
+        {
+            std::lock_guard<std::mutex> lock(refreshStatesMutex);
+            refreshStates.erase(data);
+        }
         delete data;
         return 1;
     }
@@ -273,26 +333,97 @@ int deletePolyLineRhino(PolyLineRhino *lines){
 }
 
 //Create Geometry
-void refresh(XMLData* data)
+size_t hashPartMesh(shared_ptr<Part> part)
 {
-    if (data && data->strucCreator && data->strucCreator->crossMeshCreator) {
-        double tmpMat[16];
-        getInteractMatrix(data, tmpMat);
-        data->strucCreator->CreateStructure(true, tmpMat, false);
+    size_t seed = 0;
+    if(part && part->polyMesh)
+    {
+        std::hash<float> hasher;
+        for(shared_ptr<_Polygon> poly: part->polyMesh->polyList)
+        {
+            seed ^= poly->vers.size() + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+            for(size_t id = 0; id < poly->vers.size(); id++){
+                for(int kd = 0; kd < 3; kd++){
+                    seed ^= hasher(poly->vers[id]->pos[kd]) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+                }
+            }
+        }
     }
-    return;
+    return seed;
 }
 
-void preview(XMLData* data)
+void computePartHashes(XMLData* data, vector<size_t> &hashes)
+{
+    vector<shared_ptr<Part>> parts;
+    if(data->strucCreator->struc) parts = data->strucCreator->struc->partList;
+
+    hashes.resize(parts.size());
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, parts.size()), [&](const tbb::blocked_range<size_t>& r)
+    {
+        for(size_t id = r.begin(); id != r.end(); ++id){
+            hashes[id] = hashPartMesh(parts[id]);
+        }
+    });
+}
+
+//compare the parts with the last update, the modified ones get the new version
+void updatePartVersions(RefreshState &state, const vector<size_t> &hashes)
+{
+    state.version++;
+
+    size_t n_previous = state.partHashes.size();
+    state.partVersions.resize(hashes.size(), state.version);
+    for(size_t id = 0; id < hashes.size() && id < n_previous; id++){
+        if(hashes[id] != state.partHashes[id]) state.partVersions[id] = state.version;
+    }
+    state.partHashes = hashes;
+}
+
+//recompute the stages changed since the last update, nothing if the structure is up to date
+void updateStructure(XMLData* data, bool previewMode)
 {
     if (data && data->strucCreator && data->strucCreator->crossMeshCreator) {
+        // the state is only locked to be read and written, not during the update:
+        // a setter called meanwhile marks the structure dirty again for the next update.
+        int dirtyStage;
+        {
+            std::lock_guard<std::mutex> lock(refreshStatesMutex);
+            RefreshState &state = refreshStates[data];
+            bool needBlocks = !previewMode && !state.hasBlocks;
+            if(state.dirtyStage == STAGE_NONE && !needBlocks) return;
+            dirtyStage = state.dirtyStage;
+            state.dirtyStage = STAGE_NONE;
+        }
+
+        // the cross mesh is kept unless the texture transform or its inputs changed,
+        // CreateStructure then only updates the augmented vectors and the blocks.
         double tmpMat[16];
         getInteractMatrix(data, tmpMat);
-        data->strucCreator->CreateStructure(true, tmpMat, true);
+        bool createCrossMesh = dirtyStage <= STAGE_CROSSMESH;
+        data->strucCreator->CreateStructure(createCrossMesh, tmpMat, previewMode);
+
+        vector<size_t> hashes;
+        computePartHashes(data, hashes);
+        {
+            std::lock_guard<std::mutex> lock(refreshStatesMutex);
+            RefreshState &state = refreshStates[data];
+            state.hasBlocks = !previewMode;
+            updatePartVersions(state, hashes);
+        }
     }
     return;
 }
 
+void refresh(XMLData* data)
+{
+    updateStructure(data, false);
+}
+
+void preview(XMLData* data)
+{
+    updateStructure(data, true);
+}
+
 void addMeshesToContactGraph(ContactGraphData *data, CMesh *cmesh, bool brdy)
 {
     if(cmesh == NULL) return;
@@ -471,6 +602,178 @@ void copyFaceGroupI(PolyMeshRhino *mesh, int fgID, int* fg){
     return;
 }
 
+//Bulk Copy
+
+/*
+ * sizes[0]: number of vertices, sizes[1]: number of faces,
+ * sizes[2]: number of vertex groups, sizes[3]: total size of the vertex groups,
+ * sizes[4]: number of face groups, sizes[5]: total size of the face groups.
+ */
+void getPolyMeshSizes(PolyMeshRhino *mesh, int *sizes)
+{
+    if(sizes == NULL) return;
+    for(int id = 0; id < 6; id++) sizes[id] = 0;
+    if(mesh)
+    {
+        sizes[0] = mesh->vertices.size();
+        sizes[1] = mesh->faces.size();
+        sizes[2] = mesh->verticesGroups.size();
+        for(size_t id = 0; id < mesh->verticesGroups.size(); id++) sizes[3] += mesh->verticesGroups[id].size();
+        sizes[4] = mesh->facesGroups.size();
+        for(size_t id = 0; id < mesh->facesGroups.size(); id++) sizes[5] += mesh->facesGroups[id].size();
+    }
+}
+
+/*
+ * points: 3 x sizes[0], faces: 3 x sizes[1],
+ * vgOffsets: sizes[2] + 1, vg: sizes[3], fgOffsets: sizes[4] + 1, fg: sizes[5].
+ * the vertex group k is vg[vgOffsets[k] : vgOffsets[k + 1]], the same for the face groups.
+ */
+int copyPolyMesh(PolyMeshRhino *mesh, float *points, int *faces, int *vgOffsets, int *vg, int *fgOffsets, int *fg)
+{
+    if(mesh == NULL) return 0;
+
+    if(points){
+        for(size_t id = 0; id < mesh->vertices.size(); id++){
+            points[id * 3 + 0] = mesh->vertices[id][0];
+            points[id * 3 + 1] = mesh->vertices[id][1];
+            points[id * 3 + 2] = mesh->vertices[id][2];
+        }
+    }
+
+    if(faces){
+        for(size_t id = 0; id < mesh->faces.size(); id++){
+            faces[id * 3 + 0] = mesh->faces[id][0];
+            faces[id * 3 + 1] = mesh->faces[id][1];
+            faces[id * 3 + 2] = mesh->faces[id][2];
+        }
+    }
+
+    int offset = 0;
+    for(size_t id = 0; id < mesh->verticesGroups.size(); id++){
+        if(vgOffsets) vgOffsets[id] = offset;
+        if(vg) std::copy(mesh->verticesGroups[id].begin(), mesh->verticesGroups[id].end(), vg + offset);
+        offset += mesh->verticesGroups[id].size();
+    }
+    if(vgOffsets) vgOffsets[mesh->verticesGroups.size()] = offset;
+
+    offset = 0;
+    for(size_t id = 0; id < mesh->facesGroups.size(); id++){
+        if(fgOffsets) fgOffsets[id] = offset;
+        if(fg) std::copy(mesh->facesGroups[id].begin(), mesh->facesGroups[id].end(), fg + offset);
+        offset += mesh->facesGroups[id].size();
+    }
+    if(fgOffsets) fgOffsets[mesh->facesGroups.size()] = offset;
+
+    return 1;
+}
+
+//the total number of points of all the polylines
+int getPolyLinesSize(PolyLineRhino *polylines)
+{
+    int size = 0;
+    for(int id = 0; id < getNPolyLines(polylines); id++){
+        size += polylines->data[id].size();
+    }
+    return size;
+}
+
+/*
+ * points: 3 x getPolyLinesSize, offsets: getNPolyLines + 1.
+ * the polyline k is points[3 * offsets[k] : 3 * offsets[k + 1]].
+ */
+int copyPolyLines(PolyLineRhino *polylines, float *points, int *offsets)
+{
+    if(polylines == NULL) return 0;
+
+    int offset = 0;
+    for(size_t id = 0; id < polylines->data.size(); id++)
+    {
+        if(offsets) offsets[id] = offset;
+        if(points) copyPolyLineI(polylines, id, points + 3 * offset);
+        offset += polylines->data[id].size();
+    }
+    if(offsets) offsets[polylines->data.size()] = offset;
+
+    return 1;
+}
+
+//convert all the parts of the structure at once, in parallel
+CMeshBuffers *initStructureMeshes(XMLData *data)
+{
+    if(data == NULL || data->strucCreator == nullptr || data->strucCreator->struc == nullptr) return NULL;
+
+    int n_parts = data->strucCreator->struc->partList.size();
+    vector<PolyMeshRhino> meshes(n_parts);
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, n_parts), [&](const tbb::blocked_range<size_t>& r)
+    {
+        for(size_t id = r.begin(); id != r.end(); ++id){
+            convertPartMesh(id, data, &meshes[id]);
+        }
+    });
+
+    CMeshBuffers *buffers = new CMeshBuffers();
+    buffers->vertexOffsets.push_back(0);
+    buffers->faceOffsets.push_back(0);
+    for(int id = 0; id < n_parts; id++)
+    {
+        buffers->vertexOffsets.push_back(buffers->vertexOffsets.back() + meshes[id].vertices.size());
+        buffers->faceOffsets.push_back(buffers->faceOffsets.back() + meshes[id].faces.size());
+        buffers->atBoundary.push_back(isBoundary(id, data));
+    }
+
+    buffers->points.resize(3 * buffers->vertexOffsets.back());
+    buffers->faces.resize(3 * buffers->faceOffsets.back());
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, n_parts), [&](const tbb::blocked_range<size_t>& r)
+    {
+        for(size_t id = r.begin(); id != r.end(); ++id){
+            copyPolyMesh(&meshes[id],
+                         buffers->points.data() + 3 * buffers->vertexOffsets[id],
+                         buffers->faces.data() + 3 * buffers->faceOffsets[id],
+                         NULL, NULL, NULL, NULL);
+        }
+    });
+
+    return buffers;
+}
+
+//sizes[0]: number of meshes, sizes[1]: total number of vertices, sizes[2]: total number of faces
+void getMeshBuffersSizes(CMeshBuffers *buffers, int *sizes)
+{
+    if(sizes == NULL) return;
+    sizes[0] = sizes[1] = sizes[2] = 0;
+    if(buffers)
+    {
+        sizes[0] = buffers->atBoundary.size();
+        sizes[1] = buffers->vertexOffsets.back();
+        sizes[2] = buffers->faceOffsets.back();
+    }
+}
+
+/*
+ * points: 3 x sizes[1], faces: 3 x sizes[2], vertexOffsets and faceOffsets: sizes[0] + 1, atBoundary: sizes[0].
+ */
+int copyMeshBuffers(CMeshBuffers *buffers, float *points, int *faces, int *vertexOffsets, int *faceOffsets, int *atBoundary)
+{
+    if(buffers == NULL) return 0;
+    if(points) std::copy(buffers->points.begin(), buffers->points.end(), points);
+    if(faces) std::copy(buffers->faces.begin(), buffers->faces.end(), faces);
+    if(vertexOffsets) std::copy(buffers->vertexOffsets.begin(), buffers->vertexOffsets.end(), vertexOffsets);
+    if(faceOffsets) std::copy(buffers->faceOffsets.begin(), buffers->faceOffsets.end(), faceOffsets);
+    if(atBoundary) std::copy(buffers->atBoundary.begin(), buffers->atBoundary.end(), atBoundary);
+    return 1;
+}
+
+int deleteMeshBuffers(CMeshBuffers *buffers){
+    if(buffers){
+        delete buffers;
+        return 1;
+    }
+    else{
+        return 0;
+    }
+}
+
 //Set Parameter
 void setCrossMesh(CPolyLines *polylines, XMLData* data, bool haveBoundary)
 {
@@ -500,6 +803,7 @@ void setCrossMesh(CPolyLines *polylines, XMLData* data, bool haveBoundary)
 
         strucCreator->crossMeshCreator = make_shared<CrossMeshCreator>(data->varList);
         strucCreator->crossMeshCreator->setCrossMesh(surface, atBoundary);
+        markDirty(data, STAGE_CROSSMESH);
     }
 }
 
@@ -541,6 +845,7 @@ void setPattern(CPolyLines *polylines, XMLData* data)
             strucCreator->crossMeshCreator = make_shared<CrossMeshCreator>(data->varList);
         }
         strucCreator->crossMeshCreator->setPatternMesh(pattern_surface);
+        markDirty(data, STAGE_CROSSMESH);
     }
 }
 
@@ -578,39 +883,75 @@ void setReferenceSurface(CMesh *cmesh, XMLData* data)
             strucCreator->crossMeshCreator = make_shared<CrossMeshCreator>(data->varList);
         }
         strucCreator->crossMeshCreator->setReferenceSurface(reference_mesh);
+        markDirty(data, STAGE_CROSSMESH);
     }
 }
 
 void setParaDouble(const char *name, double value, XMLData* data){
-    if(data && data->varList)
+    if(data && data->varList){
         data->varList->set(name,  (float)value);
+        markDirty(data, parameterStage(name));
+    }
     return;
 }
 
 void setParaInt(const char *name, int value, XMLData* data){
-    if(data && data->varList)
+    if(data && data->varList){
         data->varList->set(name,  (int)value);
+        markDirty(data, parameterStage(name));
+    }
     return;
 }
 
 void setPatternAngle(double angle, XMLData *data){
-    if(data)
+    if(data && data->interact_delta.angle != angle)
     {
         data->interact_delta.angle = angle;
+        markDirty(data, STAGE_TEXTURE);
     }
 }
 
 void setPatternXY(double x, double y, XMLData *data){
-    if(data)
+    if(data && (data->interact_delta.x != x || data->interact_delta.y != y))
     {
         data->interact_delta.x = x;
         data->interact_delta.y = y;
+        markDirty(data, STAGE_TEXTURE);
     }
 }
 
 void setPatternScale(double s, XMLData *data){
-    if(data)
+    if(data && data->interact_delta.scale != s)
     {
         data->interact_delta.scale = s;
+        markDirty(data, STAGE_TEXTURE);
+    }
+}
+
+//Incremental Update
+int getStructureVersion(XMLData* data)
+{
+    if(data == NULL) return 0;
+    std::lock_guard<std::mutex> lock(refreshStatesMutex);
+    auto find_it = refreshStates.find(data);
+    return find_it != refreshStates.end() ? find_it->second.version : 0;
+}
+
+int getChangedParts(XMLData* data, int sinceVersion, int *partIDs)
+{
+    if(data == NULL) return 0;
+    std::lock_guard<std::mutex> lock(refreshStatesMutex);
+    auto find_it = refreshStates.find(data);
+    if(find_it == refreshStates.end()) return 0;
+
+    const vector<int> &partVersions = find_it->second.partVersions;
+    int n_changed = 0;
+    for(size_t id = 0; id < partVersions.size(); id++)
+    {
+        if(partVersions[id] > sinceVersion){
+            if(partIDs) partIDs[n_changed] = id;
+            n_changed++;
+        }
     }
+    return n_changed;
 }
\ No newline at end of file
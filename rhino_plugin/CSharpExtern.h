@@ -26,6 +26,10 @@ struct CPolyLines
     int n_points;
 };
 
+// an opaque handle on the flat buffers of many meshes,
+// read with getMeshBuffersSizes and copyMeshBuffers, released with deleteMeshBuffers.
+struct CMeshBuffers;
+
 struct ContactGraphData{
     vector<pPolyMesh> meshes;
     vector<bool> atBoundary;
@@ -144,6 +148,34 @@ CSharp_LIBRARY_C_FUNCTION
 void copyFaceGroupI(PolyMeshRhino *mesh, int fgID, int* fg);
 
 
+//Bulk Copy
+//the sizes are queried first, then the caller allocates the buffers and fills them in one call.
+//a NULL buffer is skipped.
+CSharp_LIBRARY_C_FUNCTION
+void getPolyMeshSizes(PolyMeshRhino *mesh, int *sizes);
+
+CSharp_LIBRARY_C_FUNCTION
+int copyPolyMesh(PolyMeshRhino *mesh, float *points, int *faces, int *vgOffsets, int *vg, int *fgOffsets, int *fg);
+
+CSharp_LIBRARY_C_FUNCTION
+int getPolyLinesSize(PolyLineRhino *polylines);
+
+CSharp_LIBRARY_C_FUNCTION
+int copyPolyLines(PolyLineRhino *polylines, float *points, int *offsets);
+
+CSharp_LIBRARY_C_FUNCTION
+CMeshBuffers *initStructureMeshes(XMLData *data);
+
+CSharp_LIBRARY_C_FUNCTION
+void getMeshBuffersSizes(CMeshBuffers *buffers, int *sizes);
+
+CSharp_LIBRARY_C_FUNCTION
+int copyMeshBuffers(CMeshBuffers *buffers, float *points, int *faces, int *vertexOffsets, int *faceOffsets, int *atBoundary);
+
+CSharp_LIBRARY_C_FUNCTION
+int deleteMeshBuffers(CMeshBuffers *buffers);
+
+
 //Set Para
 CSharp_LIBRARY_C_FUNCTION
 void setCrossMesh(CPolyLines *polylines, XMLData* data, bool haveBoundary);
@@ -170,4 +202,15 @@ CSharp_LIBRARY_C_FUNCTION
 void setPatternScale(double s, XMLData *data);
 
 
+//Incremental Update
+//refresh and preview only recompute the stages changed by the setters since the last update.
+//every update which recomputed something increments the version, the parts modified by it get that version.
+CSharp_LIBRARY_C_FUNCTION
+int getStructureVersion(XMLData* data);
+
+//the number of parts changed after sinceVersion, their IDs are written into partIDs unless it is NULL
+CSharp_LIBRARY_C_FUNCTION
+int getChangedParts(XMLData* data, int sinceVersion, int *partIDs);
+
+
 #endif
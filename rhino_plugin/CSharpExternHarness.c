@@ -0,0 +1,126 @@
+/*
+ * A plain C caller of the extern API, which sees the library as the C# plugin does: only opaque pointers and flat arrays.
+ * Build it against the plugin library, then run: CSharpExternHarness project.xml
+ * It returns 0 if every check passes.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+typedef struct XMLData XMLData;
+typedef struct CMeshBuffers CMeshBuffers;
+
+XMLData* readXML(const char *xmlstr);
+int deleteStructure(XMLData* data);
+void refresh(XMLData* data);
+void preview(XMLData* data);
+int partNumber(XMLData* data);
+void setPatternAngle(double angle, XMLData *data);
+
+int getStructureVersion(XMLData* data);
+int getChangedParts(XMLData* data, int sinceVersion, int *partIDs);
+
+CMeshBuffers *initStructureMeshes(XMLData *data);
+void getMeshBuffersSizes(CMeshBuffers *buffers, int *sizes);
+int copyMeshBuffers(CMeshBuffers *buffers, float *points, int *faces, int *vertexOffsets, int *faceOffsets, int *atBoundary);
+int deleteMeshBuffers(CMeshBuffers *buffers);
+
+#define CHECK(condition) do{ if(!(condition)){ printf("failed: %s (line %d)\n", #condition, __LINE__); return 1; } } while(0)
+
+int checkMeshBuffers(XMLData *data)
+{
+    int sizes[3], id, jd;
+    float *points;
+    int *faces, *vertexOffsets, *faceOffsets, *atBoundary;
+    CMeshBuffers *buffers;
+
+    CHECK(initStructureMeshes(NULL) == NULL);
+    CHECK(copyMeshBuffers(NULL, NULL, NULL, NULL, NULL, NULL) == 0);
+    CHECK(deleteMeshBuffers(NULL) == 0);
+
+    buffers = initStructureMeshes(data);
+    CHECK(buffers != NULL);
+    getMeshBuffersSizes(buffers, sizes);
+    CHECK(sizes[0] == partNumber(data));
+
+    points = (float *)malloc(sizeof(float) * 3 * sizes[1]);
+    faces = (int *)malloc(sizeof(int) * 3 * sizes[2]);
+    vertexOffsets = (int *)malloc(sizeof(int) * (sizes[0] + 1));
+    faceOffsets = (int *)malloc(sizeof(int) * (sizes[0] + 1));
+    atBoundary = (int *)malloc(sizeof(int) * sizes[0]);
+    CHECK(copyMeshBuffers(buffers, points, faces, vertexOffsets, faceOffsets, atBoundary) == 1);
+
+    /* the face indices are local to their mesh */
+    CHECK(vertexOffsets[0] == 0 && faceOffsets[0] == 0);
+    CHECK(vertexOffsets[sizes[0]] == sizes[1] && faceOffsets[sizes[0]] == sizes[2]);
+    for(id = 0; id < sizes[0]; id++)
+    {
+        int n_vertices = vertexOffsets[id + 1] - vertexOffsets[id];
+        CHECK(n_vertices >= 0 && faceOffsets[id + 1] >= faceOffsets[id]);
+        CHECK(atBoundary[id] == 0 || atBoundary[id] == 1);
+        for(jd = 3 * faceOffsets[id]; jd < 3 * faceOffsets[id + 1]; jd++){
+            CHECK(faces[jd] >= 0 && faces[jd] < n_vertices);
+        }
+    }
+
+    free(points); free(faces); free(vertexOffsets); free(faceOffsets); free(atBoundary);
+    CHECK(deleteMeshBuffers(buffers) == 1);
+    return 0;
+}
+
+int checkStagedRefresh(XMLData *data)
+{
+    int version, n_changed, id, *partIDs;
+
+    /* the first refresh built every part */
+    version = getStructureVersion(data);
+    CHECK(version > 0);
+    CHECK(getChangedParts(data, 0, NULL) == partNumber(data));
+
+    /* nothing changed: neither the version nor the parts */
+    refresh(data);
+    CHECK(getStructureVersion(data) == version);
+    CHECK(getChangedParts(data, version, NULL) == 0);
+
+    /* a preview keeps the cross mesh, the next refresh builds the blocks again */
+    setPatternAngle(15, data);
+    preview(data);
+    CHECK(getStructureVersion(data) == version + 1);
+    refresh(data);
+    CHECK(getStructureVersion(data) == version + 2);
+    refresh(data);
+    CHECK(getStructureVersion(data) == version + 2);
+
+    n_changed = getChangedParts(data, version, NULL);
+    CHECK(n_changed >= 0 && n_changed <= partNumber(data));
+    partIDs = (int *)malloc(sizeof(int) * (n_changed + 1));
+    CHECK(getChangedParts(data, version, partIDs) == n_changed);
+    for(id = 0; id < n_changed; id++){
+        CHECK(partIDs[id] >= 0 && partIDs[id] < partNumber(data));
+    }
+    free(partIDs);
+    return 0;
+}
+
+int main(int argc, char **argv)
+{
+    XMLData *data;
+    int failed;
+
+    if(argc < 2){
+        printf("Usage: CSharpExternHarness project.xml\n");
+        return 2;
+    }
+
+    data = readXML(argv[1]);
+    CHECK(data != NULL);
+    refresh(data);
+    CHECK(partNumber(data) > 0);
+
+    failed = checkMeshBuffers(data);
+    if(!failed) failed = checkStagedRefresh(data);
+
+    deleteStructure(data);
+    if(!failed) printf("passed\n");
+    return failed;
+}
@@ -93,79 +93,105 @@ void BaseMeshCreator<Scalar>::computeInternalCross(Matrix4 textureMat,
     pattern2D_vertices_on_polyMesh.clear();
     pattern2D_vertices_on_polyMesh.resize(pattern2D.lock()->vertexList.size(), nullptr);
 
-    tbb::concurrent_vector<pVertex> vertexLists;
-    // map 2D pattern vertices on 3D input surface
-    tbb::parallel_for(tbb::blocked_range<size_t>(0, pattern2D.lock()->vertexList.size()),[&](const tbb::blocked_range<size_t>& r)
+    // 1) get the texture coordinates of all pattern vertices
+    vector<size_t> pattern2D_vertexIDs;
+    vector<Vector2> tex_2DCoords;
+    pattern2D_texCoords.clear();
+    pattern2D_texCoords.resize(pattern2D.lock()->vertexList.size(), Vector2::Zero());
+    for (size_t id = 0; id < pattern2D.lock()->vertexList.size(); ++id)
+    {
+        if (pattern2D.lock()->vertexList[id] == nullptr) continue;
+        Vector2 ver_2DCoord = pattern2D.lock()->vertexList[id]->pos.head(2);
+        pattern2D_texCoords[id] = getTextureCoord(ver_2DCoord, textureMat);
+        pattern2D_vertexIDs.push_back(id);
+        tex_2DCoords.push_back(pattern2D_texCoords[id]);
+    }
+
+    // 2) compute the 3D coordinates of the 2D texture vertices
+    // by inversing the parametrization mapping
+    vector<Vector3> ver_3DCoords;
+    vector<int> insides;
+    mapTexPointsBackToSurface(tex_2DCoords, ver_3DCoords, insides);
+
+    // 3) create the 3D vertices, their IDs follow the order of pattern2D's vertices
+    vector<size_t> vertex_offsets;
+    size_t num_vertices = computeParallelPrefixSum(insides, vertex_offsets);
+    crossMesh->vertexList.resize(num_vertices);
+
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, pattern2D_vertexIDs.size()),[&](const tbb::blocked_range<size_t>& r)
     {
         for (size_t id = r.begin(); id != r.end(); ++id)
-            //for (size_t id = 0; id != pattern2D.lock()->vertexList.size(); ++id)
         {
-            if (pattern2D.lock()->vertexList[id] == nullptr) continue;
-
-            // 1) get the interactive position of each vertex.
-            Vector2 ver_2DCoord = pattern2D.lock()->vertexList[id]->pos.head(2);
-            Vector2 tex_2DCoord = getTextureCoord(ver_2DCoord, textureMat);
-
-            // 2) compute the 3D coordinates of the 2D texture vertices
-            // by inversing the parametrization mapping
-            Vector3 ver_3DCoord;
-            if (mapTexPointBackToSurface(tex_2DCoord, ver_3DCoord)) {
-                // create a new pVertex and add it to crossMesh
-                pVertex ver3D = make_shared<VPoint<Scalar>>(ver_3DCoord); // coordinate
-                pattern2D_vertices_on_polyMesh[id] = ver3D;
-                vertexLists.push_back(ver3D);
-            }
+            if (insides[id] == 0) continue;
+            pVertex ver3D = make_shared<VPoint<Scalar>>(ver_3DCoords[id]); // coordinate
+            ver3D->verID = vertex_offsets[id];
+            crossMesh->vertexList[vertex_offsets[id]] = ver3D;
+            pattern2D_vertices_on_polyMesh[pattern2D_vertexIDs[id]] = ver3D;
         }
     });
 
-    //construct crossMesh's vertexList
-    for(pVertex ver3D: vertexLists)
-    {
-        ver3D->verID = crossMesh->vertexList.size();
-        crossMesh->vertexList.push_back(ver3D);
-    }
-
-    tbb::concurrent_vector<pCross> internal_cross;
-    tbb::concurrent_vector<pPolygon> internal_pattern2D;
-
-    // generating all internal crosses
-    tbb::parallel_for(tbb::blocked_range<size_t>(0, pattern2D.lock()->size()),[&](const tbb::blocked_range<size_t>& r)
+    // 4) count the internal and boundary polygons of pattern2D
+    size_t num_pattern = pattern2D.lock()->size();
+    vector<int> internal_counts(num_pattern, 0);
+    vector<int> boundary_counts(num_pattern, 0);
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, num_pattern),[&](const tbb::blocked_range<size_t>& r)
     {
         for (size_t id = r.begin(); id != r.end(); ++id)
-            //for (size_t id = 0; id != pattern2D.lock()->size(); ++id)
         {
-            if(pattern2D.lock()->cross(id) == nullptr) continue;
             pCross poly2D = pattern2D.lock()->cross(id);
-
-            // create an empty 3D internal cross
-            pCross cross3D = make_shared<Cross<Scalar>>(getVarList());
-            cross3D->atBoundary = false;
+            if(poly2D == nullptr) continue;
 
             // from previous section,
             // we know the 3D corresponding coordinate of each poly2D's vertex.
-            // if exist, add it to the cross3D
-            // if not, stop
-            int num_vertex_inside = 0;
+            size_t num_vertex_inside = 0;
             for (size_t jd = 0; jd < poly2D->vers.size(); jd++)
             {
                 int ver_index2D = poly2D->vers[jd]->verID;
-                pVertex vertex = pattern2D_vertices_on_polyMesh[ver_index2D];
-                if(vertex != nullptr){
-                    cross3D->vers.push_back(vertex);
-                    num_vertex_inside++;
-                }
+                if(pattern2D_vertices_on_polyMesh[ver_index2D] != nullptr) num_vertex_inside++;
             }
 
             // if all vertex of poly2D is interal.
-            if(num_vertex_inside == poly2D->vers.size())
-            {
-                internal_cross.push_back(cross3D);
-                internal_pattern2D.push_back(make_shared<_Polygon<Scalar>>(*poly2D));
+            if(num_vertex_inside == poly2D->vers.size()) internal_counts[id] = 1;
+            else if(num_vertex_inside > 0) boundary_counts[id] = 1;
+        }
+    });
+
+    vector<size_t> internal_offsets, boundary_offsets;
+    size_t num_internal = computeParallelPrefixSum(internal_counts, internal_offsets);
+    size_t num_boundary = computeParallelPrefixSum(boundary_counts, boundary_offsets);
+
+    // 5) fill the internal crosses, their 2D polygons and the boundary polygons at their offsets
+    vector<pCross> internal_cross(num_internal);
+    vector<pPolygon> internal_pattern2D(num_internal);
+    boundary_pattern2D.clear();
+    boundary_pattern2D.resize(num_boundary);
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, num_pattern),[&](const tbb::blocked_range<size_t>& r)
+    {
+        for (size_t id = r.begin(); id != r.end(); ++id)
+        {
+            pCross poly2D = pattern2D.lock()->cross(id);
+            if(boundary_counts[id]){
+                boundary_pattern2D[boundary_offsets[id]] = poly2D;
             }
-            else if(num_vertex_inside > 0)
-            {
-                boundary_pattern2D.push_back(poly2D);
+            if(internal_counts[id] == 0) continue;
+
+            // create a 3D internal cross
+            pCross cross3D = make_shared<Cross<Scalar>>(getVarList());
+            cross3D->atBoundary = false;
+            for (size_t jd = 0; jd < poly2D->vers.size(); jd++){
+                cross3D->vers.push_back(pattern2D_vertices_on_polyMesh[poly2D->vers[jd]->verID]);
+            }
+            internal_cross[internal_offsets[id]] = cross3D;
+
+            // rescale the 2D polygon into texture space
+            pPolygon rescale_poly = make_shared<_Polygon<Scalar>>(*poly2D);
+            for(pVertex vertex : rescale_poly->vers){
+                const Vector2 &textureCoord = pattern2D_texCoords[vertex->verID];
+                vertex->pos.x() = textureCoord.x();
+                vertex->pos.y() = textureCoord.y();
+                vertex->pos.z() = 0;
             }
+            internal_pattern2D[internal_offsets[id]] = rescale_poly;
         }
     });
 
@@ -175,17 +201,7 @@ void BaseMeshCreator<Scalar>::computeInternalCross(Matrix4 textureMat,
     }
 
     //append all polygons into baseMesh
-    for(pPolygon poly: internal_pattern2D)
-    {
-        pPolygon rescale_poly = make_shared<_Polygon<Scalar>>(*poly);
-        for(pVertex vertex : rescale_poly->vers){
-            Vector2 textureCoord = getTextureCoord(vertex->pos.head(2), textureMat);
-            vertex->pos.x() = textureCoord.x();
-            vertex->pos.y() = textureCoord.y();
-            vertex->pos.z() = 0;
-        }
-        baseMesh2D->polyList.push_back(rescale_poly);
-    }
+    baseMesh2D->polyList.insert(baseMesh2D->polyList.end(), internal_pattern2D.begin(), internal_pattern2D.end());
 }
 
 template <typename Scalar>
@@ -193,17 +209,24 @@ void BaseMeshCreator<Scalar>::computeBoundaryCross(Matrix4 textureMat,
                                                    pPolyMesh &baseMesh2D,
                                                    pCrossMesh &crossMesh)
 {
-    tbb::concurrent_vector<pPolygon> crossLists;
-    tbb::concurrent_vector<pPolygon> poly2DLists;
-
-    // For each boundary cross, we cut it by using the mesh boundary
+    // 1) intersect every pattern edge crossing the surface boundary once.
+    // an edge is shared by two neighboring boundary polygons, both of them read the same intersection
+    // so the boundary vertices they create coincide exactly.
+    vector<BoundaryEdge> boundary_edges;
+    computeBoundaryEdges(textureMat, boundary_edges);
+
+    // 2) for each boundary cross, we cut it by using the mesh boundary
+    // every boundary polygon writes its pieces into its own slot
+    vector<vector<pPolygon>> crossSlots(boundary_pattern2D.size());
+    vector<vector<pPolygon>> poly2DSlots(boundary_pattern2D.size());
+
+    tbb::enumerable_thread_specific<BoundaryScratch> scratches;
     tbb::parallel_for(tbb::blocked_range<size_t>(0, boundary_pattern2D.size()),[&](const tbb::blocked_range<size_t>& r)
     {
-        //for(size_t id = 0; id < boundary_pattern2D.size(); id++)
-        for (size_t id = r.begin(); id != r.end(); ++id){
-            vector<bool> lines_inside;
-            vector<Line<Scalar>> lines3D;
-            vector<Line<Scalar>> lines2D;
+        BoundaryScratch &scratch = scratches.local();
+        for (size_t id = r.begin(); id != r.end(); ++id)
+        {
+            scratch.clear();
             pPolygon poly = boundary_pattern2D[id];
             int N = poly->size();
             for(size_t jd = 0; jd < N; jd++)
@@ -211,88 +234,73 @@ void BaseMeshCreator<Scalar>::computeBoundaryCross(Matrix4 textureMat,
                 int staID = poly->vers[jd]->verID;
                 int endID = poly->vers[(jd + 1) % N]->verID;
 
-                Vector2 sta_pos2D = poly->vers[jd]->pos.head(2);
-                sta_pos2D = getTextureCoord(sta_pos2D, textureMat);
-
-                Vector2 end_pos2D = poly->vers[(jd + 1) % N]->pos.head(2);
-                end_pos2D = getTextureCoord(end_pos2D, textureMat);
-
                 pVertex sta_ver3D = pattern2D_vertices_on_polyMesh[staID];
                 pVertex end_ver3D = pattern2D_vertices_on_polyMesh[endID];
 
-                if(sta_ver3D != nullptr && end_ver3D != nullptr){
-                    //both are inside
-                    lines3D.push_back(Line<Scalar>(sta_ver3D->pos, end_ver3D->pos));
-                    lines2D.push_back(Line<Scalar>(sta_pos2D, end_pos2D));
-                    lines_inside.push_back(true);
-                }
-                else if(sta_ver3D == nullptr && end_ver3D == nullptr){
+                if(sta_ver3D == nullptr && end_ver3D == nullptr){
                     //both are outside
-                    lines3D.push_back(Line<Scalar>());
-                    lines2D.push_back(Line<Scalar>());
-                    lines_inside.push_back(false);
+                    scratch.push_outside();
+                    continue;
                 }
-                else if(sta_ver3D != nullptr && end_ver3D == nullptr){
 
-                    //sta3d insde, end_ver3D outside
-                    //find intersection with the boundary
-                    Line<Scalar> line(sta_pos2D, end_pos2D);
-                    Vector2 brdy2D; Vector3 brdy3D;
+                Vector2 sta_pos2D = pattern2D_texCoords[staID];
+                Vector2 end_pos2D = pattern2D_texCoords[endID];
 
-                    //has intersection with boundary
-                    //and have correspond position on the surface
-                    if(polyMesh.lock()->findBoundaryIntersec(line, brdy2D, brdy3D))
+                if(sta_ver3D != nullptr && end_ver3D != nullptr){
+                    //both are inside
+                    scratch.push_inside(Line<Scalar>(sta_ver3D->pos, end_ver3D->pos), Line<Scalar>(sta_pos2D, end_pos2D));
+                }
+                else if(sta_ver3D != nullptr){
+                    //sta3d insde, end_ver3D outside
+                    const BoundaryEdge *edge = findBoundaryEdge(boundary_edges, staID, endID);
+                    if(edge != nullptr && edge->intersected)
                     {
-                        lines3D.push_back(Line<Scalar>(sta_ver3D->pos, brdy3D));
-                        lines2D.push_back(Line<Scalar>(sta_pos2D, brdy2D));
-                        lines_inside.push_back(true);
-
-                        lines3D.push_back(Line<Scalar>());
-                        lines2D.push_back(Line<Scalar>());
-                        lines_inside.push_back(false);
-                    }
-                    else{
-                        lines3D.push_back(Line<Scalar>());
-                        lines2D.push_back(Line<Scalar>());
-                        lines_inside.push_back(false);
+                        scratch.push_inside(Line<Scalar>(sta_ver3D->pos, edge->brdy3D), Line<Scalar>(sta_pos2D, edge->brdy2D));
                     }
+                    scratch.push_outside();
                 }
                 else{
                     //sta3d outside, end_ver3D inside
-                    //find intersection with the boundary
-                    Line<Scalar> line(end_pos2D, sta_pos2D);
-                    Vector2 brdy2D; Vector3 brdy3D;
-
-                    //has intersection with boundary
-                    //and have correspond position on the surface
-                    if(polyMesh.lock()->findBoundaryIntersec(line, brdy2D, brdy3D))
+                    const BoundaryEdge *edge = findBoundaryEdge(boundary_edges, endID, staID);
+                    scratch.push_outside();
+                    if(edge != nullptr && edge->intersected)
                     {
-                        lines2D.push_back(Line<Scalar>());
-                        lines3D.push_back(Line<Scalar>());
-                        lines_inside.push_back(false);
-
-                        lines2D.push_back(Line<Scalar>(brdy2D, end_pos2D));
-                        lines3D.push_back(Line<Scalar>(brdy3D, end_ver3D->pos));
-                        lines_inside.push_back(true);
-                    }
-                    else{
-                        lines2D.push_back(Line<Scalar>());
-                        lines3D.push_back(Line<Scalar>());
-                        lines_inside.push_back(false);
+                        scratch.push_inside(Line<Scalar>(edge->brdy3D, end_ver3D->pos), Line<Scalar>(edge->brdy2D, end_pos2D));
                     }
                 }
             }
 
-            splitIntoConsecutivePolygons(lines3D, lines_inside, crossLists);
-            splitIntoConsecutivePolygons(lines2D, lines_inside, poly2DLists);
+            splitIntoConsecutivePolygons(scratch.lines3D, scratch.lines_inside, crossSlots[id]);
+            splitIntoConsecutivePolygons(scratch.lines2D, scratch.lines_inside, poly2DSlots[id]);
         }
     });
 
+    // 3) count-then-fill, the pieces keep the order of boundary_pattern2D
+    vector<int> counts(crossSlots.size());
+    for(size_t id = 0; id < crossSlots.size(); id++){
+        counts[id] = crossSlots[id].size();
+    }
+    vector<size_t> offsets;
+    size_t num_pieces = computeParallelPrefixSum(counts, offsets);
+
+    vector<pCross> crossLists(num_pieces);
+    vector<pPolygon> poly2DLists(num_pieces);
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, crossSlots.size()),[&](const tbb::blocked_range<size_t>& r)
+    {
+        for (size_t id = r.begin(); id != r.end(); ++id)
+        {
+            for(size_t jd = 0; jd < crossSlots[id].size(); jd++)
+            {
+                pCross cross = make_shared<Cross<Scalar>>(*crossSlots[id][jd], getVarList());
+                cross->atBoundary = true;
+                crossLists[offsets[id] + jd] = cross;
+                poly2DLists[offsets[id] + jd] = poly2DSlots[id][jd];
+            }
+        }
+    });
 
     //append to crossMesh
-    for(pPolygon poly: crossLists){
-        pCross cross = make_shared<Cross<Scalar>>(*poly, getVarList());
-        cross->atBoundary = true;
+    for(pCross cross: crossLists){
         crossMesh->push_back(cross);
     }
 
@@ -300,6 +308,90 @@ void BaseMeshCreator<Scalar>::computeBoundaryCross(Matrix4 textureMat,
     baseMesh2D->polyList.insert(baseMesh2D->polyList.end(), poly2DLists.begin(), poly2DLists.end());
 }
 
+template <typename Scalar>
+void BaseMeshCreator<Scalar>::computeBoundaryEdges(Matrix4 textureMat, vector<BoundaryEdge> &boundary_edges)
+{
+    boundary_edges.clear();
+
+    // count the edges with one vertex inside and one outside
+    vector<int> counts(boundary_pattern2D.size(), 0);
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, boundary_pattern2D.size()),[&](const tbb::blocked_range<size_t>& r)
+    {
+        for (size_t id = r.begin(); id != r.end(); ++id)
+        {
+            pPolygon poly = boundary_pattern2D[id];
+            for(size_t jd = 0; jd < poly->size(); jd++)
+            {
+                bool sta_inside = pattern2D_vertices_on_polyMesh[poly->vers[jd]->verID] != nullptr;
+                bool end_inside = pattern2D_vertices_on_polyMesh[poly->vers[(jd + 1) % poly->size()]->verID] != nullptr;
+                if(sta_inside != end_inside) counts[id]++;
+            }
+        }
+    });
+
+    vector<size_t> offsets;
+    size_t num_edges = computeParallelPrefixSum(counts, offsets);
+    boundary_edges.resize(num_edges);
+
+    // fill them as (inside vertex, outside vertex)
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, boundary_pattern2D.size()),[&](const tbb::blocked_range<size_t>& r)
+    {
+        for (size_t id = r.begin(); id != r.end(); ++id)
+        {
+            pPolygon poly = boundary_pattern2D[id];
+            size_t index = offsets[id];
+            for(size_t jd = 0; jd < poly->size(); jd++)
+            {
+                pVertex sta = poly->vers[jd];
+                pVertex end = poly->vers[(jd + 1) % poly->size()];
+                bool sta_inside = pattern2D_vertices_on_polyMesh[sta->verID] != nullptr;
+                bool end_inside = pattern2D_vertices_on_polyMesh[end->verID] != nullptr;
+                if(sta_inside == end_inside) continue;
+
+                BoundaryEdge &edge = boundary_edges[index++];
+                pVertex in = sta_inside ? sta : end;
+                pVertex out = sta_inside ? end : sta;
+                edge.inID = in->verID;
+                edge.outID = out->verID;
+                edge.in_pos2D = pattern2D_texCoords[in->verID];
+                edge.out_pos2D = pattern2D_texCoords[out->verID];
+            }
+        }
+    });
+
+    // remove the duplicated edges shared by two boundary polygons
+    tbb::parallel_sort(boundary_edges.begin(), boundary_edges.end());
+    boundary_edges.erase(std::unique(boundary_edges.begin(), boundary_edges.end(), [](const BoundaryEdge &a, const BoundaryEdge &b){
+        return a.inID == b.inID && a.outID == b.outID;
+    }), boundary_edges.end());
+
+    // find the intersection with the surface boundary
+    // has intersection with boundary and have correspond position on the surface
+    pPolyMeshAABB mesh = polyMesh.lock();
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, boundary_edges.size()),[&](const tbb::blocked_range<size_t>& r)
+    {
+        for (size_t id = r.begin(); id != r.end(); ++id)
+        {
+            BoundaryEdge &edge = boundary_edges[id];
+            Line<Scalar> line(edge.in_pos2D, edge.out_pos2D);
+            edge.intersected = mesh != nullptr && mesh->findBoundaryIntersec(line, edge.brdy2D, edge.brdy3D);
+        }
+    });
+}
+
+template <typename Scalar>
+const typename BaseMeshCreator<Scalar>::BoundaryEdge *BaseMeshCreator<Scalar>::findBoundaryEdge(const vector<BoundaryEdge> &boundary_edges, int inID, int outID) const
+{
+    BoundaryEdge key;
+    key.inID = inID;
+    key.outID = outID;
+    auto it = std::lower_bound(boundary_edges.begin(), boundary_edges.end(), key);
+    if(it != boundary_edges.end() && it->inID == inID && it->outID == outID){
+        return &(*it);
+    }
+    return nullptr;
+}
+
 template<typename Scalar>
 void BaseMeshCreator<Scalar>::removeSmallCrosses(BaseMeshCreator::pCrossMesh crossMesh)
 {
@@ -427,7 +519,7 @@ template <typename Scalar>
 void  BaseMeshCreator<Scalar>::splitIntoConsecutivePolygons(
         const vector<Line<Scalar>> &lines,
         const vector<bool>& insides,
-        tbb::concurrent_vector<pPolygon> &polyList)
+        vector<pPolygon> &polyList)
 {
     //split the lines_inside into consecutive true list
     //because it is a loop, the begin and end should be consider separately
@@ -475,9 +567,10 @@ void  BaseMeshCreator<Scalar>::splitIntoConsecutivePolygons(
 }
 
 template <typename Scalar>
-Matrix<Scalar, 2, 1> BaseMeshCreator<Scalar>::getTextureCoord(Vector2 point, Matrix4 textureMat)
+Matrix<Scalar, 2, 1> BaseMeshCreator<Scalar>::getTextureCoord(const Vector2 &point, const Matrix4 &textureMat) const
 {
-    Vector2 texCoord = (textureMat * Matrix<Scalar, 4, 1>(point.x(), point.y(), 0, 1)).head(2);
+    // the pattern lies in the plane z = 0, only the 2x2 linear part and the translation of textureMat matter
+    Vector2 texCoord = textureMat.template topLeftCorner<2, 2>() * point + textureMat.template block<2, 1>(0, 3);
 
     return texCoord;
 }
@@ -507,4 +600,60 @@ bool BaseMeshCreator<Scalar>::mapTexPointBackToSurface(Vector2 ptTexCoord, Vecto
     return false;
 }
 
+template <typename Scalar>
+void BaseMeshCreator<Scalar>::mapTexPointsBackToSurface(const vector<Vector2> &ptTexCoords,
+                                                        vector<Vector3> &ptSurfCoords,
+                                                        vector<int> &insides)
+{
+    ptSurfCoords.assign(ptTexCoords.size(), Vector3(0, 0, 0));
+    insides.assign(ptTexCoords.size(), 0);
+    pPolyMeshAABB mesh = polyMesh.lock();
+    if(mesh == nullptr) return;
+
+    // only query the points inside the valid texture range
+    vector<size_t> queryIDs;
+    vector<Vector2> queryPts;
+    for(size_t id = 0; id < ptTexCoords.size(); id++)
+    {
+        const Vector2 &pt = ptTexCoords[id];
+        if(pt.x() < -1.5 || pt.x() > 1.5) continue;
+        if(pt.y() < -1.5 || pt.y() > 1.5) continue;
+        queryIDs.push_back(id);
+        queryPts.push_back(pt);
+    }
+
+    typename PolyMesh_AABBTree<Scalar>::TexPointQueryResult result;
+    mesh->findTexPoints(queryPts, result);
+
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, queryIDs.size()), [&](const tbb::blocked_range<size_t>& r)
+    {
+        for (size_t id = r.begin(); id != r.end(); ++id)
+        {
+            if(result.faceIDs[id] == -1) continue;
+            pPolygon poly = mesh->polyList[result.faceIDs[id]];
+            Vector3 &ptSurfCoord = ptSurfCoords[queryIDs[id]];
+
+            if(poly->size() == 3)
+            {
+                // a triangle is its own fan, the triangle barycentric coordinates can be used directly
+                for(int jd = 0; jd < 3; jd++){
+                    ptSurfCoord += poly->pos(jd) * result.barycentric[id * 3 + jd];
+                }
+                insides[queryIDs[id]] = 1;
+            }
+            else
+            {
+                vector<Scalar> barycentric = poly->computeBaryCentric(queryPts[id]);
+                if(barycentric.size() == poly->size())
+                {
+                    for(int jd = 0; jd < poly->size(); jd++){
+                        ptSurfCoord += poly->pos(jd) * barycentric[jd];
+                    }
+                    insides[queryIDs[id]] = 1;
+                }
+            }
+        }
+    });
+}
+
 template class BaseMeshCreator<double>;
@@ -21,6 +21,7 @@
 
 #include "TopoLite/Mesh/PolyMesh_AABBTree.h"
 #include "Mesh/CrossMesh.h"
+#include "Utility/ParallelPrefixSum.h"
 
 using namespace std;
 
@@ -70,9 +71,13 @@ public:
     //null when the vertices in outside of polyMesh's texture space
     vector<pVertex> pattern2D_vertices_on_polyMesh;
 
-    //a polygon of pattern2D locates on the boundary of polyMesh's texture space
-    //null if not
-    tbb::concurrent_vector<pPolygon> boundary_pattern2D;
+    //the texture coordinates of the vertices of pattern2D
+    //pattern2D stays in its own space, textureMat is only applied here, once per vertex
+    vector<Vector2> pattern2D_texCoords;
+
+    //the polygons of pattern2D locating on the boundary of polyMesh's texture space
+    //in the order of pattern2D's crosses
+    vector<pPolygon> boundary_pattern2D;
 
     wpPolyMeshAABB polyMesh;
 
@@ -80,6 +85,44 @@ public:
 
 	const float viewSize = 2.0;   // Note: since the 2D pattern mesh has been normalized into [-1.0, 1.0]
 
+public:
+
+    /*!
+     * \brief: a pattern edge with one vertex inside and one vertex outside the surface's texture space
+     */
+    struct BoundaryEdge{
+        int inID = -1, outID = -1;          // pattern2D vertex IDs
+        Vector2 in_pos2D, out_pos2D;        // texture coordinates of the two vertices
+        bool intersected = false;           // has intersection with the surface boundary
+        Vector2 brdy2D;
+        Vector3 brdy3D;
+
+        bool operator < (const BoundaryEdge &edge) const{
+            return inID < edge.inID || (inID == edge.inID && outID < edge.outID);
+        }
+    };
+
+    /*!
+     * \brief: per-thread buffers for cutting a boundary polygon, reused across polygons
+     */
+    struct BoundaryScratch{
+        vector<bool> lines_inside;
+        vector<Line<Scalar>> lines3D;
+        vector<Line<Scalar>> lines2D;
+
+        void clear(){
+            lines_inside.clear(); lines3D.clear(); lines2D.clear();
+        }
+
+        void push_inside(const Line<Scalar> &line3D, const Line<Scalar> &line2D){
+            lines3D.push_back(line3D); lines2D.push_back(line2D); lines_inside.push_back(true);
+        }
+
+        void push_outside(){
+            lines3D.push_back(Line<Scalar>()); lines2D.push_back(Line<Scalar>()); lines_inside.push_back(false);
+        }
+    };
+
 public:
 
     BaseMeshCreator(pPolyMeshAABB _polyMesh,
@@ -120,6 +163,14 @@ public:
                               pPolyMesh &baseMesh2D,
                               pCrossMesh &crossMesh);
 
+	/*!
+	 * \brief: collect the pattern edges crossing the surface boundary, sorted and without duplicates,
+	 *          and intersect each of them with the boundary once
+	 */
+	void computeBoundaryEdges(Matrix4 textureMat, vector<BoundaryEdge> &boundary_edges);
+
+	const BoundaryEdge *findBoundaryEdge(const vector<BoundaryEdge> &boundary_edges, int inID, int outID) const;
+
 	void removeSmallCrosses(pCrossMesh crossMesh);
 
     void recomputeBoundary(pCrossMesh crossMesh);
@@ -130,7 +181,7 @@ public:
 	/*!
 	 * \brief: scale the 2D pattern position into UV space
 	 */
-    Vector2 getTextureCoord(Vector2 point, Matrix4 textureMat);
+    Vector2 getTextureCoord(const Vector2 &point, const Matrix4 &textureMat) const;
 
 	/*!
 	 * \brief: project the 2D ptTexCoord into the Surface
@@ -138,7 +189,13 @@ public:
 	 */
 	bool mapTexPointBackToSurface(Vector2 ptTexCoord, Vector3 &ptSurfCoord);
 
-	void splitIntoConsecutivePolygons(const vector<Line<Scalar>> &line, const vector<bool>& inside, tbb::concurrent_vector<pPolygon> &polyList);
+	/*!
+	 * \brief: batched version of mapTexPointBackToSurface
+	 * \param[out] insides: insides[i] = 1 if ptTexCoords[i] has been mapped into ptSurfCoords[i]
+	 */
+	void mapTexPointsBackToSurface(const vector<Vector2> &ptTexCoords, vector<Vector3> &ptSurfCoords, vector<int> &insides);
+
+	void splitIntoConsecutivePolygons(const vector<Line<Scalar>> &line, const vector<bool>& inside, vector<pPolygon> &polyList);
     
 };
 #endif
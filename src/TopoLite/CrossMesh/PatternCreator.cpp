@@ -20,6 +20,7 @@
 #include "Mesh/PolyMesh.h"
 
 #include <queue>
+#include <map>
 
 using std::queue;
 
@@ -103,6 +104,62 @@ template<typename Scalar>
 void PatternCreator<Scalar>::create2DPattern(PatternType patternID,
                                              int patternRadius,
                                              pCrossMesh &crossMesh)
+{
+    // the tiling only depends on the pattern type and the radius.
+    // it is generated once per process and every call builds a fresh mesh from the cached buffer.
+    pPatternBuffer buffer = create2DPatternBuffer(patternID, patternRadius);
+    createPatternMesh(*buffer, crossMesh);
+}
+
+template<typename Scalar>
+typename PatternCreator<Scalar>::pPatternBuffer PatternCreator<Scalar>::create2DPatternBuffer(PatternType patternID, int patternRadius)
+{
+    pPatternBuffer buffer = findCachedPattern(patternID, patternRadius);
+    if(buffer != nullptr) return buffer;
+
+    // Every pattern is periodic: it is described by a translational unit cell and two lattice vectors
+    // so that any region can be emitted directly, in parallel, with analytic shared vertex indices.
+    // The region is the one of the BFS, found by a BFS on the lattice indices,
+    // and the BFS is kept as a fallback in case the lattice can not be recovered or does not reproduce its depths.
+    shared_ptr<PatternBuffer> new_buffer = make_shared<PatternBuffer>();
+    pPatternLattice lattice = findPatternLattice(patternID);
+    if(lattice != nullptr){
+        createLatticePattern(*lattice, patternRadius, *new_buffer);
+    }
+    else{
+        pCrossMesh bfsMesh;
+        create2DPattern_BFS(patternID, patternRadius, bfsMesh);
+        packPatternBuffer(bfsMesh, *new_buffer);
+    }
+
+    return cachePattern(patternID, patternRadius, new_buffer);
+}
+
+template<typename Scalar>
+void PatternCreator<Scalar>::create2DPattern_BFS(PatternType patternID,
+                                                 int patternRadius,
+                                                 pCrossMesh &crossMesh)
+{
+    //the mesh class of the pattern
+    pPolyMesh patternMesh = make_shared<PolyMesh<Scalar>>(getVarList());
+
+    vector<int> depths;
+    createPolygons_BFS(patternID, patternRadius, patternMesh->polyList, depths);
+
+    patternMesh->update();
+    patternMesh->normalize();
+
+    crossMesh = make_shared<CrossMesh<Scalar>>(*patternMesh);
+    crossMesh->baseMesh2D = patternMesh;
+
+    return;
+}
+
+template<typename Scalar>
+void PatternCreator<Scalar>::createPolygons_BFS(PatternType patternID,
+                                                int patternRadius,
+                                                vector<pPolygon> &polys,
+                                                vector<int> &depths)
 {
     // The algorithm is a BFS searching.
     // Each time, we pop a polygon from the queue
@@ -123,9 +180,6 @@ void PatternCreator<Scalar>::create2DPattern(PatternType patternID,
         }
     };
 
-    //the mesh class of the pattern
-    pPolyMesh patternMesh = make_shared<PolyMesh<Scalar>>(getVarList());
-
     //a set to record all vertices of the pattern mesh
     //a very helpful tool to verify whether a polygon already exist in patternMesh
     setVertex vertices_set;
@@ -153,7 +207,8 @@ void PatternCreator<Scalar>::create2DPattern(PatternType patternID,
         }
         else{
             // add the polygon into the mesh
-            patternMesh->polyList.push_back(curr_node.poly);
+            polys.push_back(curr_node.poly);
+            depths.push_back(curr_node.depth);
         }
 
         // find a one ring neighbor of the polygon.
@@ -174,17 +229,478 @@ void PatternCreator<Scalar>::create2DPattern(PatternType patternID,
             }
         }
     }
+}
 
 
-    patternMesh->update();
-    patternMesh->normalize();
+//**************************************************************************************//
+//                           Create Mesh (Lattice of a Unit Cell)
+//**************************************************************************************//
 
-    crossMesh = make_shared<CrossMesh<Scalar>>(*patternMesh);
+template<typename Scalar>
+bool PatternCreator<Scalar>::computePatternLattice(PatternType patternID, PatternLattice &lattice)
+{
+    // 1) grow a small patch with the neighbor rules of the pattern
+    vector<pPolygon> seeds;
+    vector<int> depths;
+    createPolygons_BFS(patternID, LATTICE_SEED_DEPTH, seeds, depths);
+    if(seeds.empty() || depths.back() != LATTICE_SEED_DEPTH - 1) return false;
+
+    Vector3 origin = seeds.front()->center();
+    vector<Vector3> centroids(seeds.size());
+    std::map<Vector3, int, pVertex_compare> centroid_map;
+    for(size_t id = 0; id < seeds.size(); id++){
+        centroids[id] = seeds[id]->center();
+        centroid_map[centroids[id]] = id;
+    }
+
+    // the patch surely covers the disk bounded by its outermost layer
+    Scalar inner_radius = MAX_FLOAT;
+    for(size_t id = 0; id < seeds.size(); id++){
+        if(depths[id] == LATTICE_SEED_DEPTH - 1) inner_radius = std::min(inner_radius, (centroids[id] - origin).norm());
+    }
+    Scalar check_radius = inner_radius / 2;
+
+    // 2) the lattice vectors map the root onto a copy of itself and every polygon near the root onto another polygon
+    vector<Vector3> translations;
+    for(size_t id = 1; id < seeds.size(); id++)
+    {
+        Vector3 trans = centroids[id] - origin;
+        if(trans.norm() > check_radius || !isTranslatedPolygon(seeds.front(), seeds[id])) continue;
+
+        bool valid = true;
+        for(size_t jd = 0; jd < seeds.size() && valid; jd++)
+        {
+            if((centroids[jd] - origin).norm() > check_radius) continue;
+            auto find_it = centroid_map.find(centroids[jd] + trans);
+            valid = find_it != centroid_map.end() && isTranslatedPolygon(seeds[jd], seeds[find_it->second]);
+        }
+        if(valid) translations.push_back(trans);
+    }
+
+    // in 2D, the two shortest independent lattice vectors form a basis
+    std::sort(translations.begin(), translations.end(), [](const Vector3 &a, const Vector3 &b){
+        return a.norm() < b.norm();
+    });
+    if(translations.empty()) return false;
+    lattice.latticeA = translations.front();
+    bool has_basis = false;
+    for(const Vector3 &trans: translations){
+        if(std::abs(lattice.latticeA.cross(trans).z()) > FLOAT_ERROR_LARGE * lattice.latticeA.norm() * trans.norm()){
+            lattice.latticeB = trans;
+            has_basis = true;
+            break;
+        }
+    }
+    // the unit cell should be inside the patch
+    if(!has_basis || lattice.latticeA.norm() + lattice.latticeB.norm() > inner_radius) return false;
+
+    lattice.origin = origin;
+    Matrix<Scalar, 2, 2> basis;
+    basis << lattice.latticeA.x(), lattice.latticeB.x(),
+             lattice.latticeA.y(), lattice.latticeB.y();
+    lattice.inverseBasis = basis.inverse();
+
+    // 3) the unit cell is made of the polygons whose centroids lie in the fundamental parallelogram
+    lattice.cellPolygons.clear();
+    lattice.cellCentroids.clear();
+    lattice.cellCorners.clear();
+    lattice.vertexClasses.clear();
+    for(size_t id = 0; id < seeds.size(); id++)
+    {
+        Eigen::Vector2i cell = lattice.computeCell(centroids[id]);
+        if(cell != Eigen::Vector2i(0, 0)) continue;
+
+        lattice.cellPolygons.push_back(seeds[id]);
+        lattice.cellCentroids.push_back(centroids[id]);
+
+        // 4) each corner is a vertex class of the cell (0, 0) shifted by a lattice offset
+        vector<Eigen::Vector3i> corners;
+        for(size_t jd = 0; jd < seeds[id]->size(); jd++)
+        {
+            Vector3 pt = seeds[id]->pos(jd);
+            Eigen::Vector2i offset = lattice.computeCell(pt);
+            Vector3 class_pt = pt - offset.x() * lattice.latticeA - offset.y() * lattice.latticeB;
+
+            int classID = -1;
+            for(size_t kd = 0; kd < lattice.vertexClasses.size(); kd++){
+                if((lattice.vertexClasses[kd] - class_pt).norm() < FLOAT_ERROR_LARGE){
+                    classID = kd;
+                    break;
+                }
+            }
+            if(classID == -1){
+                classID = lattice.vertexClasses.size();
+                lattice.vertexClasses.push_back(class_pt);
+            }
+            corners.push_back(Eigen::Vector3i(classID, offset.x(), offset.y()));
+        }
+        lattice.cellCorners.push_back(corners);
+    }
+
+    // 5) the polygons incident to each vertex class, used to know which vertices are emitted
+    lattice.vertexIncidences.clear();
+    lattice.vertexIncidences.resize(lattice.vertexClasses.size());
+    lattice.maxCornerOffset = 0;
+    for(size_t id = 0; id < lattice.cellCorners.size(); id++){
+        for(const Eigen::Vector3i &corner: lattice.cellCorners[id]){
+            lattice.vertexIncidences[corner[0]].push_back(Eigen::Vector3i(id, corner[1], corner[2]));
+            lattice.maxCornerOffset = std::max(lattice.maxCornerOffset, std::max(std::abs(corner[1]), std::abs(corner[2])));
+        }
+    }
+
+    // 6) the neighbors of each cell polygon, so that the BFS can run on the lattice indices
+    lattice.cellNeighbors.clear();
+    lattice.cellNeighbors.resize(lattice.cellPolygons.size());
+    lattice.stepLength = 0;
+    for(size_t id = 0; id < lattice.cellPolygons.size(); id++)
+    {
+        vector<pPolygon> neighbors;
+        computeNeighbors(patternID, lattice.cellPolygons[id], neighbors);
+        for(pPolygon neighbor: neighbors){
+            Eigen::Vector3i index = lattice.locatePolygon(neighbor->center());
+            if(index[0] == -1) return false;
+            lattice.cellNeighbors[id].push_back(index);
+            lattice.stepLength = std::max(lattice.stepLength, (neighbor->center() - lattice.cellCentroids[id]).norm());
+        }
+    }
+    if(lattice.cellPolygons.empty() || lattice.stepLength <= 0) return false;
+
+    // 7) the BFS skips a polygon whose edges are all known already, so the depths on the lattice must match the seed patch
+    vector<int> lattice_depths;
+    computeLatticeDepths(lattice, LATTICE_SEED_DEPTH, lattice_depths);
+    Eigen::Vector2i range = lattice.computeRange(LATTICE_SEED_DEPTH);
+    size_t num_reached = lattice_depths.size() - std::count(lattice_depths.begin(), lattice_depths.end(), -1);
+    if(num_reached != seeds.size()) return false;
+    for(size_t id = 0; id < seeds.size(); id++)
+    {
+        Eigen::Vector3i index = lattice.locatePolygon(centroids[id]);
+        if(index[0] == -1 || std::abs(index[1]) > range.x() || std::abs(index[2]) > range.y()) return false;
+        size_t key = ((size_t)(index[2] + range.y()) * (2 * range.x() + 1) + index[1] + range.x()) * lattice.cellPolygons.size() + index[0];
+        if(lattice_depths[key] != depths[id]) return false;
+    }
+
+    return true;
+}
+
+template<typename Scalar>
+typename PatternCreator<Scalar>::pPatternLattice PatternCreator<Scalar>::findPatternLattice(PatternType patternID)
+{
+    {
+        std::lock_guard<std::mutex> lock(patternCacheMutex());
+        auto find_it = latticeCache().find((int)patternID);
+        if(find_it != latticeCache().end()) return find_it->second;
+    }
+
+    // the seed BFS of computePatternLattice does not depend on the radius, it only runs on the first request of the type
+    shared_ptr<PatternLattice> lattice = make_shared<PatternLattice>();
+    if(!computePatternLattice(patternID, *lattice)) lattice = nullptr;
+
+    std::lock_guard<std::mutex> lock(patternCacheMutex());
+    auto result = latticeCache().insert(std::make_pair((int)patternID, pPatternLattice(lattice)));
+    return result.first->second;
+}
+
+template<typename Scalar>
+bool PatternCreator<Scalar>::isTranslatedPolygon(pPolygon polyA, pPolygon polyB)
+{
+    // polyType is not compared: polygons with different labels may have the same shape
+    if(polyA->size() != polyB->size()) return false;
+    Vector3 centerA = polyA->center(), centerB = polyB->center();
+    for(size_t id = 0; id < polyA->size(); id++)
+    {
+        bool found = false;
+        for(size_t jd = 0; jd < polyB->size() && !found; jd++){
+            found = ((polyA->pos(id) - centerA) - (polyB->pos(jd) - centerB)).norm() < FLOAT_ERROR_LARGE;
+        }
+        if(!found) return false;
+    }
+    return true;
+}
+
+template<typename Scalar>
+void PatternCreator<Scalar>::createLatticePattern(const PatternLattice &lattice,
+                                                  int patternRadius,
+                                                  PatternBuffer &buffer)
+{
+    // the region is the one of the BFS: the polygons within patternRadius - 1 steps of the root
+    vector<int> depths;
+    computeLatticeDepths(lattice, patternRadius, depths);
+
+    Eigen::Vector2i range = lattice.computeRange(patternRadius);
+    int rangeI = range.x(), rangeJ = range.y();
+    int numCellI = 2 * rangeI + 1, numCellJ = 2 * rangeJ + 1;
+    size_t numCells = (size_t)numCellI * numCellJ;
+    int numCellPolys = lattice.cellPolygons.size();
+
+    auto isPolygonInside = [&](int polyID, int i, int j) -> bool {
+        if(std::abs(i) > rangeI || std::abs(j) > rangeJ) return false;
+        return depths[((size_t)(j + rangeJ) * numCellI + i + rangeI) * numCellPolys + polyID] != -1;
+    };
+
+    // 1) count-then-fill the polygons and their corners, cell by cell
+    vector<int> poly_counts(numCells, 0);
+    vector<int> corner_counts(numCells, 0);
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, numCells), [&](const tbb::blocked_range<size_t> &r){
+        for(size_t id = r.begin(); id != r.end(); ++id){
+            int i = id % numCellI - rangeI, j = id / numCellI - rangeJ;
+            for(int kd = 0; kd < numCellPolys; kd++){
+                if(isPolygonInside(kd, i, j)){
+                    poly_counts[id]++;
+                    corner_counts[id] += lattice.cellCorners[kd].size();
+                }
+            }
+        }
+    });
+    vector<size_t> poly_offsets, corner_offsets;
+    size_t numPolys = computeParallelPrefixSum(poly_counts, poly_offsets);
+    size_t numCorners = computeParallelPrefixSum(corner_counts, corner_offsets);
+
+    // 2) vertex (classID, i, j) exists when one of its incident polygons is emitted
+    int pad = lattice.maxCornerOffset;
+    int numVerI = numCellI + 2 * pad, numVerJ = numCellJ + 2 * pad;
+    int numClasses = lattice.vertexClasses.size();
+    size_t numVerKeys = (size_t)numVerI * numVerJ * numClasses;
+    auto vertexKey = [&](int classID, int i, int j) -> size_t {
+        return ((size_t)(j + rangeJ + pad) * numVerI + (i + rangeI + pad)) * numClasses + classID;
+    };
+
+    vector<int> vertex_counts(numVerKeys, 0);
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, numVerKeys), [&](const tbb::blocked_range<size_t> &r){
+        for(size_t id = r.begin(); id != r.end(); ++id){
+            int classID = id % numClasses;
+            int i = (id / numClasses) % numVerI - rangeI - pad;
+            int j = (id / numClasses) / numVerI - rangeJ - pad;
+            for(const Eigen::Vector3i &incident: lattice.vertexIncidences[classID]){
+                if(isPolygonInside(incident[0], i - incident[1], j - incident[2])){
+                    vertex_counts[id] = 1;
+                    break;
+                }
+            }
+        }
+    });
+    vector<size_t> vertex_offsets;
+    size_t numVertices = computeParallelPrefixSum(vertex_counts, vertex_offsets);
+
+    // 3) emit the vertices and the polygons into the flat buffers
+    buffer.vertices.resize(numVertices);
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, numVerKeys), [&](const tbb::blocked_range<size_t> &r){
+        for(size_t id = r.begin(); id != r.end(); ++id){
+            if(vertex_counts[id] == 0) continue;
+            int classID = id % numClasses;
+            int i = (id / numClasses) % numVerI - rangeI - pad;
+            int j = (id / numClasses) / numVerI - rangeJ - pad;
+            buffer.vertices[vertex_offsets[id]] = lattice.vertexClasses[classID] + i * lattice.latticeA + j * lattice.latticeB - lattice.origin;
+        }
+    });
+
+    buffer.corners.resize(numCorners);
+    buffer.polyOffsets.resize(numPolys + 1);
+    buffer.polyTypes.resize(numPolys);
+    buffer.polyOffsets[numPolys] = numCorners;
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, numCells), [&](const tbb::blocked_range<size_t> &r){
+        for(size_t id = r.begin(); id != r.end(); ++id){
+            int i = id % numCellI - rangeI, j = id / numCellI - rangeJ;
+            size_t index = poly_offsets[id];
+            size_t corner_index = corner_offsets[id];
+            for(int kd = 0; kd < numCellPolys; kd++)
+            {
+                if(!isPolygonInside(kd, i, j)) continue;
+                buffer.polyTypes[index] = lattice.cellPolygons[kd]->getPolyType();
+                buffer.polyOffsets[index] = corner_index;
+                for(const Eigen::Vector3i &corner: lattice.cellCorners[kd]){
+                    buffer.corners[corner_index++] = vertex_offsets[vertexKey(corner[0], i + corner[1], j + corner[2])];
+                }
+                index++;
+            }
+        }
+    });
+
+    normalizePatternBuffer(buffer);
+}
+
+template<typename Scalar>
+void PatternCreator<Scalar>::computeLatticeDepths(const PatternLattice &lattice,
+                                                  int patternRadius,
+                                                  vector<int> &depths)
+{
+    // a plain BFS on integer indices: the root is the polygon 0 of the cell (0, 0)
+    Eigen::Vector2i range = lattice.computeRange(patternRadius);
+    int numCellI = 2 * range.x() + 1, numCellJ = 2 * range.y() + 1;
+    int numCellPolys = lattice.cellPolygons.size();
+    auto polygonKey = [&](int polyID, int i, int j) -> size_t {
+        return ((size_t)(j + range.y()) * numCellI + i + range.x()) * numCellPolys + polyID;
+    };
+
+    depths.clear();
+    depths.resize((size_t)numCellI * numCellJ * numCellPolys, -1);
+    if(patternRadius <= 0) return;
+
+    queue<Eigen::Vector3i> bfsQueue;
+    bfsQueue.push(Eigen::Vector3i(0, 0, 0));
+    depths[polygonKey(0, 0, 0)] = 0;
+    while(!bfsQueue.empty())
+    {
+        Eigen::Vector3i curr = bfsQueue.front();
+        bfsQueue.pop();
+        int depth = depths[polygonKey(curr[0], curr[1], curr[2])];
+        if(depth + 1 >= patternRadius) continue;
+
+        for(const Eigen::Vector3i &neighbor: lattice.cellNeighbors[curr[0]])
+        {
+            int i = curr[1] + neighbor[1], j = curr[2] + neighbor[2];
+            if(std::abs(i) > range.x() || std::abs(j) > range.y()) continue;
+            size_t key = polygonKey(neighbor[0], i, j);
+            if(depths[key] != -1) continue;
+            depths[key] = depth + 1;
+            bfsQueue.push(Eigen::Vector3i(neighbor[0], i, j));
+        }
+    }
+}
+
+//**************************************************************************************//
+//                                  Pattern Buffer
+//**************************************************************************************//
+
+template<typename Scalar>
+void PatternCreator<Scalar>::packPatternBuffer(pCrossMesh crossMesh, PatternBuffer &buffer)
+{
+    buffer.vertices.resize(crossMesh->vertexList.size());
+    for(size_t id = 0; id < crossMesh->vertexList.size(); id++){
+        crossMesh->vertexList[id]->verID = id;
+        buffer.vertices[id] = crossMesh->vertexList[id]->pos;
+    }
+
+    buffer.corners.clear();
+    buffer.polyOffsets.clear();
+    buffer.polyTypes.clear();
+    for(size_t id = 0; id < crossMesh->size(); id++)
+    {
+        pCross cross = crossMesh->cross(id);
+        buffer.polyOffsets.push_back(buffer.corners.size());
+        buffer.polyTypes.push_back(cross->getPolyType());
+        for(pVertex vertex: cross->vers){
+            buffer.corners.push_back(vertex->verID);
+        }
+    }
+    buffer.polyOffsets.push_back(buffer.corners.size());
+}
+
+template<typename Scalar>
+void PatternCreator<Scalar>::normalizePatternBuffer(PatternBuffer &buffer)
+{
+    // same as PolyMesh::normalize
+    if(buffer.vertices.empty()) return;
+    Vector3 minPt = buffer.vertices.front(), maxPt = buffer.vertices.front();
+    for(const Vector3 &pt: buffer.vertices){
+        minPt = minPt.cwiseMin(pt);
+        maxPt = maxPt.cwiseMax(pt);
+    }
+
+    Vector3 size = maxPt - minPt;
+    Scalar scale = 2.0 / size.maxCoeff();
+    Vector3 trans = -(minPt + maxPt) / 2;
+    for(Vector3 &pt: buffer.vertices){
+        pt = (pt + trans) * scale;
+    }
+}
+
+template<typename Scalar>
+void PatternCreator<Scalar>::createPatternMesh(const PatternBuffer &buffer, pCrossMesh &crossMesh)
+{
+    // the pattern and the cross mesh do not share vertices, so that either of them can be modified.
+    size_t numVertices = buffer.vertices.size();
+    size_t numPolys = buffer.size();
+
+    pPolyMesh patternMesh = make_shared<PolyMesh<Scalar>>(getVarList());
+    crossMesh = make_shared<CrossMesh<Scalar>>(getVarList());
+    patternMesh->vertexList.resize(numVertices);
+    crossMesh->vertexList.resize(numVertices);
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, numVertices), [&](const tbb::blocked_range<size_t> &r){
+        for(size_t id = r.begin(); id != r.end(); ++id){
+            for(auto mesh_vertexList : {&patternMesh->vertexList, &crossMesh->vertexList}){
+                pVertex vertex = make_shared<VPoint<Scalar>>(buffer.vertices[id]);
+                vertex->verID = id;
+                (*mesh_vertexList)[id] = vertex;
+            }
+        }
+    });
+
+    vector<pPolygon> polys(numPolys);
+    vector<pCross> crosses(numPolys);
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, numPolys), [&](const tbb::blocked_range<size_t> &r){
+        for(size_t id = r.begin(); id != r.end(); ++id)
+        {
+            pPolygon poly = make_shared<_Polygon<Scalar>>();
+            poly->setPolyType(buffer.polyTypes[id]);
+            pCross cross = make_shared<Cross<Scalar>>(*poly, getVarList());
+            cross->crossID = id;
+            for(size_t jd = buffer.polyOffsets[id]; jd < buffer.polyOffsets[id + 1]; jd++){
+                poly->vers.push_back(patternMesh->vertexList[buffer.corners[jd]]);
+                cross->vers.push_back(crossMesh->vertexList[buffer.corners[jd]]);
+            }
+            polys[id] = poly;
+            crosses[id] = cross;
+        }
+    });
+
+    patternMesh->polyList = polys;
+    for(pCross cross: crosses){
+        crossMesh->push_back(cross);
+    }
+    crossMesh->createConnectivity();
     crossMesh->baseMesh2D = patternMesh;
+}
 
-    return;
+//**************************************************************************************//
+//                                  Pattern Cache
+//**************************************************************************************//
+
+template<typename Scalar>
+std::map<std::pair<int, int>, typename PatternCreator<Scalar>::pPatternBuffer> &PatternCreator<Scalar>::patternCache()
+{
+    static std::map<std::pair<int, int>, pPatternBuffer> cache;
+    return cache;
+}
+
+template<typename Scalar>
+std::map<int, typename PatternCreator<Scalar>::pPatternLattice> &PatternCreator<Scalar>::latticeCache()
+{
+    static std::map<int, pPatternLattice> cache;
+    return cache;
 }
 
+template<typename Scalar>
+std::mutex &PatternCreator<Scalar>::patternCacheMutex()
+{
+    static std::mutex cache_mutex;
+    return cache_mutex;
+}
+
+template<typename Scalar>
+typename PatternCreator<Scalar>::pPatternBuffer PatternCreator<Scalar>::findCachedPattern(PatternType patternID, int patternRadius)
+{
+    std::lock_guard<std::mutex> lock(patternCacheMutex());
+    auto find_it = patternCache().find(std::make_pair((int)patternID, patternRadius));
+    if(find_it == patternCache().end()) return nullptr;
+    return find_it->second;
+}
+
+template<typename Scalar>
+typename PatternCreator<Scalar>::pPatternBuffer PatternCreator<Scalar>::cachePattern(PatternType patternID, int patternRadius, pPatternBuffer buffer)
+{
+    // if another thread has cached the same pattern meanwhile, its buffer is kept
+    std::lock_guard<std::mutex> lock(patternCacheMutex());
+    auto result = patternCache().insert(std::make_pair(std::make_pair((int)patternID, patternRadius), buffer));
+    return result.first->second;
+}
+
+template<typename Scalar>
+void PatternCreator<Scalar>::clearPatternCache()
+{
+    std::lock_guard<std::mutex> lock(patternCacheMutex());
+    patternCache().clear();
+    latticeCache().clear();
+}
 
 //**************************************************************************************//
 //                           Create Mesh (2D Regular Pattern)
@@ -16,7 +16,10 @@
 #define _MESH_CREATOR_H
 
 #include <vector>
+#include <map>
+#include <mutex>
 #include "Mesh/CrossMesh.h"
+#include "Utility/ParallelPrefixSum.h"
 
 enum PatternType{
     CROSS_SQUARE = 1,
@@ -78,6 +81,70 @@ public:
 
     typedef std::set<Vector3, pVertex_compare> setVertex;
 
+    typedef shared_ptr<VPoint<Scalar>> pVertex;
+
+    typedef shared_ptr<Cross<Scalar>> pCross;
+
+    /*!
+     * \brief: translational unit cell of a pattern.
+     *          polygon k of the cell (i, j) is cellPolygons[k] translated by i * latticeA + j * latticeB.
+     *          a vertex of the tiling is indexed by (classID, i, j): vertexClasses[classID] translated by the cell (i, j).
+     */
+    struct PatternLattice{
+        Vector3 origin;                                     // centroid of the root polygon
+        Vector3 latticeA, latticeB;                         // lattice vectors
+        Matrix<Scalar, 2, 2> inverseBasis;                  // map a position into lattice coordinates
+        vector<pPolygon> cellPolygons;                      // the polygons of the cell (0, 0)
+        vector<Vector3> cellCentroids;
+        vector<vector<Eigen::Vector3i>> cellCorners;        // for each corner of a cell polygon: (classID, di, dj)
+        vector<Vector3> vertexClasses;                      // vertex positions inside the cell (0, 0)
+        vector<vector<Eigen::Vector3i>> vertexIncidences;   // for each vertex class: (cell polygon ID, di, dj)
+        vector<vector<Eigen::Vector3i>> cellNeighbors;      // for each cell polygon: (cell polygon ID, di, dj) of its BFS neighbors
+        int maxCornerOffset;
+        Scalar stepLength;                                  // the largest distance between the centroids of neighboring polygons
+
+        Eigen::Vector2i computeCell(const Vector3 &pt) const{
+            Matrix<Scalar, 2, 1> uv = inverseBasis * (pt - origin).head(2);
+            return Eigen::Vector2i(std::floor(uv.x() + FLOAT_ERROR_LARGE), std::floor(uv.y() + FLOAT_ERROR_LARGE));
+        }
+
+        // (cell polygon ID, i, j) of the polygon with this centroid, the ID is -1 if no polygon of the tiling has it
+        Eigen::Vector3i locatePolygon(const Vector3 &centroid) const{
+            Eigen::Vector2i cell = computeCell(centroid);
+            for(size_t id = 0; id < cellCentroids.size(); id++){
+                Vector3 pt = cellCentroids[id] + cell.x() * latticeA + cell.y() * latticeB;
+                if((pt - centroid).norm() < FLOAT_ERROR_LARGE) return Eigen::Vector3i(id, cell.x(), cell.y());
+            }
+            return Eigen::Vector3i(-1, cell.x(), cell.y());
+        }
+
+        // the cells (i, j), |i| <= range.x() and |j| <= range.y(), hold every polygon reached by a BFS of depth patternRadius
+        Eigen::Vector2i computeRange(int patternRadius) const{
+            Scalar radius = std::max(patternRadius - 1, 0) * stepLength;
+            return Eigen::Vector2i(std::ceil(radius * inverseBasis.row(0).norm()) + 1, std::ceil(radius * inverseBasis.row(1).norm()) + 1);
+        }
+    };
+
+    const static int LATTICE_SEED_DEPTH = 12;
+
+    /*!
+     * \brief: a generated pattern stored as flat buffers.
+     *          the pattern is kept in its normalized space, the texture transform is applied when it is mapped onto the surface,
+     *          so that one buffer serves every rotation/scale/offset of the pattern.
+     */
+    struct PatternBuffer{
+        vector<Vector3> vertices;                           // normalized vertex positions
+        vector<int> corners;                                // the vertex IDs of all polygons, polygon by polygon
+        vector<size_t> polyOffsets;                         // polygon i owns corners[polyOffsets[i], polyOffsets[i + 1])
+        vector<int> polyTypes;
+
+        size_t size() const {return polyTypes.size();}
+    };
+
+    typedef shared_ptr<const PatternBuffer> pPatternBuffer;
+
+    typedef shared_ptr<const PatternLattice> pPatternLattice;
+
 public:
 	PatternCreator();
 	PatternCreator(shared_ptr<InputVarList> var):TopoObject(var){}
@@ -90,6 +157,60 @@ public:
 	                     int patternRadius,
 	                     pCrossMesh &out);
 
+    // the buffer of the pattern, generated only if it is not in the cache
+    pPatternBuffer create2DPatternBuffer(PatternType patternID, int patternRadius);
+
+    void create2DPattern_BFS(PatternType patternID,
+                             int patternRadius,
+                             pCrossMesh &out);
+
+    void createPolygons_BFS(PatternType patternID,
+                            int patternRadius,
+                            vector<pPolygon> &polys,
+                            vector<int> &depths);
+
+    // Create Mesh (Lattice of a Unit Cell)
+    bool computePatternLattice(PatternType patternID, PatternLattice &lattice);
+
+    // the lattice of the pattern type, computed once per process and shared by every radius; nullptr if it has none
+    pPatternLattice findPatternLattice(PatternType patternID);
+
+    void createLatticePattern(const PatternLattice &lattice,
+                              int patternRadius,
+                              PatternBuffer &out);
+
+    // the BFS depth of polygon k of the cell (i, j) at depths[((j + range.y()) * (2 * range.x() + 1) + i + range.x()) * numCellPolys + k],
+    // -1 if the polygon is not reached within patternRadius
+    void computeLatticeDepths(const PatternLattice &lattice,
+                              int patternRadius,
+                              vector<int> &depths);
+
+    bool isTranslatedPolygon(pPolygon polyA, pPolygon polyB);
+
+    // Pattern Buffer
+    void packPatternBuffer(pCrossMesh crossMesh, PatternBuffer &out);
+
+    void normalizePatternBuffer(PatternBuffer &buffer);
+
+    void createPatternMesh(const PatternBuffer &buffer, pCrossMesh &out);
+
+    // Pattern Cache (shared by the whole process)
+    static pPatternBuffer findCachedPattern(PatternType patternID, int patternRadius);
+
+    static pPatternBuffer cachePattern(PatternType patternID, int patternRadius, pPatternBuffer buffer);
+
+    static void clearPatternCache();
+
+private:
+
+    static std::map<std::pair<int, int>, pPatternBuffer> &patternCache();
+
+    static std::map<int, pPatternLattice> &latticeCache();
+
+    static std::mutex &patternCacheMutex();
+
+public:
+
     // Create Polygons
     void createPolygonRoot(int edgeNum, Scalar edgeLen, pPolygon &out);
 
@@ -0,0 +1,338 @@
+#include "OBJReader.h"
+
+#include <tbb/tbb.h>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+
+#if defined(_WIN32)
+#include <iterator>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+inline bool isSpace(char c){
+    return c == ' ' || c == '\t' || c == '\r';
+}
+
+inline bool isDigit(char c){
+    return c >= '0' && c <= '9';
+}
+
+inline const char *skipSpace(const char *p, const char *end){
+    while(p < end && isSpace(*p)) p++;
+    return p;
+}
+
+// a number which is not a plain decimal (nan, inf, a huge exponent), read by strtod from a bounded copy
+const char *parseDoubleSlow(const char *p, const char *end, double &value)
+{
+    char buffer[64];
+    size_t length = 0;
+    while(p + length < end && length + 1 < sizeof(buffer) && !isSpace(p[length]) && p[length] != '\n') length++;
+    std::memcpy(buffer, p, length);
+    buffer[length] = 0;
+
+    char *stop = nullptr;
+    value = std::strtod(buffer, &stop);
+    if(stop == buffer) return nullptr;
+    return p + (stop - buffer);
+}
+
+/*
+ * The decimal digits are accumulated into a 64 bit integer and scaled once by an exact power of ten,
+ * which is within one ulp of strtod for the coordinates written by the modelling tools.
+ */
+const char *parseDouble(const char *p, const char *end, double &value)
+{
+    static const double pow10[] = {1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+                                   1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+    const char *start = p;
+
+    bool negative = false;
+    if(p < end && (*p == '-' || *p == '+')) negative = (*p++ == '-');
+
+    uint64_t mantissa = 0;
+    int exponent = 0;
+    bool hasDigit = false;
+    for(; p < end && isDigit(*p); p++){
+        if(mantissa < 100000000000000000ULL) mantissa = mantissa * 10 + (*p - '0');
+        else exponent++;
+        hasDigit = true;
+    }
+    if(p < end && *p == '.'){
+        for(p++; p < end && isDigit(*p); p++){
+            if(mantissa < 100000000000000000ULL){
+                mantissa = mantissa * 10 + (*p - '0');
+                exponent--;
+            }
+            hasDigit = true;
+        }
+    }
+    if(!hasDigit) return parseDoubleSlow(start, end, value);
+
+    if(p < end && (*p == 'e' || *p == 'E')){
+        const char *q = p + 1;
+        bool negativeExp = false;
+        if(q < end && (*q == '-' || *q == '+')) negativeExp = (*q++ == '-');
+        if(q < end && isDigit(*q)){
+            int e = 0;
+            for(; q < end && isDigit(*q); q++) if(e < 10000) e = e * 10 + (*q - '0');
+            exponent += negativeExp ? -e : e;
+            p = q;
+        }
+    }
+
+    if(exponent < -22 || exponent > 22) return parseDoubleSlow(start, end, value);
+    value = (double)mantissa;
+    value = exponent >= 0 ? value * pow10[exponent] : value / pow10[-exponent];
+    if(negative) value = -value;
+    return p;
+}
+
+const char *parseInt(const char *p, const char *end, int &value)
+{
+    bool negative = false;
+    if(p < end && (*p == '-' || *p == '+')) negative = (*p++ == '-');
+    if(p >= end || !isDigit(*p)) return nullptr;
+
+    long long number = 0;
+    for(; p < end && isDigit(*p); p++){
+        number = number * 10 + (*p - '0');
+        if(number > INT32_MAX) return nullptr;
+    }
+    value = negative ? -(int)number : (int)number;
+    return p;
+}
+
+}
+
+bool OBJReader::read(const std::string &filename, OBJData &data)
+{
+    error.clear();
+
+#if defined(_WIN32)
+    std::ifstream filein(filename, std::ifstream::binary);
+    if(filein.fail()){
+        error = "cannot open " + filename;
+        return false;
+    }
+    std::string text((std::istreambuf_iterator<char>(filein)), std::istreambuf_iterator<char>());
+    return parse(text.data(), text.size(), data);
+#else
+    int fd = open(filename.c_str(), O_RDONLY);
+    if(fd < 0){
+        error = "cannot open " + filename;
+        return false;
+    }
+
+    struct stat fileStat;
+    if(fstat(fd, &fileStat) < 0){
+        close(fd);
+        error = "cannot open " + filename;
+        return false;
+    }
+
+    size_t size = fileStat.st_size;
+    if(size == 0){
+        close(fd);
+        return parse(nullptr, 0, data);
+    }
+
+    void *text = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if(text == MAP_FAILED){
+        error = "cannot map " + filename;
+        return false;
+    }
+    madvise(text, size, MADV_SEQUENTIAL);
+
+    bool success = parse((const char *)text, size, data);
+    munmap(text, size);
+    return success;
+#endif
+}
+
+bool OBJReader::parse(const char *text, size_t size, OBJData &data)
+{
+    error.clear();
+    data = OBJData();
+    if(size == 0) return true;
+
+    // cut at the line ends, so that every chunk holds whole records
+    vector<const char *> cuts = {text};
+    const char *end = text + size;
+    while(end - cuts.back() > (ptrdiff_t)chunkSize)
+    {
+        const char *cut = (const char *)std::memchr(cuts.back() + chunkSize, '\n', end - cuts.back() - chunkSize);
+        if(cut == nullptr) break;
+        cuts.push_back(cut + 1);
+    }
+    cuts.push_back(end);
+
+    vector<Chunk> chunks(cuts.size() - 1);
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, chunks.size()), [&](const tbb::blocked_range<size_t>& r)
+    {
+        for(size_t id = r.begin(); id != r.end(); ++id){
+            parseChunk(cuts[id], cuts[id + 1], chunks[id]);
+        }
+    });
+
+    return mergeChunks(chunks, data, error);
+}
+
+void OBJReader::parseChunk(const char *begin, const char *end, Chunk &chunk)
+{
+    OBJData &data = chunk.data;
+    for(const char *p = begin; p < end && chunk.error.empty();)
+    {
+        const char *lineEnd = (const char *)std::memchr(p, '\n', end - p);
+        if(lineEnd == nullptr) lineEnd = end;
+
+        p = skipSpace(p, lineEnd);
+        if(lineEnd - p >= 2 && p[0] == 'v' && isSpace(p[1]))
+        {
+            for(int jd = 0; jd < 3; jd++){
+                double value;
+                p = skipSpace(p + (jd == 0 ? 2 : 0), lineEnd);
+                if((p = parseDouble(p, lineEnd, value)) == nullptr){
+                    chunk.error = "invalid vertex";
+                    break;
+                }
+                data.V.push_back(value);
+            }
+        }
+        else if(lineEnd - p >= 3 && p[0] == 'v' && p[1] == 't' && isSpace(p[2]))
+        {
+            // a missing v is taken as 0, a w is ignored
+            double value[2] = {0, 0};
+            p = skipSpace(p + 3, lineEnd);
+            for(int jd = 0; jd < 2 && p < lineEnd; jd++){
+                if((p = parseDouble(p, lineEnd, value[jd])) == nullptr){
+                    chunk.error = "invalid texture coordinate";
+                    break;
+                }
+                p = skipSpace(p, lineEnd);
+            }
+            data.TC.push_back(value[0]);
+            data.TC.push_back(value[1]);
+        }
+        else if(lineEnd - p >= 2 && p[0] == 'f' && isSpace(p[1]))
+        {
+            // the corners are v, v/vt, v//vn or v/vt/vn, the normals are ignored
+            int numVertices = data.V.size() / 3, numTexs = data.TC.size() / 2;
+            for(p = skipSpace(p + 2, lineEnd); p < lineEnd; p = skipSpace(p, lineEnd))
+            {
+                int vid, tid = 0, nid;
+                if((p = parseInt(p, lineEnd, vid)) == nullptr || vid == 0) break;
+                if(p < lineEnd && *p == '/'){
+                    p++;
+                    if(p < lineEnd && *p != '/' && ((p = parseInt(p, lineEnd, tid)) == nullptr || tid == 0)) break;
+                    if(p < lineEnd && *p == '/' && ((p = parseInt(p + 1, lineEnd, nid)) == nullptr)) break;
+                }
+                if(p < lineEnd && !isSpace(*p)) {p = nullptr; break;}
+
+                if(vid < 0) chunk.relativeF.push_back(data.F.size());
+                data.F.push_back(vid > 0 ? vid - 1 : numVertices + vid);
+
+                if(tid < 0) chunk.relativeFTC.push_back(data.FTC.size());
+                data.FTC.push_back(tid > 0 ? tid - 1 : (tid < 0 ? numTexs + tid : -1));
+            }
+            if(p == nullptr || p < lineEnd){
+                chunk.error = "invalid face";
+            }
+            data.faceOffsets.push_back(data.F.size());
+        }
+
+        p = lineEnd + 1;
+    }
+}
+
+bool OBJReader::mergeChunks(vector<Chunk> &chunks, OBJData &data, std::string &error)
+{
+    if(chunks.size() == 1 && chunks[0].relativeF.empty() && chunks[0].relativeFTC.empty()){
+        error = chunks[0].error;
+        data = std::move(chunks[0].data);
+    }
+    else
+    {
+        // the offsets of every chunk in the merged arrays
+        vector<size_t> baseV(chunks.size() + 1, 0), baseTC(chunks.size() + 1, 0), baseF(chunks.size() + 1, 0), baseFace(chunks.size() + 1, 0);
+        for(size_t id = 0; id < chunks.size(); id++){
+            if(error.empty()) error = chunks[id].error;
+            baseV[id + 1] = baseV[id] + chunks[id].data.V.size();
+            baseTC[id + 1] = baseTC[id] + chunks[id].data.TC.size();
+            baseF[id + 1] = baseF[id] + chunks[id].data.F.size();
+            baseFace[id + 1] = baseFace[id] + chunks[id].data.numFaces();
+        }
+        if(!error.empty()) return false;
+
+        data.V.resize(baseV.back());
+        data.TC.resize(baseTC.back());
+        data.F.resize(baseF.back());
+        data.FTC.resize(baseF.back());
+        data.faceOffsets.resize(baseFace.back() + 1);
+
+        tbb::parallel_for(tbb::blocked_range<size_t>(0, chunks.size()), [&](const tbb::blocked_range<size_t>& r)
+        {
+            for(size_t id = r.begin(); id != r.end(); ++id)
+            {
+                OBJData &chunk = chunks[id].data;
+                std::copy(chunk.V.begin(), chunk.V.end(), data.V.begin() + baseV[id]);
+                std::copy(chunk.TC.begin(), chunk.TC.end(), data.TC.begin() + baseTC[id]);
+                for(size_t jd: chunks[id].relativeF) chunk.F[jd] += baseV[id] / 3;
+                for(size_t jd: chunks[id].relativeFTC) chunk.FTC[jd] += baseTC[id] / 2;
+                std::copy(chunk.F.begin(), chunk.F.end(), data.F.begin() + baseF[id]);
+                std::copy(chunk.FTC.begin(), chunk.FTC.end(), data.FTC.begin() + baseF[id]);
+                for(size_t jd = 1; jd < chunk.faceOffsets.size(); jd++){
+                    data.faceOffsets[baseFace[id] + jd] = chunk.faceOffsets[jd] + baseF[id];
+                }
+            }
+        });
+    }
+    if(!error.empty()) return false;
+
+    int numVertices = data.numVertices(), numTexs = data.TC.size() / 2;
+    for(size_t id = 0; id < data.F.size(); id++){
+        if(data.F[id] < 0 || data.F[id] >= numVertices || data.FTC[id] < -1 || data.FTC[id] >= numTexs){
+            error = "face index out of range";
+            return false;
+        }
+    }
+    return true;
+}
+
+template<typename Scalar>
+bool OBJReader::readMeshes(const vector<std::string> &filenames,
+                           shared_ptr<InputVarList> varList,
+                           vector<shared_ptr<PolyMesh<Scalar>>> &meshes,
+                           bool normalized)
+{
+    meshes.clear();
+    meshes.resize(filenames.size());
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, filenames.size()), [&](const tbb::blocked_range<size_t>& r)
+    {
+        for(size_t id = r.begin(); id != r.end(); ++id)
+        {
+            OBJReader reader;
+            OBJData data;
+            if(!reader.read(filenames[id], data)) continue;
+
+            shared_ptr<PolyMesh<Scalar>> mesh = make_shared<PolyMesh<Scalar>>(varList);
+            mesh->readOBJModel(data.V, data.TC, data.F, data.FTC, data.faceOffsets, normalized);
+            meshes[id] = mesh;
+        }
+    });
+
+    return std::find(meshes.begin(), meshes.end(), nullptr) == meshes.end();
+}
+
+template bool OBJReader::readMeshes<double>(const vector<std::string> &,
+                                            shared_ptr<InputVarList>,
+                                            vector<shared_ptr<PolyMesh<double>>> &,
+                                            bool);
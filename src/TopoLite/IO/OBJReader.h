@@ -0,0 +1,63 @@
+#ifndef TOPOLITE_OBJREADER_H
+#define TOPOLITE_OBJREADER_H
+
+#include "Mesh/PolyMesh.h"
+
+#include <string>
+#include <vector>
+
+/**
+ * @brief The content of an .obj file in flat arrays, the indices start from 0.
+ *        The corners of face i are F[faceOffsets[i]] ... F[faceOffsets[i + 1] - 1],
+ *        FTC has one entry per corner (-1 when the corner has no texture coordinate).
+ */
+struct OBJData{
+    vector<double> V;               // x, y, z
+    vector<double> TC;              // u, v
+    vector<int> F;
+    vector<int> FTC;
+    vector<int> faceOffsets = {0};
+
+    int numVertices() const {return V.size() / 3;}
+    int numFaces() const {return faceOffsets.size() - 1;}
+};
+
+/**
+ * @brief A fast reader of the "v", "vt" and "f" records of .obj files, all the other records are skipped.
+ *        The file is memory mapped and parsed in place, a large file is cut at line ends into chunks parsed in parallel.
+ *        Replaces igl::readOBJ, which builds a vector per vertex and per face.
+ */
+class OBJReader{
+public:
+
+    bool read(const std::string &filename, OBJData &data);
+
+    bool parse(const char *text, size_t size, OBJData &data);
+
+    // read a set of parts concurrently, a file which cannot be read leaves a nullptr
+    template<typename Scalar>
+    static bool readMeshes(const vector<std::string> &filenames,
+                           shared_ptr<InputVarList> varList,
+                           vector<shared_ptr<PolyMesh<Scalar>>> &meshes,
+                           bool normalized);
+
+public:
+
+    size_t chunkSize = 1 << 22;     // a file under this size is parsed in one piece
+
+    std::string error;
+
+private:
+
+    struct Chunk{
+        OBJData data;
+        vector<size_t> relativeF, relativeFTC;  // the corners given by a negative index, which is relative to the chunk
+        std::string error;
+    };
+
+    static void parseChunk(const char *begin, const char *end, Chunk &chunk);
+
+    static bool mergeChunks(vector<Chunk> &chunks, OBJData &data, std::string &error);
+};
+
+#endif //TOPOLITE_OBJREADER_H
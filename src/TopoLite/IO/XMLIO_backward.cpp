@@ -12,6 +12,9 @@
 bool XMLIO_backward::XMLReader(const string xmlFileName, IOData &data)
 {
 
+    loadTimes.clear();
+    tbb::tick_count sta = tbb::tick_count::now();
+
     pugi::xml_document xmldoc;
     // load xmlfile
     if(!xmldoc.load_file(xmlFileName.c_str()))
@@ -30,11 +33,17 @@ bool XMLIO_backward::XMLReader(const string xmlFileName, IOData &data)
         InitVar_backward(data.varList.get());
         XMLReader_GUISettings(xml_root, data);
 
-        // 2) read reference surface
-        XMLReader_ReferenceSurface(xml_root, file_path.parent_path().string(), data);
+        recordLoadTime(xmlFileName, sta);
+
+        // 2) read reference surface and 3) read cross mesh, they are separate files
+        bool referenceSurfaceRead = false;
+        tbb::parallel_invoke(
+                [&]{ referenceSurfaceRead = XMLReader_ReferenceSurface(xml_root, file_path.parent_path().string(), data); },
+                [&]{ XMLReader_CrossMesh(xml_root, file_path.parent_path().string(), data); });
 
-        // 3) read cross mesh
-        XMLReader_CrossMesh(xml_root, file_path.parent_path().string(), data);
+        if(data.reference_surface && referenceSurfaceRead){
+            data.varList->add(data.reference_surface->texturedModel, "texturedModel", "");
+        }
 
         // 4) read cross mesh boundary
         XMLReader_Boundary(xml_root, data);
@@ -163,17 +172,7 @@ void XMLIO_backward::XMLReader_GUISettings(pugi::xml_node &xml_root, IOData &dat
             if(node_pickPartIDs)
             {
                 pugi::xml_text text_pickPartIDs = node_pickPartIDs.text();
-                string str_text = text_pickPartIDs.as_string();
-                vector<string> split_strs;
-                split_strs = split(str_text, ',');
-                for(string split_str : split_strs)
-                {
-                    if(split_str != "")
-                    {
-                        int PartID = std::stoi(split_str, nullptr, 10);
-                        data.pickPartIDs.push_back(PartID);
-                    }
-                }
+                data.pickPartIDs = readIntList(text_pickPartIDs.as_string());
             }
         }
 
@@ -198,13 +197,14 @@ bool XMLIO_backward::XMLReader_ReferenceSurface(pugi::xml_node &xml_root, const
     pugi::xml_node refenceSurfaceNode = xml_root.child("Output").child("Structure");
     if (refenceSurfaceNode)
     {
+        tbb::tick_count sta = tbb::tick_count::now();
         path reference_surface_path(refenceSurfaceNode.attribute("path").as_string());
         string path_str = (path(xmlFileName_path) / reference_surface_path).string();
         data.reference_surface = make_shared<PolyMesh<double>>(data.varList);
-        if (!data.reference_surface->readOBJModel(path_str.c_str(), false))
-            return false;
-
-        data.varList->add(data.reference_surface->texturedModel, "texturedModel", "");
+        bool read = data.reference_surface->readOBJModel(path_str.c_str(), false);
+        recordLoadTime(path_str, sta);
+        // the "texturedModel" parameter is added by XMLReader if the read succeeded, as the cross mesh is read at the same time
+        return read;
     }
     return true;
 }
@@ -218,6 +218,7 @@ bool XMLIO_backward::XMLReader_CrossMesh(pugi::xml_node &xml_root, const string
         //CrossData
         if(cross_mesh_node.child("CrossData"))
         {
+            tbb::tick_count sta = tbb::tick_count::now();
             path cross_data_path = cross_mesh_node.child("CrossData").attribute("path").as_string();
             cross_data_path = path(xmlFileName_path) / cross_data_path;
             pugi::xml_document cross_doc;
@@ -226,39 +227,47 @@ bool XMLIO_backward::XMLReader_CrossMesh(pugi::xml_node &xml_root, const string
             if (cross_data_node)
             {
                 data.cross_mesh = make_shared<CrossMesh<double>>(data.varList);
-                vector< shared_ptr<Cross<double>>> crossList;
-                for (pugi::xml_node cross_node: cross_data_node.children())
-                {
-                    int crossID = cross_node.attribute("id").as_int();
-                    shared_ptr<Cross<double>> cross = make_shared<Cross<double>>(data.varList);
-                    cross->crossID = crossID;
-                    for (pugi::xml_node ori_node : cross_node.children())
-                    {
-                        int edgeID = ori_node.attribute("id").as_int();
-                        if (edgeID < 0) continue;
-
-                        Eigen::Vector3d vertex = readXYZ(ori_node.child("Vertex").attribute("XYZ").as_string());
-                        cross->push_back(vertex);
-
-                        Eigen::Vector3d point = readXYZ(ori_node.child("Point").attribute("XYZ").as_string());
-                        Eigen::Vector3d normal = readXYZ(ori_node.child("Normal").attribute("XYZ").as_string());
-                        Eigen::Vector3d axis = readXYZ(ori_node.child("Rotation_Axis").attribute("XYZ").as_string());
 
-                        shared_ptr<OrientPoint<double>> oript = make_shared<OrientPoint<double>>(point, normal, axis);
+                // the document is only read from here, so the crosses are parsed in parallel
+                vector<pugi::xml_node> cross_nodes;
+                for (pugi::xml_node cross_node: cross_data_node.children()) cross_nodes.push_back(cross_node);
 
-                        double angle = ori_node.child("Angle").attribute("Radian").as_double();
-                        if(angle < 0){
-                            oript->tiltSign = -1;
-                            oript->updateAngle(angle);
-                        }
-                        else{
-                            oript->tiltSign = 1;
-                            oript->updateAngle(angle);
+                vector< shared_ptr<Cross<double>>> crossList(cross_nodes.size());
+                tbb::parallel_for(tbb::blocked_range<size_t>(0, cross_nodes.size()), [&](const tbb::blocked_range<size_t>& r)
+                {
+                    for(size_t id = r.begin(); id != r.end(); ++id)
+                    {
+                        int crossID = cross_nodes[id].attribute("id").as_int();
+                        shared_ptr<Cross<double>> cross = make_shared<Cross<double>>(data.varList);
+                        cross->crossID = crossID;
+                        for (pugi::xml_node ori_node : cross_nodes[id].children())
+                        {
+                            int edgeID = ori_node.attribute("id").as_int();
+                            if (edgeID < 0) continue;
+
+                            Eigen::Vector3d vertex = readXYZ(ori_node.child("Vertex").attribute("XYZ").as_string());
+                            cross->push_back(vertex);
+
+                            Eigen::Vector3d point = readXYZ(ori_node.child("Point").attribute("XYZ").as_string());
+                            Eigen::Vector3d normal = readXYZ(ori_node.child("Normal").attribute("XYZ").as_string());
+                            Eigen::Vector3d axis = readXYZ(ori_node.child("Rotation_Axis").attribute("XYZ").as_string());
+
+                            shared_ptr<OrientPoint<double>> oript = make_shared<OrientPoint<double>>(point, normal, axis);
+
+                            double angle = ori_node.child("Angle").attribute("Radian").as_double();
+                            if(angle < 0){
+                                oript->tiltSign = -1;
+                                oript->updateAngle(angle);
+                            }
+                            else{
+                                oript->tiltSign = 1;
+                                oript->updateAngle(angle);
+                            }
+                            cross->oriPoints.push_back(oript);
                         }
-                        cross->oriPoints.push_back(oript);
+                        crossList[id] = cross;
                     }
-                    crossList.push_back(cross);
-                }
+                });
                 std::sort(crossList.begin(), crossList.end(), [=](shared_ptr<Cross<double>> a, shared_ptr<Cross<double>> b){
                     return a->crossID < b->crossID;
                 });
@@ -269,6 +278,7 @@ bool XMLIO_backward::XMLReader_CrossMesh(pugi::xml_node &xml_root, const string
                 
                 data.cross_mesh->update();
             }
+            recordLoadTime(cross_data_path.string(), sta);
         }
     }
     return data.cross_mesh != nullptr;
@@ -284,45 +294,47 @@ void XMLIO_backward::XMLReader_Boundary(pugi::xml_node &xml_root, IOData &data)
         {
             //2) read the boundary part
             pugi::xml_text text_boundary = node_boundary.text();
-            vector<string> str_partIDs = split(text_boundary.get(), ',');
 
             //3) assign boundary marker
-            data.boundary_crossIDs.clear();
-            for(size_t id = 0; id < str_partIDs.size(); id++)
-            {
-                data.boundary_crossIDs.push_back(std::stoi(str_partIDs[id]));
-            }
+            data.boundary_crossIDs = readIntList(text_boundary.get());
         }
     }
 }
 
-Eigen::Vector3d XMLIO_backward::readXYZ(std::string xyz_str){
-    double x, y, z;
-    sscanf(xyz_str.c_str(), "(%lf,%lf,%lf)", &x, &y, &z);
-    return Eigen::Vector3d(x, y, z);
+Eigen::Vector3d XMLIO_backward::readXYZ(const char *xyz_str) const{
+    double xyz[3] = {0, 0, 0};
+    const char *p = xyz_str;
+    for(int id = 0; id < 3; id++)
+    {
+        while(*p == '(' || *p == ',' || *p == ' ') p++;
+        char *end = nullptr;
+        double value = std::strtod(p, &end);
+        if(end == p) break;
+        xyz[id] = value;
+        p = end;
+    }
+    return Eigen::Vector3d(xyz[0], xyz[1], xyz[2]);
 }
 
-
-vector<std::string> XMLIO_backward::split(const string str_text, const char separator) const{
-    vector<std::string> split_strings;
-    string accumulate = "";
-    for(size_t id = 0; id < str_text.size(); id++){
-        if(str_text[id] == separator || (id + 1 == str_text.size()))
-        {
-            if(id + 1 == str_text.size()){
-                accumulate += str_text[id];
-            }
-            
-            if(accumulate.find_first_not_of (' ') != accumulate.npos)
-            {
-                split_strings.push_back(accumulate);
-                accumulate = "";
-            }
-        }
-        else{
-            accumulate += str_text[id];
+vector<int> XMLIO_backward::readIntList(const char *text) const{
+    vector<int> list;
+    for(const char *p = text; *p != 0;)
+    {
+        char *end = nullptr;
+        long value = std::strtol(p, &end, 10);
+        if(end == p){
+            p++;
+            continue;
         }
+        list.push_back((int)value);
+        p = end;
     }
+    return list;
+}
 
-    return split_strings;
+void XMLIO_backward::recordLoadTime(const std::string &filename, tbb::tick_count sta)
+{
+    double time = (tbb::tick_count::now() - sta).seconds();
+    std::lock_guard<std::mutex> lock(loadTimesMutex);
+    loadTimes[filename] = time;
 }
@@ -7,8 +7,11 @@
 
 #include <iostream>
 #include <unordered_map>
+#include <map>
+#include <mutex>
 #include <string>
 #include <pugixml.hpp>
+#include <tbb/tbb.h>
 #include "IOData.h"
 
 #if defined(GCC_VERSION_LESS_8)
@@ -30,10 +33,20 @@ public:
     bool XMLReader_CrossMesh(pugi::xml_node &xml_root, const std::string xmlFileName_path, IOData &data);
     void XMLReader_Boundary(pugi::xml_node &xml_root, IOData &data);
 
+public:
+    // the seconds spent on each file of the last project, the referenced files are loaded concurrently
+    std::map<std::string, double> loadTimes;
+
 private:
-    Vector3d readXYZ(std::string xyz_str);
+    // parse "(x,y,z)" in place, a missing coordinate is 0
+    Vector3d readXYZ(const char *xyz_str) const;
+
+    // parse a comma separated list of integers in place
+    vector<int> readIntList(const char *text) const;
+
+    void recordLoadTime(const std::string &filename, tbb::tick_count sta);
 
-    vector<std::string> split(const std::string str_text, const char separator) const;
+    std::mutex loadTimesMutex;
 
     Eigen::Matrix4d toEigenMatrix(double *interactMatrix){
         Eigen::Matrix4d interactMat;
@@ -0,0 +1,192 @@
+#include "BoundarySearch.h"
+
+template<typename Scalar>
+BoundarySearch<Scalar>::BoundarySearch(pContactGraph _graph, shared_ptr<InputVarList> varList, int _maxSetSize, int _maxResults)
+    : TopoObject(varList), graph(_graph), maxSetSize(_maxSetSize), maxResults(_maxResults), solver(_graph, varList, SIMPLEX)
+{
+    batchSize = 4 * tbb::this_task_arena::max_concurrency();
+    num_solved = num_cached = num_pruned = 0;
+    verbose = true;
+    solver.verbose = false;
+}
+
+/**
+ * @brief search the fixed sets of at most maxSetSize parts, stop after maxResults sets.
+ *        the sets are minimal: no subset of a reported set is reported.
+ * @return true if at least one set is found
+ */
+template<typename Scalar>
+bool BoundarySearch<Scalar>::search()
+{
+    tbb::tick_count sta = tbb::tick_count::now();
+
+    solutions.clear();
+    certificates.clear();
+    num_solved = num_cached = num_pruned = 0;
+
+    vector<int> parts;
+    for(auto node: graph->dynamic_nodes){
+        parts.push_back(node.lock()->staticID);
+    }
+
+    // the assembly may already interlock with its own boundary
+    CandidateResult result = evaluateCandidate(vector<int>());
+    if(result.interlocking){
+        solutions.push_back(vector<int>());
+    }
+    certificates = result.certificates;
+
+    for(int setSize = 1; setSize <= maxSetSize && solutions.size() < maxResults && !result.interlocking; setSize++)
+    {
+        vector<vector<int>> candidates;
+        listCandidates(setSize, parts, candidates);
+
+        size_t next = 0;
+        while(next < candidates.size() && solutions.size() < maxResults)
+        {
+            // the certificates found by the previous batch prune the next one
+            vector<vector<int>> batch;
+            for(; next < candidates.size() && batch.size() < batchSize; next++){
+                if(isPruned(candidates[next])) num_pruned++;
+                else batch.push_back(candidates[next]);
+            }
+
+            vector<CandidateResult> results(batch.size());
+            tbb::parallel_for(tbb::blocked_range<size_t>(0, batch.size()), [&](const tbb::blocked_range<size_t>& r)
+            {
+                for(size_t id = r.begin(); id != r.end(); ++id){
+                    results[id] = evaluateCandidate(batch[id]);
+                }
+            });
+
+            for(size_t id = 0; id < batch.size(); id++)
+            {
+                if(results[id].interlocking){
+                    if(solutions.size() < maxResults) solutions.push_back(batch[id]);
+                }
+                else{
+                    certificates.insert(certificates.end(), results[id].certificates.begin(), results[id].certificates.end());
+                }
+            }
+        }
+    }
+
+    if(verbose) std::cout << "boundary search:\t" << solutions.size() << " sets,\tsolved " << num_solved
+              << ",\tcached " << num_cached << ",\tpruned " << num_pruned
+              << ",\t" << (tbb::tick_count::now() - sta).seconds() << std::endl;
+
+    return !solutions.empty();
+}
+
+/**
+ * @brief solve the rotational interlocking LP with the fixedParts (sorted staticIDs) as boundary, or read it from the cache.
+ */
+template<typename Scalar>
+typename BoundarySearch<Scalar>::CandidateResult BoundarySearch<Scalar>::evaluateCandidate(const vector<int> &fixedParts)
+{
+    {
+        std::lock_guard<std::mutex> lock(cacheMutex);
+        auto find_it = cache.find(fixedParts);
+        if(find_it != cache.end()){
+            num_cached++;
+            return find_it->second;
+        }
+    }
+
+    vector<bool> isFixed(graph->nodes.size(), false);
+    for(int partID: fixedParts){
+        isFixed[partID] = true;
+    }
+
+    tbb::tick_count sta = tbb::tick_count::now();
+    pInterlockingData data;
+
+    CandidateResult result;
+    result.interlocking = solver.solveComponents(data, true, isFixed);
+    result.solveTime = (tbb::tick_count::now() - sta).seconds();
+
+    if(!result.interlocking && data)
+    {
+        // the motion of each component is a certificate on its own.
+        // a slow part still moves: dropping it would prune the sets which only fix it, so every nonzero motion is kept.
+        vector<DynamicComponent> components;
+        vector<int> localIDs;
+        graph->computeDynamicComponents(components, localIDs, isFixed);
+        for(const DynamicComponent &component: components)
+        {
+            vector<int> moving_parts;
+            for(int partID: component.nodeIDs){
+                double speed = data->traslation[partID].norm() + data->rotation[partID].norm();
+                if(speed > FLOAT_ERROR_SMALL) moving_parts.push_back(partID);
+            }
+            if(!moving_parts.empty()) result.certificates.push_back(moving_parts);
+        }
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(cacheMutex);
+        cache[fixedParts] = result;
+        num_solved++;
+    }
+
+    return result;
+}
+
+template<typename Scalar>
+void BoundarySearch<Scalar>::clearCache()
+{
+    std::lock_guard<std::mutex> lock(cacheMutex);
+    cache.clear();
+}
+
+template<typename Scalar>
+bool BoundarySearch<Scalar>::isPruned(const vector<int> &fixedParts)
+{
+    // a superset of a solution is not minimal
+    for(const vector<int> &solution: solutions){
+        if(std::includes(fixedParts.begin(), fixedParts.end(), solution.begin(), solution.end())) return true;
+    }
+
+    // the certificate motion is still possible if none of its parts is fixed
+    for(const vector<int> &certificate: certificates)
+    {
+        bool hit = false;
+        for(int partID: fixedParts){
+            if(std::binary_search(certificate.begin(), certificate.end(), partID)){
+                hit = true;
+                break;
+            }
+        }
+        if(!hit) return true;
+    }
+    return false;
+}
+
+/**
+ * @brief all the sorted subsets of setSize parts.
+ */
+template<typename Scalar>
+void BoundarySearch<Scalar>::listCandidates(int setSize, const vector<int> &parts, vector<vector<int>> &candidates)
+{
+    candidates.clear();
+    if(setSize > parts.size()) return;
+
+    vector<int> indices(setSize);
+    for(int id = 0; id < setSize; id++) indices[id] = id;
+
+    while(true)
+    {
+        vector<int> candidate;
+        for(int index: indices) candidate.push_back(parts[index]);
+        candidates.push_back(candidate);
+
+        // next combination
+        int id = setSize - 1;
+        while(id >= 0 && indices[id] == parts.size() - setSize + id) id--;
+        if(id < 0) break;
+        indices[id]++;
+        for(int jd = id + 1; jd < setSize; jd++) indices[jd] = indices[jd - 1] + 1;
+    }
+}
+
+template class BoundarySearch<double>;
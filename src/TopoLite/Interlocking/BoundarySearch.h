@@ -0,0 +1,80 @@
+#ifndef TOPOLITE_BOUNDARYSEARCH_H
+#define TOPOLITE_BOUNDARYSEARCH_H
+
+#include "InterlockingSolver_Clp.h"
+#include "Utility/TopoObject.h"
+
+#include <tbb/tbb.h>
+#include <vector>
+#include <map>
+#include <mutex>
+
+/**
+ * @brief Search small sets of parts which, once fixed (like the atBoundary parts), make the assembly rotationally interlocking.
+ *        The candidates are tested by size with the rotational LP of InterlockingSolver_Clp, a batch of candidates at a time in parallel.
+ *        A failed LP returns a motion of the parts; all the parts of a component with a nonzero motion form a certificate:
+ *        a set which does not fix any of these parts allows the same motion and is pruned without solving.
+ *        A set containing a solution is pruned as well, and the LP result of every tested set is cached.
+ * @tparam Scalar
+ */
+template<typename Scalar>
+class BoundarySearch : public TopoObject{
+public:
+    typedef shared_ptr<ContactGraph<Scalar>> pContactGraph;
+    typedef shared_ptr<typename InterlockingSolver<Scalar>::InterlockingData> pInterlockingData;
+    typedef typename InterlockingSolver<Scalar>::DynamicComponent DynamicComponent;
+
+public:
+
+    struct CandidateResult{
+        bool interlocking;
+        vector<vector<int>> certificates;   // the moving parts of each non-interlocking component
+        double solveTime;
+    };
+
+public:
+
+    pContactGraph graph;
+
+    int maxSetSize;
+
+    int maxResults;
+
+    int batchSize;
+
+    vector<vector<int>> solutions;          // the fixed sets found, in increasing size
+
+    int num_solved, num_cached, num_pruned; // statistics of the last search
+
+    bool verbose;                           // print the statistics of every search
+
+private:
+
+    InterlockingSolver_Clp<Scalar> solver;
+
+    vector<vector<int>> certificates;
+
+    std::map<vector<int>, CandidateResult> cache;
+
+    std::mutex cacheMutex;
+
+public:
+
+    BoundarySearch(pContactGraph _graph, shared_ptr<InputVarList> varList, int _maxSetSize = 2, int _maxResults = 10);
+
+public:
+
+    bool search();
+
+    CandidateResult evaluateCandidate(const vector<int> &fixedParts);
+
+    void clearCache();
+
+private:
+
+    bool isPruned(const vector<int> &fixedParts);
+
+    void listCandidates(int setSize, const vector<int> &parts, vector<vector<int>> &candidates);
+};
+
+#endif //TOPOLITE_BOUNDARYSEARCH_H
@@ -5,6 +5,8 @@
 
 #include "ContactGraph.h"
 #include "Utility/ConvexHull2D.h"
+#include <unordered_map>
+#include <tuple>
 
 /*************************************************
 *
@@ -88,6 +90,186 @@ bool ContactGraph<Scalar>::buildFromMeshes(const vector<pPolyMesh> &input_meshes
     return true;
 }
 
+/**
+ * @brief build the graph of a voxel assembly, part i is the label i + 1 of the grid.
+ *        Two parts touch on the unit squares between their neighboring voxels, so no polygon is clipped:
+ *        the squares are merged into strips, one edge per strip, in time linear in the number of voxels.
+ * @tparam Scalar
+ * @param grid
+ * @param atBoundary (indexed by part)
+ * @param convexhull : merges the strips of each part pair and direction by their convexhull
+ * @return
+ */
+template<typename Scalar>
+bool ContactGraph<Scalar>::buildFromVoxels(const VoxelGrid<Scalar> &grid,
+                                           vector<bool> &atBoundary,
+                                           bool convexhull)
+{
+    int numParts = grid.numParts;
+    if(atBoundary.size() < numParts || grid.labels.size() != (size_t)grid.dims[0] * grid.dims[1] * grid.dims[2])
+        return false;
+
+    // a unit square between the parts A < B, its normal points from A to B along the grid axis (dir = 2 * axis + (sign < 0))
+    // plane is the grid coordinate along the axis, the square is the cell "run" of the row "key" in the plane
+    struct VoxelFace{
+        int partA, partB;
+        int dir;
+        int plane, key, run;
+    };
+
+    // [1] - the squares of each layer, in scan order
+    vector<vector<VoxelFace>> layerFaces(grid.dims[1]);
+    tbb::parallel_for(tbb::blocked_range<int>(0, grid.dims[1]), [&](const tbb::blocked_range<int>& r)
+    {
+        for(int y = r.begin(); y != r.end(); ++y)
+        {
+            for(int z = 0; z < grid.dims[2]; z++)
+            {
+                for(int x = 0; x < grid.dims[0]; x++)
+                {
+                    int labelI = grid.labels[grid.index(x, y, z)];
+                    if(labelI == 0) continue;
+                    for(int axis = 0; axis < 3; axis++)
+                    {
+                        int labelJ = grid.label(x + (axis == 0), y + (axis == 1), z + (axis == 2));
+                        if(labelJ == 0 || labelJ == labelI || (atBoundary[labelI - 1] && atBoundary[labelJ - 1]))
+                            continue;
+
+                        VoxelFace face;
+                        face.partA = std::min(labelI, labelJ) - 1;
+                        face.partB = std::max(labelI, labelJ) - 1;
+                        face.dir = 2 * axis + (labelI < labelJ ? 0 : 1);
+                        face.plane = (axis == 0 ? x : axis == 1 ? y : z) + 1;
+                        face.key = axis == 1 ? z : y;
+                        face.run = axis == 0 ? z : x;
+                        layerFaces[y].push_back(face);
+                    }
+                }
+            }
+        }
+    });
+
+    // [2] - group the squares by (A, B, dir), the groups in increasing order and the squares in scan order
+    auto groupKey = [&](const VoxelFace &face){
+        return ((uint64_t)face.partA * numParts + face.partB) * 6 + face.dir;
+    };
+
+    std::unordered_map<uint64_t, int> groupIDs;
+    vector<uint64_t> groupKeys;
+    for(const vector<VoxelFace> &faces: layerFaces){
+        for(const VoxelFace &face: faces){
+            if(groupIDs.emplace(groupKey(face), groupKeys.size()).second) groupKeys.push_back(groupKey(face));
+        }
+    }
+    std::sort(groupKeys.begin(), groupKeys.end());
+    for(size_t id = 0; id < groupKeys.size(); id++) groupIDs[groupKeys[id]] = id;
+
+    vector<size_t> groupOffsets(groupKeys.size() + 1, 0);
+    for(const vector<VoxelFace> &faces: layerFaces){
+        for(const VoxelFace &face: faces) groupOffsets[groupIDs[groupKey(face)] + 1]++;
+    }
+    for(size_t id = 0; id < groupKeys.size(); id++) groupOffsets[id + 1] += groupOffsets[id];
+
+    vector<VoxelFace> groupFaces(groupOffsets.back());
+    {
+        vector<size_t> positions(groupOffsets.begin(), groupOffsets.end() - 1);
+        for(const vector<VoxelFace> &faces: layerFaces){
+            for(const VoxelFace &face: faces) groupFaces[positions[groupIDs[groupKey(face)]]++] = face;
+        }
+        layerFaces.clear();
+    }
+
+    // [3] - merge the consecutive squares of a row into strips
+    vector<vector<pContactGraphEdge>> groupEdges(groupKeys.size());
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, groupKeys.size()), [&](const tbb::blocked_range<size_t>& r)
+    {
+        for(size_t id = r.begin(); id != r.end(); ++id)
+        {
+            int dir = groupFaces[groupOffsets[id]].dir, axis = dir / 2;
+            Vector3 normal = VoxelGrid<Scalar>::axisDirection(axis) * (dir % 2 ? -1 : 1);
+
+            // the scan order interleaves the planes and rows of the x and z faces, a row must be contiguous to be merged
+            std::sort(groupFaces.begin() + groupOffsets[id], groupFaces.begin() + groupOffsets[id + 1], [](const VoxelFace &a, const VoxelFace &b){
+                return std::tie(a.plane, a.key, a.run) < std::tie(b.plane, b.key, b.run);
+            });
+
+            // (plane, key, run begin, run end)
+            vector<Eigen::Vector4i> strips;
+            for(size_t jd = groupOffsets[id]; jd < groupOffsets[id + 1]; jd++){
+                const VoxelFace &face = groupFaces[jd];
+                if(!strips.empty() && strips.back()[0] == face.plane && strips.back()[1] == face.key && strips.back()[3] == face.run){
+                    strips.back()[3]++;
+                }
+                else{
+                    strips.push_back(Eigen::Vector4i(face.plane, face.key, face.run, face.run + 1));
+                }
+            }
+
+            for(const Eigen::Vector4i &strip: strips)
+            {
+                vector<Vector3> corners;
+                for(int kd = 0; kd < 4; kd++)
+                {
+                    int key = strip[1] + (kd == 1 || kd == 2), run = kd < 2 ? strip[2] : strip[3];
+                    if(axis == 0) corners.push_back(grid.position(strip[0], key, run));
+                    else if(axis == 1) corners.push_back(grid.position(run, strip[0], key));
+                    else corners.push_back(grid.position(run, key, strip[0]));
+                }
+                if((corners[1] - corners[0]).cross(corners[2] - corners[0]).dot(normal) < 0){
+                    std::reverse(corners.begin(), corners.end());
+                }
+
+                pPolygon contactPoly = make_shared<_Polygon<Scalar>>();
+                contactPoly->setVertices(corners);
+                groupEdges[id].push_back(make_shared<ContactGraphEdge<Scalar>>(contactPoly, normal));
+            }
+        }
+    });
+
+    // [4] - add the parts into the graph, their volume and center of mass come from the voxel count
+    vector<size_t> counts(numParts, 0);
+    vector<Vector3> sums(numParts, Vector3(0, 0, 0));
+    for(int y = 0; y < grid.dims[1]; y++){
+        for(int z = 0; z < grid.dims[2]; z++){
+            for(int x = 0; x < grid.dims[0]; x++){
+                int label = grid.labels[grid.index(x, y, z)];
+                if(label == 0) continue;
+                counts[label - 1]++;
+                sums[label - 1] += Vector3(x + 0.5, y + 0.5, -(z + 0.5));
+            }
+        }
+    }
+
+    meshes_input.clear();
+    nodes.clear();
+    for(int id = 0; id < numParts; id++)
+    {
+        Vector3 centroid = grid.origin;
+        if(counts[id] > 0) centroid += sums[id] / counts[id] * grid.voxelSize;
+        Scalar volume = counts[id] * grid.voxelSize * grid.voxelSize * grid.voxelSize;
+        pContactGraphNode node = make_shared<ContactGraphNode<Scalar>>(atBoundary[id], centroid, centroid, volume);
+        addNode(node);
+    }
+
+    // [5] - add the strips into the graph
+    edges.clear();
+    for(size_t id = 0; id < groupKeys.size(); id++){
+        const VoxelFace &face = groupFaces[groupOffsets[id]];
+        for(pContactGraphEdge edge: groupEdges[id]){
+            addContact(nodes[face.partA], nodes[face.partB], edge);
+        }
+    }
+
+    // [6] - assign node ID
+    finalize();
+    contact_edges = edges;
+
+    // [7] - simplify contacts
+    if(convexhull) computeConvexHullofEdgePolygons();
+
+    return true;
+}
+
 /*************************************************
 *
 *                  Graph Operation
@@ -162,6 +344,88 @@ void ContactGraph<Scalar>::finalize() {
     }
 }
 
+/**
+ * @brief split the dynamic nodes into connected components.
+ *        two dynamic nodes are connected if they share a contact or are merged.
+ *        boundary nodes never move, so they act as cut points and belong to no component.
+ * @tparam Scalar
+ * @param components the components, ordered by their smallest staticID
+ * @param localIDs for each node (indexed by staticID), its index inside the nodeIDs of its component; -1 for boundary nodes
+ * @param isFixed (optional, indexed by staticID) the dynamic nodes which are known to be immobile, they are treated as boundary nodes
+ * @return the number of components
+ */
+template<typename Scalar>
+int ContactGraph<Scalar>::computeDynamicComponents(vector<DynamicComponent> &components, vector<int> &localIDs, const vector<bool> &isFixed)
+{
+    auto is_fixed = [&](int id){
+        return nodes[id]->isBoundary || (!isFixed.empty() && isFixed[id]);
+    };
+
+    // union-find over the staticIDs
+    vector<int> parents(nodes.size());
+    for(int id = 0; id < nodes.size(); id++) parents[id] = id;
+
+    auto find_root = [&](int id){
+        while(parents[id] != id){
+            parents[id] = parents[parents[id]];
+            id = parents[id];
+        }
+        return id;
+    };
+
+    auto unite = [&](int iA, int iB){
+        if(is_fixed(iA) || is_fixed(iB)) return;
+        iA = find_root(iA);
+        iB = find_root(iB);
+        if(iA < iB) parents[iB] = iA;
+        else if(iB < iA) parents[iA] = iB;
+    };
+
+    for(pContactGraphEdge edge: edges){
+        unite(edge->partIDA, edge->partIDB);
+    }
+
+    for(std::pair<wpContactGraphNode, wpContactGraphNode> &merge: merged_nodes){
+        unite(merge.first.lock()->staticID, merge.second.lock()->staticID);
+    }
+
+    // the root is the smallest staticID of its component, so components are created in order
+    components.clear();
+    localIDs.assign(nodes.size(), -1);
+    vector<int> componentIDs(nodes.size(), -1);
+    for(int id = 0; id < nodes.size(); id++)
+    {
+        if(is_fixed(id)) continue;
+        int root = find_root(id);
+        if(root == id){
+            componentIDs[id] = components.size();
+            components.push_back(DynamicComponent());
+        }
+        else{
+            componentIDs[id] = componentIDs[root];
+        }
+        DynamicComponent &component = components[componentIDs[id]];
+        localIDs[id] = component.nodeIDs.size();
+        component.nodeIDs.push_back(id);
+    }
+
+    for(int id = 0; id < edges.size(); id++){
+        int iA = componentIDs[edges[id]->partIDA];
+        int iB = componentIDs[edges[id]->partIDB];
+        if(iA != -1) components[iA].edgeIDs.push_back(id);
+        else if(iB != -1) components[iB].edgeIDs.push_back(id);
+    }
+
+    for(int id = 0; id < merged_nodes.size(); id++){
+        int iA = componentIDs[merged_nodes[id].first.lock()->staticID];
+        int iB = componentIDs[merged_nodes[id].second.lock()->staticID];
+        if(iA != -1) components[iA].mergeIDs.push_back(id);
+        else if(iB != -1) components[iB].mergeIDs.push_back(id);
+    }
+
+    return components.size();
+}
+
 
 
 
@@ -314,45 +578,65 @@ template<typename Scalar>
 void ContactGraph<Scalar>::computeContacts()
 {
     size_t psize = contact_pairs.size();
+    contact_graphedges.clear();
     contact_graphedges.resize(psize);
+
+    // [1] - intersect the face pairs, each thread reuses its boolean context and appends the contacts into its flat buffers
+    tbb::enumerable_thread_specific<ContactContext> contexts([&](){
+        return ContactContext(getVarList());
+    });
+
     //for (size_t id = 0; id < psize; ++id) // Sequential loop
     tbb::parallel_for(tbb::blocked_range<size_t>(0, psize), [&](const tbb::blocked_range<size_t> &r)
     {
+        ContactContext &context = contexts.local();
         for (size_t id = r.begin(); id != r.end(); ++id) {
 
-
             int planeI = contact_pairs[id].first;
             int planeJ = contact_pairs[id].second;
 
-            vector<Vector3> polyI = contact_faces[planeI].polygon.lock()->getVertices();
-            vector<Vector3> polyJ = contact_faces[planeJ].polygon.lock()->getVertices();
-
-            vector<vector<Vector3>> contactPtLists;
-
-            PolyPolyBoolean<Scalar> ppIntersec(getVarList());
+            for(auto face : {std::make_pair(planeI, &context.polyI), std::make_pair(planeJ, &context.polyJ)})
+            {
+                pPolygon poly = contact_faces[face.first].polygon.lock();
+                vector<Vector3> &vertices = *face.second;
+                vertices.resize(poly->vers.size());
+                for(size_t jd = 0; jd < poly->vers.size(); jd++){
+                    vertices[jd] = poly->vers[jd]->pos;
+                }
+            }
 
-            ppIntersec.computePolygonsIntersection(polyI, polyJ, contactPtLists);
-            if (contactPtLists.empty())
+            size_t num_polys = context.polyOffsets.size();
+            context.ppIntersec.computePolygonsIntersection(context.polyI, context.polyJ, context.points, context.polyOffsets);
+            if (context.polyOffsets.size() > num_polys)
             {
-                continue;
+                context.pairIDs.push_back(id);
+                context.pairOffsets.push_back(context.polyOffsets.size() - 1);
             }
+        }
+    });
 
-            vector<pPolygon> contactPolys;
-            for (vector<Vector3> contactPtList: contactPtLists)
+    // [2] - only the pairs in contact create polygons
+    for(ContactContext &context : contexts)
+    {
+        tbb::parallel_for(tbb::blocked_range<size_t>(0, context.pairIDs.size()), [&](const tbb::blocked_range<size_t> &r)
+        {
+            for (size_t id = r.begin(); id != r.end(); ++id)
             {
-                if (contactPtList.size() >= 3) {
+                vector<pPolygon> contactPolys;
+                for(size_t jd = context.pairOffsets[id]; jd < context.pairOffsets[id + 1]; jd++)
+                {
                     pPolygon contactPoly = make_shared<_Polygon<Scalar>>();
-                    contactPoly->setVertices(contactPtList);
+                    contactPoly->setVertices(vector<Vector3>(context.points.begin() + context.polyOffsets[jd],
+                                                             context.points.begin() + context.polyOffsets[jd + 1]));
                     contactPolys.push_back(contactPoly);
                 }
-            }
 
-            if (!contactPolys.empty())
-            {
-                contact_graphedges[id] = make_shared<ContactGraphEdge<Scalar>>(contactPolys, contact_faces[planeI].nrm);
+                int pairID = context.pairIDs[id];
+                int planeI = contact_pairs[pairID].first;
+                contact_graphedges[pairID] = make_shared<ContactGraphEdge<Scalar>>(contactPolys, contact_faces[planeI].nrm);
             }
-        }
-    });
+        });
+    }
 }
 
 /**
@@ -399,7 +683,8 @@ void ContactGraph<Scalar>::buildEdges() {
 template<typename Scalar>
 void ContactGraph<Scalar>::computeConvexHullofEdgePolygons()
 {
-    std::sort(contact_edges.begin(), contact_edges.end(), [&](pContactGraphEdge e0, pContactGraphEdge e1){
+    // [1] - group the edges by (partIDA, partIDB, plane)
+    tbb::parallel_sort(contact_edges.begin(), contact_edges.end(), [&](const pContactGraphEdge &e0, const pContactGraphEdge &e1){
         if(e0->partIDA < e1->partIDA)
             return true;
         if(e0->partIDA > e1->partIDA)
@@ -428,49 +713,83 @@ void ContactGraph<Scalar>::computeConvexHullofEdgePolygons()
         return false;
     });
 
-
-    edges.clear();
+    vector<size_t> group_offsets;
     size_t sta = 0, end = 0;
-
     while (sta < contact_edges.size()) {
+        group_offsets.push_back(sta);
         for (end = sta + 1; end < contact_edges.size(); end++) {
             if(!contact_edges[sta]->check_on_same_plane(contact_edges[end])){
                 break;
             }
         }
+        sta = end;
+    }
+    group_offsets.push_back(contact_edges.size());
+
+    // [2] - merge each group into the 2D convex hull of its corner points
+    struct HullScratch{
+        vector<Vector2> points2D;
+        vector<Vector2> hull2D;
+    };
+    tbb::enumerable_thread_specific<HullScratch> scratches;
 
-        pContactGraphEdge edge;
-        if(end > sta + 1)
+    size_t num_groups = group_offsets.size() - 1;
+    edges.clear();
+    edges.resize(num_groups);
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, num_groups), [&](const tbb::blocked_range<size_t> &r)
+    {
+        HullScratch &scratch = scratches.local();
+        ConvexHull2D<Scalar> convexhull_solver;
+        for (size_t id = r.begin(); id != r.end(); ++id)
         {
-            vector<Vector3> corner_points;
-            for(int id = sta; id < end; id++)
+            size_t group_sta = group_offsets[id], group_end = group_offsets[id + 1];
+            pContactGraphEdge edge;
+            if(group_end > group_sta + 1)
             {
-                for(pPolygon poly: contact_edges[id]->polygons){
-                    vector<Vector3> poly_points = poly->getVertices();
-                    corner_points.insert(corner_points.end(), poly_points.begin(), poly_points.end());
+                // project the corner points into the plane frame
+                Vector3 center(0, 0, 0);
+                int num_points = 0;
+                for(size_t jd = group_sta; jd < group_end; jd++){
+                    for(const pPolygon &poly: contact_edges[jd]->polygons){
+                        for(const pVertex &vertex: poly->vers) center += vertex->pos;
+                        num_points += poly->vers.size();
+                    }
                 }
-            }
+                center /= num_points;
 
-            Vector3 normal = contact_edges[sta]->normal, x_axis, y_axis;
+                Vector3 normal = contact_edges[group_sta]->normal, x_axis, y_axis;
+                convexhull_solver.computeFrame(normal, x_axis, y_axis);
 
-            vector<Vector3> convexhull_points;
-            ConvexHull2D<Scalar> convexhull_solver;
-            convexhull_solver.compute(corner_points, normal, convexhull_points);
+                scratch.points2D.clear();
+                for(size_t jd = group_sta; jd < group_end; jd++){
+                    for(const pPolygon &poly: contact_edges[jd]->polygons){
+                        for(const pVertex &vertex: poly->vers){
+                            scratch.points2D.push_back(Vector2((vertex->pos - center).dot(x_axis), (vertex->pos - center).dot(y_axis)));
+                        }
+                    }
+                }
 
-            pPolygon convexhull_poly = make_shared<_Polygon<Scalar>>();
-            convexhull_poly->setVertices(convexhull_points);
+                convexhull_solver.compute(scratch.points2D, scratch.hull2D);
 
-            edge = make_shared<ContactGraphEdge<Scalar>>(convexhull_poly , contact_edges[sta]->normal);
-        }
-        else{
-            edge = make_shared<ContactGraphEdge<Scalar>>(contact_edges[sta]->polygons, contact_edges[sta]->normal);
-        }
+                vector<Vector3> convexhull_points;
+                for(const Vector2 &pt: scratch.hull2D){
+                    convexhull_points.push_back(pt[0] * x_axis + pt[1] * y_axis + center);
+                }
 
-        edge->partIDA = contact_edges[sta]->partIDA;
-        edge->partIDB = contact_edges[sta]->partIDB;
-        edges.push_back(edge);
-        sta = end;
-    }
+                pPolygon convexhull_poly = make_shared<_Polygon<Scalar>>();
+                convexhull_poly->setVertices(convexhull_points);
+
+                edge = make_shared<ContactGraphEdge<Scalar>>(convexhull_poly, contact_edges[group_sta]->normal);
+            }
+            else{
+                edge = make_shared<ContactGraphEdge<Scalar>>(contact_edges[group_sta]->polygons, contact_edges[group_sta]->normal);
+            }
+
+            edge->partIDA = contact_edges[group_sta]->partIDA;
+            edge->partIDB = contact_edges[group_sta]->partIDB;
+            edges[id] = edge;
+        }
+    });
 }
 
 // No need to call this TemporaryFunction() function,
@@ -482,7 +801,11 @@ void TemporaryFunction_ContactGraph ()
     vector<shared_ptr<PolyMesh<double>>> polyMesh;
     vector<bool> atBoundary;
     contactGraph.buildFromMeshes(polyMesh, atBoundary);
+    contactGraph.buildFromVoxels(VoxelGrid<double>(varList), atBoundary);
     contactGraph.mergeNode(nullptr, nullptr);
+    vector<ContactGraph<double>::DynamicComponent> components;
+    vector<int> localIDs;
+    contactGraph.computeDynamicComponents(components, localIDs);
     contactGraph.getContactMesh(polyMesh.front());
 }
 template class ContactGraph<double>;
@@ -7,6 +7,7 @@
 
 #include "ContactGraphNode.h"
 #include "Mesh/PolyMesh.h"
+#include "Mesh/VoxelGrid.h"
 #include "Utility/TopoObject.h"
 #include "Utility/PolyPolyBoolean.h"
 
@@ -36,8 +37,12 @@ public:
 
     typedef weak_ptr<_Polygon<Scalar>> wpPolygon;
 
+    typedef shared_ptr<VPoint<Scalar>> pVertex;
+
     typedef Matrix<Scalar, 3, 1> Vector3;
 
+    typedef Matrix<Scalar, 2, 1> Vector2;
+
     typedef shared_ptr<PolyMesh<Scalar>> pPolyMesh;
 
 public:
@@ -82,6 +87,35 @@ public:
         }
     };
 
+    /**
+     * @brief per-thread context of computeContacts, reused for all the face pairs handled by the thread.
+     *        the contacts are stored flat: the k-th contact pair is pairIDs[k],
+     *        it owns the polygons [pairOffsets[k], pairOffsets[k + 1]) and polygon p owns the points [polyOffsets[p], polyOffsets[p + 1]).
+     */
+    struct ContactContext{
+        PolyPolyBoolean<Scalar> ppIntersec;
+        vector<Vector3> polyI, polyJ;
+        vector<int> pairIDs;
+        vector<size_t> pairOffsets;
+        vector<size_t> polyOffsets;
+        vector<Vector3> points;
+
+        ContactContext(const shared_ptr<InputVarList> &varList): ppIntersec(varList){
+            pairOffsets.push_back(0);
+            polyOffsets.push_back(0);
+        }
+    };
+
+    /**
+     * @brief a connected component of the dynamic nodes.
+     *        boundary nodes are fixed, so they do not connect the components they touch.
+     */
+    struct DynamicComponent{
+        vector<int> nodeIDs;    // staticIDs of the dynamic nodes, in increasing order
+        vector<int> edgeIDs;    // the edges which have at least one node in the component
+        vector<int> mergeIDs;   // the merged_nodes which have at least one node in the component
+    };
+
 public:
     vector<pContactGraphNode> nodes;
     vector<pContactGraphEdge> edges;
@@ -111,6 +145,10 @@ public:
                          Scalar eps = 0.002,
                          bool convexhull = true);
 
+    bool buildFromVoxels(const VoxelGrid<Scalar> &grid,
+                         vector<bool> &atBoundary,
+                         bool convexhull = true);
+
 public:
 
     /*************************************************
@@ -127,6 +165,8 @@ public:
 
     void finalize();
 
+    int computeDynamicComponents(vector<DynamicComponent> &components, vector<int> &localIDs, const vector<bool> &isFixed = vector<bool>());
+
     void getContactMesh(pPolyMesh &mesh);
 
 private:
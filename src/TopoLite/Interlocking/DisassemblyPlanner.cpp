@@ -0,0 +1,306 @@
+#include "DisassemblyPlanner.h"
+
+template<typename Scalar>
+DisassemblyPlanner<Scalar>::DisassemblyPlanner(pContactGraph _graph, shared_ptr<InputVarList> varList, int _maxGroupSize)
+    : TopoObject(varList), graph(_graph), maxGroupSize(_maxGroupSize), solver(_graph, varList, SIMPLEX)
+{
+    verbose = true;
+    solver.verbose = false;
+}
+
+/**
+ * @brief compute the disassembly sequence
+ * @param unlockedParts the parts (e.g. the key) which are taken out first, whatever their contacts
+ * @return true if every non-boundary part could be removed, otherwise the rest is listed in blockedParts
+ */
+template<typename Scalar>
+bool DisassemblyPlanner<Scalar>::computeSequence(const vector<int> &unlockedParts)
+{
+    tbb::tick_count sta = tbb::tick_count::now();
+
+    sequence.clear();
+    blockedParts.clear();
+
+    computeUnits();
+
+    removed.assign(graph->nodes.size(), false);
+    incidentEdges.clear();
+    incidentEdges.resize(graph->nodes.size());
+    for(int id = 0; id < graph->edges.size(); id++){
+        incidentEdges[graph->edges[id]->partIDA].push_back(id);
+        incidentEdges[graph->edges[id]->partIDB].push_back(id);
+    }
+
+    // a blocked unit stays blocked until one of its neighbors is removed
+    vector<char> needsUpdate(units.size(), true);
+
+    auto is_removed = [&](int unitID){
+        return (bool)removed[units[unitID].front()];
+    };
+
+    MobilityResult unlocked = {true, Vector3(0, 0, 0), 0};
+    for(int partID: unlockedParts){
+        int unitID = unitIDs[partID];
+        if(unitID != -1 && !is_removed(unitID)){
+            removeUnits({unitID}, unlocked, 0, needsUpdate);
+        }
+    }
+
+    int round = 0;
+    while(true)
+    {
+        // [1] - the single units
+        vector<vector<int>> candidates;
+        for(int id = 0; id < units.size(); id++){
+            if(!is_removed(id) && needsUpdate[id]){
+                candidates.push_back({id});
+                needsUpdate[id] = false;
+            }
+        }
+
+        bool all_removed = true;
+        for(int id = 0; id < units.size(); id++){
+            if(!is_removed(id)) all_removed = false;
+        }
+        if(all_removed) break;
+
+        round++;
+        vector<MobilityResult> results;
+        evaluateCandidates(candidates, results);
+
+        bool found = false;
+        for(int id = 0; id < candidates.size(); id++){
+            if(results[id].removable){
+                // removing parts only drops constraints, so the other removable units stay removable
+                removeUnits(candidates[id], results[id], round, needsUpdate);
+                found = true;
+            }
+        }
+        if(found) continue;
+
+        // [2] - the groups of connected units
+        for(int groupSize = 2; groupSize <= maxGroupSize && !found; groupSize++)
+        {
+            listGroupCandidates(groupSize, candidates);
+            evaluateCandidates(candidates, results);
+            for(int id = 0; id < candidates.size(); id++)
+            {
+                if(!results[id].removable) continue;
+
+                bool overlapped = false;
+                for(int unitID: candidates[id]){
+                    if(is_removed(unitID)) overlapped = true;
+                }
+                if(overlapped) continue;
+
+                removeUnits(candidates[id], results[id], round, needsUpdate);
+                found = true;
+            }
+        }
+
+        if(!found) break;
+    }
+
+    for(int id = 0; id < units.size(); id++){
+        if(!is_removed(id)){
+            blockedParts.insert(blockedParts.end(), units[id].begin(), units[id].end());
+        }
+    }
+
+    if(verbose) std::cout << "disassembly:\t" << sequence.size() << " steps,\t" << round << " rounds,\t"
+                          << blockedParts.size() << " blocked parts,\t" << (tbb::tick_count::now() - sta).seconds() << std::endl;
+
+    return blockedParts.empty();
+}
+
+/**
+ * @brief the translational mobility of the parts moving together, all the other remaining parts are fixed.
+ * @param localIDs a vector of -1 indexed by staticID, used as scratch and restored on return
+ */
+template<typename Scalar>
+typename DisassemblyPlanner<Scalar>::MobilityResult
+DisassemblyPlanner<Scalar>::computeMobility(const vector<int> &partIDs, vector<int> &localIDs)
+{
+    // the group shares the velocity columns of its first part
+    DynamicComponent component;
+    component.nodeIDs.push_back(partIDs.front());
+    for(int partID: partIDs){
+        localIDs[partID] = 0;
+    }
+
+    for(int partID: partIDs){
+        for(int edgeID: incidentEdges[partID]){
+            shared_ptr<ContactGraphEdge<Scalar>> edge = graph->edges[edgeID];
+            int otherID = (edge->partIDA == partID) ? edge->partIDB : edge->partIDA;
+            if(localIDs[otherID] == 0 || removed[otherID]) continue;
+            component.edgeIDs.push_back(edgeID);
+        }
+    }
+
+    tbb::tick_count sta = tbb::tick_count::now();
+    Eigen::VectorXd solution;
+    bool interlocking = solver.solveComponent(component, localIDs, false, solution);
+
+    MobilityResult result;
+    result.solveTime = (tbb::tick_count::now() - sta).seconds();
+    result.removable = !interlocking;
+    result.direction = Vector3(0, 0, 0);
+    if(result.removable && solution.size() >= 3){
+        Vector3 velocity = solution.head(3);
+        if(velocity.norm() > FLOAT_ERROR_SMALL){
+            result.direction = velocity.normalized();
+        }
+    }
+
+    for(int partID: partIDs){
+        localIDs[partID] = -1;
+    }
+
+    return result;
+}
+
+template<typename Scalar>
+void DisassemblyPlanner<Scalar>::computeUnits()
+{
+    int num_nodes = graph->nodes.size();
+
+    // union-find over the merged nodes
+    vector<int> parents(num_nodes);
+    for(int id = 0; id < num_nodes; id++) parents[id] = id;
+    auto find_root = [&](int id){
+        while(parents[id] != id){
+            parents[id] = parents[parents[id]];
+            id = parents[id];
+        }
+        return id;
+    };
+    for(auto &merge: graph->merged_nodes){
+        int iA = find_root(merge.first.lock()->staticID);
+        int iB = find_root(merge.second.lock()->staticID);
+        if(iA != iB) parents[std::max(iA, iB)] = std::min(iA, iB);
+    }
+
+    // a unit merged with a boundary node never moves
+    vector<bool> fixed(num_nodes, false);
+    for(int id = 0; id < num_nodes; id++){
+        if(graph->nodes[id]->isBoundary) fixed[find_root(id)] = true;
+    }
+
+    units.clear();
+    unitIDs.assign(num_nodes, -1);
+    vector<int> rootUnitIDs(num_nodes, -1);
+    for(int id = 0; id < num_nodes; id++){
+        int root = find_root(id);
+        if(fixed[root]) continue;
+        if(rootUnitIDs[root] == -1){
+            rootUnitIDs[root] = units.size();
+            units.push_back(vector<int>());
+        }
+        unitIDs[id] = rootUnitIDs[root];
+        units[unitIDs[id]].push_back(id);
+    }
+}
+
+template<typename Scalar>
+void DisassemblyPlanner<Scalar>::listUnitNeighbors(int unitID, vector<int> &neighbors)
+{
+    neighbors.clear();
+    for(int partID: units[unitID]){
+        for(int edgeID: incidentEdges[partID]){
+            shared_ptr<ContactGraphEdge<Scalar>> edge = graph->edges[edgeID];
+            int otherID = (edge->partIDA == partID) ? edge->partIDB : edge->partIDA;
+            int otherUnitID = unitIDs[otherID];
+            if(otherUnitID == -1 || otherUnitID == unitID || removed[otherID]) continue;
+            neighbors.push_back(otherUnitID);
+        }
+    }
+    std::sort(neighbors.begin(), neighbors.end());
+    neighbors.erase(std::unique(neighbors.begin(), neighbors.end()), neighbors.end());
+}
+
+/**
+ * @brief list the connected groups of groupSize remaining units, by growing the groups one neighbor at a time.
+ */
+template<typename Scalar>
+void DisassemblyPlanner<Scalar>::listGroupCandidates(int groupSize, vector<vector<int>> &candidates)
+{
+    vector<vector<int>> neighbors(units.size());
+    std::set<vector<int>> groups;
+    for(int id = 0; id < units.size(); id++){
+        if(removed[units[id].front()]) continue;
+        listUnitNeighbors(id, neighbors[id]);
+        groups.insert({id});
+    }
+
+    for(int size = 2; size <= groupSize; size++)
+    {
+        std::set<vector<int>> larger_groups;
+        for(const vector<int> &group: groups){
+            for(int unitID: group){
+                for(int neighborID: neighbors[unitID]){
+                    if(std::find(group.begin(), group.end(), neighborID) != group.end()) continue;
+                    vector<int> larger_group = group;
+                    larger_group.insert(std::upper_bound(larger_group.begin(), larger_group.end(), neighborID), neighborID);
+                    larger_groups.insert(larger_group);
+                }
+            }
+        }
+        groups.swap(larger_groups);
+    }
+
+    candidates.assign(groups.begin(), groups.end());
+}
+
+template<typename Scalar>
+void DisassemblyPlanner<Scalar>::evaluateCandidates(const vector<vector<int>> &candidates, vector<MobilityResult> &results)
+{
+    results.resize(candidates.size());
+
+    tbb::enumerable_thread_specific<vector<int>> localIDs([&](){
+        return vector<int>(graph->nodes.size(), -1);
+    });
+
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, candidates.size()), [&](const tbb::blocked_range<size_t>& r)
+    {
+        vector<int> &local = localIDs.local();
+        vector<int> partIDs;
+        for(size_t id = r.begin(); id != r.end(); ++id)
+        {
+            partIDs.clear();
+            for(int unitID: candidates[id]){
+                partIDs.insert(partIDs.end(), units[unitID].begin(), units[unitID].end());
+            }
+            results[id] = computeMobility(partIDs, local);
+        }
+    });
+}
+
+template<typename Scalar>
+void DisassemblyPlanner<Scalar>::removeUnits(const vector<int> &groupUnits,
+                                             const MobilityResult &result,
+                                             int round,
+                                             vector<char> &needsUpdate)
+{
+    DisassemblyStep step;
+    step.direction = result.direction;
+    step.solveTime = result.solveTime;
+    step.round = round;
+
+    vector<int> neighbors;
+    for(int unitID: groupUnits)
+    {
+        listUnitNeighbors(unitID, neighbors);
+        for(int neighborID: neighbors){
+            needsUpdate[neighborID] = true;
+        }
+
+        for(int partID: units[unitID]){
+            removed[partID] = true;
+            step.partIDs.push_back(partID);
+        }
+    }
+
+    sequence.push_back(step);
+}
+
+template class DisassemblyPlanner<double>;
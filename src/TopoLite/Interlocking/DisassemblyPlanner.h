@@ -0,0 +1,90 @@
+#ifndef TOPOLITE_DISASSEMBLYPLANNER_H
+#define TOPOLITE_DISASSEMBLYPLANNER_H
+
+#include "InterlockingSolver_Clp.h"
+#include "Utility/TopoObject.h"
+
+#include <tbb/tbb.h>
+#include <vector>
+#include <set>
+
+/**
+ * @brief Plan a translational disassembly sequence of a contact graph.
+ *        At every step, the remaining parts which can translate alone while all the other remaining parts stay fixed are removed.
+ *        If none can, connected groups of up to maxGroupSize parts translating together are tested.
+ *        The mobility of a part/group is the translational interlocking LP of InterlockingSolver_Clp restricted to it,
+ *        the LPs of one step are solved concurrently.
+ *        Merged nodes are always removed together, boundary nodes are never removed.
+ *        Only the local (infinitesimal) freedom is checked, far-field collisions are ignored.
+ * @tparam Scalar
+ */
+template<typename Scalar>
+class DisassemblyPlanner : public TopoObject{
+public:
+    typedef shared_ptr<ContactGraph<Scalar>> pContactGraph;
+    typedef typename InterlockingSolver<Scalar>::Vector3 Vector3;
+    typedef typename InterlockingSolver<Scalar>::DynamicComponent DynamicComponent;
+
+public:
+
+    struct DisassemblyStep{
+        vector<int> partIDs;        // staticIDs of the parts removed together
+        Vector3 direction;          // unit translation which takes them out (zero for the unlocked parts)
+        double solveTime;           // seconds spent in the mobility LP of these parts
+        int round;                  // the LP round which found them
+    };
+
+    struct MobilityResult{
+        bool removable;
+        Vector3 direction;
+        double solveTime;
+    };
+
+public:
+
+    pContactGraph graph;
+
+    int maxGroupSize;
+
+    vector<DisassemblyStep> sequence;
+
+    vector<int> blockedParts;       // the parts left when the planner gets stuck
+
+    bool verbose;                   // print the statistics of every sequence
+
+private:
+
+    InterlockingSolver_Clp<Scalar> solver;
+
+    vector<int> unitIDs;            // the unit of each node, merged nodes share a unit; -1 for boundary nodes
+
+    vector<vector<int>> units;      // the nodes of each unit
+
+    vector<vector<int>> incidentEdges;
+
+    vector<bool> removed;           // indexed by staticID
+
+public:
+
+    DisassemblyPlanner(pContactGraph _graph, shared_ptr<InputVarList> varList, int _maxGroupSize = 2);
+
+public:
+
+    bool computeSequence(const vector<int> &unlockedParts = vector<int>());
+
+    MobilityResult computeMobility(const vector<int> &partIDs, vector<int> &localIDs);
+
+private:
+
+    void computeUnits();
+
+    void listUnitNeighbors(int unitID, vector<int> &neighbors);
+
+    void listGroupCandidates(int groupSize, vector<vector<int>> &candidates);
+
+    void removeUnits(const vector<int> &groupUnits, const MobilityResult &result, int round, vector<char> &needsUpdate);
+
+    void evaluateCandidates(const vector<vector<int>> &candidates, vector<MobilityResult> &results);
+};
+
+#endif //TOPOLITE_DISASSEMBLYPLANNER_H
@@ -3,6 +3,9 @@
 //
 
 #include "InterlockingSolver.h"
+#include "Utility/ConvexHull2D.h"
+#include <Eigen/SparseQR>
+#include <tbb/tbb.h>
 
 /*************************************************
 *
@@ -171,14 +174,55 @@ void InterlockingSolver<Scalar>::get_A_j_k(int partID, int edgeID, Eigen::Matrix
 
 template<typename Scalar>
 void InterlockingSolver<Scalar>::computeTranslationalInterlockingMatrix(vector<EigenTriple> &tri, Eigen::Vector2i &size)
+{
+    DynamicComponent component;
+    vector<int> localIDs;
+    computeWholeGraphComponent(component, localIDs);
+    computeTranslationalInterlockingMatrix(component, localIDs, tri, size);
+}
+
+template<typename Scalar>
+void InterlockingSolver<Scalar>::computeRotationalInterlockingMatrix(vector<EigenTriple> &tri, Eigen::Vector2i &size)
+{
+    DynamicComponent component;
+    vector<int> localIDs;
+    computeWholeGraphComponent(component, localIDs);
+    computeRotationalInterlockingMatrix(component, localIDs, tri, size);
+}
+
+template<typename Scalar>
+void InterlockingSolver<Scalar>::computeWholeGraphComponent(DynamicComponent &component, vector<int> &localIDs)
+{
+    component = DynamicComponent();
+    localIDs.clear();
+    for(shared_ptr<ContactGraphNode<Scalar>> node: graph->nodes){
+        localIDs.push_back(node->dynamicID);
+    }
+    for(wpContactGraphNode node: graph->dynamic_nodes){
+        component.nodeIDs.push_back(node.lock()->staticID);
+    }
+    for(int id = 0; id < graph->edges.size(); id++){
+        component.edgeIDs.push_back(id);
+    }
+    for(int id = 0; id < graph->merged_nodes.size(); id++){
+        component.mergeIDs.push_back(id);
+    }
+}
+
+template<typename Scalar>
+void InterlockingSolver<Scalar>::computeTranslationalInterlockingMatrix(const DynamicComponent &component,
+                                                                        const vector<int> &localIDs,
+                                                                        vector<EigenTriple> &tri,
+                                                                        Eigen::Vector2i &size)
 {
     int rowID = 0;
     tri.clear();
-    for(shared_ptr<ContactGraphEdge<Scalar>> edge: graph->edges) {
+    for(int edgeID: component.edgeIDs) {
+        shared_ptr<ContactGraphEdge<Scalar>> edge = graph->edges[edgeID];
 
-        int iA = graph->nodes[edge->partIDA]->dynamicID;
+        int iA = localIDs[edge->partIDA];
 
-        int iB = graph->nodes[edge->partIDB]->dynamicID;
+        int iB = localIDs[edge->partIDB];
 
         Vector3 nrm = (edge->normal).template cast<double>();
         for (size_t id = 0; id < edge->size(); id++) {
@@ -196,21 +240,25 @@ void InterlockingSolver<Scalar>::computeTranslationalInterlockingMatrix(vector<E
             rowID++;
         }
     }
-    size = Eigen::Vector2i(rowID, 3 * graph->dynamic_nodes.size());
+    size = Eigen::Vector2i(rowID, 3 * component.nodeIDs.size());
 }
 
 template<typename Scalar>
-void InterlockingSolver<Scalar>::computeRotationalInterlockingMatrix(vector<EigenTriple> &tri, Eigen::Vector2i &size)
+void InterlockingSolver<Scalar>::computeRotationalInterlockingMatrix(const DynamicComponent &component,
+                                                                     const vector<int> &localIDs,
+                                                                     vector<EigenTriple> &tri,
+                                                                     Eigen::Vector2i &size)
 {
     int rowID = 0;
     tri.clear();
-    for(shared_ptr<ContactGraphEdge<Scalar>> edge: graph->edges)
+    for(int edgeID: component.edgeIDs)
     {
+        shared_ptr<ContactGraphEdge<Scalar>> edge = graph->edges[edgeID];
         shared_ptr<ContactGraphNode<Scalar>> nodeA = graph->nodes[edge->partIDA];
         shared_ptr<ContactGraphNode<Scalar>> nodeB = graph->nodes[edge->partIDB];
 
-        int iA = nodeA->dynamicID;
-        int iB = nodeB->dynamicID;
+        int iA = localIDs[edge->partIDA];
+        int iB = localIDs[edge->partIDB];
 
         Vector3 ctA = (nodeA->centroid).template cast<double>();
         Vector3 ctB = (nodeB->centroid).template cast<double>();
@@ -246,7 +294,126 @@ void InterlockingSolver<Scalar>::computeRotationalInterlockingMatrix(vector<Eige
             }
         }
     }
-    size = Eigen::Vector2i(rowID, 6 * graph->dynamic_nodes.size());
+    size = Eigen::Vector2i(rowID, 6 * component.nodeIDs.size());
+}
+
+/*************************************************
+*                   Presolve
+*
+*   The contact rows of the edges between the same two parts with the same normal n are redundant:
+*   1. translation: all of them are the same row (-n, n), one row is enough.
+*   2. rotation: the row of a contact point p is affine in p and (p + s * n) x n = p x n,
+*      so only the vertices of the 2D convex hull of their points (projected along n) are needed.
+*   Neither the feasible velocities nor the maximum of the rows change, so the interlocking test is not affected.
+*************************************************/
+
+template<typename Scalar>
+void InterlockingSolver<Scalar>::computePresolvedInterlockingMatrix(const DynamicComponent &component,
+                                                                    const vector<int> &localIDs,
+                                                                    bool isRotation,
+                                                                    vector<EigenTriple> &tri,
+                                                                    Eigen::Vector2i &size)
+{
+    // 1. group the edges by (partIDA, partIDB, normal), the edge (B, A, -n) is the edge (A, B, n)
+    struct EdgeKey{
+        int partIDA, partIDB;
+        Vector3 nrm;
+        int edgeID;
+    };
+
+    vector<EdgeKey> keys;
+    for(int edgeID: component.edgeIDs)
+    {
+        shared_ptr<ContactGraphEdge<Scalar>> edge = graph->edges[edgeID];
+        if(edge->size() == 0) continue;
+        EdgeKey key = {edge->partIDA, edge->partIDB, (edge->normal).template cast<double>(), edgeID};
+        if(key.partIDA > key.partIDB){
+            std::swap(key.partIDA, key.partIDB);
+            key.nrm = -key.nrm;
+        }
+        keys.push_back(key);
+    }
+
+    std::sort(keys.begin(), keys.end(), [](const EdgeKey &a, const EdgeKey &b){
+        if(a.partIDA != b.partIDA) return a.partIDA < b.partIDA;
+        if(a.partIDB != b.partIDB) return a.partIDB < b.partIDB;
+        for(int index = 0; index < 3; index++){
+            if(a.nrm[index] != b.nrm[index]) return a.nrm[index] < b.nrm[index];
+        }
+        return a.edgeID < b.edgeID;
+    });
+
+    // 2. one row per group (translation) or per hull vertex of the group (rotation)
+    int rowID = 0;
+    int dimension = (isRotation ? 6 : 3);
+    tri.clear();
+
+    ConvexHull2D<double> hull;
+    vector<Vector3> points, hull_points;
+    for(size_t group_sta = 0, group_end; group_sta < keys.size(); group_sta = group_end)
+    {
+        const EdgeKey &key = keys[group_sta];
+        for(group_end = group_sta + 1; group_end < keys.size(); group_end++){
+            const EdgeKey &next = keys[group_end];
+            if(next.partIDA != key.partIDA || next.partIDB != key.partIDB) break;
+            if((next.nrm - key.nrm).norm() > FLOAT_ERROR_SMALL) break;
+        }
+
+        int iA = localIDs[key.partIDA];
+        int iB = localIDs[key.partIDB];
+        const Vector3 &nrm = key.nrm;
+
+        if(!isRotation)
+        {
+            for(int index = 0; index < 3; index++){
+                if (iA != -1) tri.push_back(EigenTriple(rowID, 3 * iA + index, -nrm[index]));
+                if (iB != -1) tri.push_back(EigenTriple(rowID, 3 * iB + index, nrm[index]));
+            }
+            rowID++;
+            continue;
+        }
+
+        points.clear();
+        for(size_t id = group_sta; id < group_end; id++){
+            shared_ptr<ContactGraphEdge<Scalar>> edge = graph->edges[keys[id].edgeID];
+            for(size_t jd = 0; jd < edge->size(); jd++){
+                for(pVertex ver: edge->polygons[jd]->vers){
+                    points.push_back((ver->pos).template cast<double>());
+                }
+            }
+        }
+
+        hull.compute(points, nrm, hull_points);
+        if(hull_points.empty()){
+            // all the points coincide
+            hull_points.assign(points.begin(), points.begin() + std::min<size_t>(points.size(), 1));
+        }
+
+        Vector3 ctA = (graph->nodes[key.partIDA]->centroid).template cast<double>();
+        Vector3 ctB = (graph->nodes[key.partIDB]->centroid).template cast<double>();
+        for(const Vector3 &pt: hull_points)
+        {
+            if (iA != -1)
+            {
+                Vector3 mt = (pt - ctA).cross(nrm);
+                for(int index = 0; index < 3; index++){
+                    tri.push_back(EigenTriple(rowID, 6 * iA + index, -nrm[index]));
+                    tri.push_back(EigenTriple(rowID, 6 * iA + 3 + index, -mt[index]));
+                }
+            }
+
+            if (iB != -1)
+            {
+                Vector3 mt = (pt - ctB).cross(nrm);
+                for(int index = 0; index < 3; index++){
+                    tri.push_back(EigenTriple(rowID, 6 * iB + index, nrm[index]));
+                    tri.push_back(EigenTriple(rowID, 6 * iB + 3 + index, mt[index]));
+                }
+            }
+            rowID++;
+        }
+    }
+    size = Eigen::Vector2i(rowID, dimension * component.nodeIDs.size());
 }
 
 template<typename Scalar>
@@ -310,14 +477,27 @@ void InterlockingSolver<Scalar>::appendAuxiliaryVariables(vector<EigenTriple> &t
 
 template<typename Scalar>
 void InterlockingSolver<Scalar>::appendMergeConstraints(vector<EigenTriple> &tri, Eigen::Vector2i &size, bool isRotation)
+{
+    DynamicComponent component;
+    vector<int> localIDs;
+    computeWholeGraphComponent(component, localIDs);
+    appendMergeConstraints(component, localIDs, tri, size, isRotation);
+}
+
+template<typename Scalar>
+void InterlockingSolver<Scalar>::appendMergeConstraints(const DynamicComponent &component,
+                                                        const vector<int> &localIDs,
+                                                        vector<EigenTriple> &tri,
+                                                        Eigen::Vector2i &size,
+                                                        bool isRotation)
 {
     int dimension = (isRotation ? 6 : 3);
-    for(int id = 0;id < graph->merged_nodes.size(); id++)
+    for(int id = 0;id < component.mergeIDs.size(); id++)
     {
-        wpContactGraphNode A = graph->merged_nodes[id].first;
-        wpContactGraphNode B = graph->merged_nodes[id].second;
-        int iA = A.lock()->dynamicID;
-        int iB = B.lock()->dynamicID;
+        wpContactGraphNode A = graph->merged_nodes[component.mergeIDs[id]].first;
+        wpContactGraphNode B = graph->merged_nodes[component.mergeIDs[id]].second;
+        int iA = localIDs[A.lock()->staticID];
+        int iB = localIDs[B.lock()->staticID];
         if(iA != -1 && iB != -1)
         {
             for(int index = 0; index < dimension; index++)
@@ -343,10 +523,219 @@ void InterlockingSolver<Scalar>::appendMergeConstraints(vector<EigenTriple> &tri
             }
         }
     }
-    size[0] += graph->merged_nodes.size() * dimension * 2;
+    size[0] += component.mergeIDs.size() * dimension * 2;
     return;
 }
 
+/**
+ * @brief a motion x with A x = 0 neither pushes nor separates any contact, its LP objective is zero like an interlocking one.
+ * @return true if A has such a null space motion, which is returned in motion
+ */
+template<typename Scalar>
+bool InterlockingSolver<Scalar>::computeNullSpaceMotion(const vector<EigenTriple> &tri, Eigen::Vector2i size, Eigen::VectorXd &motion)
+{
+    // with fewer rows than columns, A still has a null space and the QR below finds it
+    EigenSpMat A(size[0], size[1]);
+    A.setFromTriplets(tri.begin(), tri.end());
+
+    Eigen::SparseQR<Eigen::SparseMatrix<double>,
+            Eigen::COLAMDOrdering<int> > solver;
+    solver.compute(A.transpose());
+
+    if (A.cols() - solver.rank() == 0) {
+        return false;
+    }
+
+    motion = Eigen::MatrixXd(solver.matrixQ()).rightCols(A.cols() - solver.rank()).col(0);
+    return true;
+}
+
+/*************************************************
+*      Translational Pre-filter (Normal Cones)
+*
+*   A part translating with velocity x must satisfy d * x >= 0 for each of its contact directions d
+*   (the normal pointing into the part), as long as its neighbors do not move.
+*   1. if all the contacts of a part admit such a nonzero x, the part can be taken out alone: not interlocking.
+*   2. if its contacts with immobile parts (boundary or already proven) admit none, the part is immobile too.
+*      repeating 2. from the boundary fixes parts which the LP then treats as boundary parts.
+*************************************************/
+
+template<typename Scalar>
+bool InterlockingSolver<Scalar>::filterTranslationalByNormalCones(vector<bool> &immobile, int &freePartID, Vector3 &freeDirection)
+{
+    tbb::tick_count sta = tbb::tick_count::now();
+
+    int num_nodes = graph->nodes.size();
+    numConeImmobileParts = 0;
+    numConeLPParts = 0;
+
+    // the contact directions of each node, paired with the node on the other side
+    vector<vector<std::pair<Vector3, int>>> contacts(num_nodes);
+    for(shared_ptr<ContactGraphEdge<Scalar>> edge: graph->edges){
+        if(edge->size() == 0) continue;
+        Vector3 nrm = (edge->normal).template cast<double>();
+        contacts[edge->partIDA].push_back(std::make_pair(-nrm, edge->partIDB));
+        contacts[edge->partIDB].push_back(std::make_pair(nrm, edge->partIDA));
+    }
+
+    // merged parts move together, neither of them can be taken out alone
+    vector<bool> merged(num_nodes, false);
+    for(auto &merge: graph->merged_nodes){
+        merged[merge.first.lock()->staticID] = true;
+        merged[merge.second.lock()->staticID] = true;
+    }
+
+    immobile.assign(num_nodes, false);
+    for(int id = 0; id < num_nodes; id++){
+        immobile[id] = graph->nodes[id]->isBoundary;
+    }
+
+    // 1. a part which can be taken out alone
+    vector<Vector3> directions(num_nodes, Vector3(0, 0, 0));
+    vector<char> isFree(num_nodes, false);
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, num_nodes), [&](const tbb::blocked_range<size_t>& r)
+    {
+        vector<Vector3> normals;
+        for(size_t id = r.begin(); id != r.end(); ++id)
+        {
+            if(immobile[id] || merged[id]) continue;
+            normals.clear();
+            for(auto &contact: contacts[id]) normals.push_back(contact.first);
+            isFree[id] = computeConeDirection(normals, directions[id]);
+        }
+    });
+
+    for(int id = 0; id < num_nodes; id++){
+        if(isFree[id]){
+            freePartID = id;
+            freeDirection = directions[id];
+            if(verbose){
+                std::cout << "normal cone:\tpart " << id << " is free,\t" << (tbb::tick_count::now() - sta).seconds() << std::endl;
+            }
+            return false;
+        }
+    }
+
+    // 2. propagate the immobile parts from the boundary
+    freePartID = -1;
+    bool changed = true;
+    while(changed)
+    {
+        vector<char> isImmobile(num_nodes, false);
+        tbb::parallel_for(tbb::blocked_range<size_t>(0, num_nodes), [&](const tbb::blocked_range<size_t>& r)
+        {
+            vector<Vector3> normals;
+            Vector3 direction;
+            for(size_t id = r.begin(); id != r.end(); ++id)
+            {
+                if(immobile[id]) continue;
+                normals.clear();
+                for(auto &contact: contacts[id]){
+                    if(immobile[contact.second]) normals.push_back(contact.first);
+                }
+                if(normals.size() >= 4){
+                    isImmobile[id] = !computeConeDirection(normals, direction);
+                }
+            }
+        });
+
+        changed = false;
+        for(int id = 0; id < num_nodes; id++){
+            if(isImmobile[id]){
+                immobile[id] = true;
+                changed = true;
+            }
+        }
+
+        for(auto &merge: graph->merged_nodes){
+            int iA = merge.first.lock()->staticID;
+            int iB = merge.second.lock()->staticID;
+            if(immobile[iA] != immobile[iB]){
+                immobile[iA] = immobile[iB] = true;
+                changed = true;
+            }
+        }
+    }
+
+    for(int id = 0; id < num_nodes; id++){
+        if(immobile[id] && !graph->nodes[id]->isBoundary) numConeImmobileParts++;
+    }
+    numConeLPParts = (int)graph->dynamic_nodes.size() - numConeImmobileParts;
+    if(verbose){
+        std::cout << "normal cone:\t" << numConeImmobileParts << " immobile parts,\tLP parts:\t"
+                  << numConeLPParts << "/" << graph->dynamic_nodes.size()
+                  << ",\t" << (tbb::tick_count::now() - sta).seconds() << std::endl;
+    }
+
+    return true;
+}
+
+/**
+ * @brief find a nonzero direction x with n * x >= 0 for all the normals.
+ *        the cone {x | n * x >= 0} is either a line/plane orthogonal to the normals,
+ *        or has an extreme ray orthogonal to two of them, so only those directions are tested.
+ * @return false if the cone is {0}, i.e. the normals positively span R^3
+ */
+template<typename Scalar>
+bool InterlockingSolver<Scalar>::computeConeDirection(const vector<Vector3> &normals, Vector3 &direction)
+{
+    // remove the duplicated normals
+    vector<Vector3> unique_normals;
+    for(const Vector3 &nrm: normals){
+        if(nrm.norm() < FLOAT_ERROR_SMALL) continue;
+        Vector3 unit = nrm.normalized();
+        bool duplicated = false;
+        for(const Vector3 &other: unique_normals){
+            if((other - unit).norm() < FLOAT_ERROR_LARGE){
+                duplicated = true;
+                break;
+            }
+        }
+        if(!duplicated) unique_normals.push_back(unit);
+    }
+
+    if(unique_normals.empty()){
+        direction = Vector3(1, 0, 0);
+        return true;
+    }
+
+    auto is_feasible = [&](const Vector3 &x){
+        for(const Vector3 &nrm: unique_normals){
+            if(nrm.dot(x) < -FLOAT_ERROR_LARGE) return false;
+        }
+        return true;
+    };
+
+    auto test = [&](Vector3 x){
+        if(x.norm() < FLOAT_ERROR_LARGE) return false;
+        x.normalize();
+        if(is_feasible(x)){
+            direction = x;
+            return true;
+        }
+        if(is_feasible(-x)){
+            direction = -x;
+            return true;
+        }
+        return false;
+    };
+
+    for(size_t id = 0; id < unique_normals.size(); id++)
+    {
+        const Vector3 &ni = unique_normals[id];
+
+        // the normals are parallel to ni: the plane orthogonal to ni
+        Vector3 x_axis = ni.cross(Vector3(1, 0, 0));
+        if(x_axis.norm() < 0.5) x_axis = ni.cross(Vector3(0, 1, 0));
+        if(test(ni) || test(x_axis) || test(ni.cross(x_axis))) return true;
+
+        for(size_t jd = id + 1; jd < unique_normals.size(); jd++){
+            if(test(ni.cross(unique_normals[jd]))) return true;
+        }
+    }
+    return false;
+}
+
 template<typename Scalar>
 void InterlockingSolver<Scalar>::computeEquilibriumMatrix(Eigen::MatrixXd &Aeq,  bool withFriction) {
     if (!withFriction)
@@ -446,6 +835,85 @@ Scalar InterlockingSolver<Scalar>::computeEquilibriumMatrixConditonalNumber()
 
 }
 
+/*************************************************
+*           Interlocking Test
+*************************************************/
+
+template<typename Scalar>
+bool InterlockingSolver<Scalar>::solveComponents(shared_ptr<InterlockingData> &data,
+                                                 bool rotationalInterlockingCheck,
+                                                 const vector<bool> &isFixed) {
+
+    // the dynamic parts which only touch each other through boundary parts cannot affect each other,
+    // so every connected component is an independent LP and they are solved concurrently.
+    vector<DynamicComponent> components;
+    vector<int> localIDs;
+    graph->computeDynamicComponents(components, localIDs, isFixed);
+
+    vector<Eigen::VectorXd> solutions(components.size());
+    vector<char> interlocking(components.size(), true);
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, components.size()), [&](const tbb::blocked_range<size_t>& r)
+    {
+        for(size_t id = r.begin(); id != r.end(); ++id){
+            interlocking[id] = solveComponent(components[id], localIDs, rotationalInterlockingCheck, solutions[id]);
+        }
+    });
+
+    // merge the velocities of the components, indexed by dynamicID
+    int dimension = (rotationalInterlockingCheck ? 6 : 3);
+    Eigen::VectorXd solution = Eigen::VectorXd::Zero(dimension * graph->dynamic_nodes.size());
+    bool isInterlocking = true;
+    for(size_t id = 0; id < components.size(); id++)
+    {
+        const vector<int> &nodeIDs = components[id].nodeIDs;
+        for(size_t jd = 0; jd < nodeIDs.size(); jd++){
+            int dynamicID = graph->nodes[nodeIDs[jd]]->dynamicID;
+            solution.segment(dimension * dynamicID, dimension) = solutions[id].segment(dimension * jd, dimension);
+        }
+
+        if(!interlocking[id]){
+            if(components.size() > 1 && verbose){
+                std::cout << "component " << id << " (" << nodeIDs.size() << " parts) is not interlocking" << std::endl;
+            }
+            isInterlocking = false;
+        }
+    }
+
+    unpackSolution(data, rotationalInterlockingCheck, solution.data(), solution.size());
+    return isInterlocking;
+}
+
+template<typename Scalar>
+void InterlockingSolver<Scalar>::unpackSolution(shared_ptr<InterlockingData> &data,
+                                                bool rotationalInterlockingCheck,
+                                                const double *solution,
+                                                int num_var) {
+    data = make_shared<InterlockingData>();
+    for (shared_ptr<ContactGraphNode<Scalar>> node: graph->nodes) {
+        Vector3 trans(0, 0, 0);
+        Vector3 rotate(0, 0, 0);
+        Vector3 center = (node->centroid).template cast<double>();
+        if (node->dynamicID != -1) {
+            if (rotationalInterlockingCheck) {
+                trans = Vector3(solution[node->dynamicID * 6],
+                                solution[node->dynamicID * 6 + 1],
+                                solution[node->dynamicID * 6 + 2]);
+                rotate = -Vector3(solution[node->dynamicID * 6 + 3],
+                                  solution[node->dynamicID * 6 + 4],
+                                  solution[node->dynamicID * 6 + 5]);
+            } else {
+                trans = Vector3(solution[node->dynamicID * 3],
+                                solution[node->dynamicID * 3 + 1],
+                                solution[node->dynamicID * 3 + 2]);
+            }
+        }
+
+        data->traslation.push_back(trans);
+        data->rotation.push_back(rotate);
+        data->center.push_back(center);
+    }
+}
+
 
 // No need to call this TemporaryFunction() function,
 // it's just to avoid link error.
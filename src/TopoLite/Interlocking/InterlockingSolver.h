@@ -27,6 +27,7 @@ public:
     typedef std::vector<Vector3,Eigen::aligned_allocator<Vector3>> stdvec_Vector3;
     typedef shared_ptr<VPoint<Scalar>> pVertex;
     typedef weak_ptr<ContactGraphNode<Scalar>> wpContactGraphNode;
+    typedef typename ContactGraph<Scalar>::DynamicComponent DynamicComponent;
 
 public:
 
@@ -47,11 +48,21 @@ public:
 
     shared_ptr<ContactGraph<Scalar>> graph;
 
+    bool verbose;   // print the report of every solve
+
+    // the shrink of the last normal cone pre-filter: the dynamic parts it proved immobile, the ones left to the LP
+    int numConeImmobileParts;
+
+    int numConeLPParts;
+
 public:
 
     InterlockingSolver(shared_ptr<ContactGraph<Scalar>> _graph, shared_ptr<InputVarList> varList):TopoObject(varList)
     {
         graph = _graph;
+        verbose = true;
+        numConeImmobileParts = 0;
+        numConeLPParts = 0;
     }
 
 
@@ -89,16 +100,44 @@ public:
 
     void computeRotationalInterlockingMatrix(vector<EigenTriple> &tri, Eigen::Vector2i &size);      // used to compute A
 
+    void computeWholeGraphComponent(DynamicComponent &component, vector<int> &localIDs);            // every dynamic node, indexed by its dynamicID
+
+    // the matrix of one component, its columns are indexed by the localIDs of the nodes
+    void computeTranslationalInterlockingMatrix(const DynamicComponent &component, const vector<int> &localIDs,
+                                                vector<EigenTriple> &tri, Eigen::Vector2i &size);
+
+    void computeRotationalInterlockingMatrix(const DynamicComponent &component, const vector<int> &localIDs,
+                                             vector<EigenTriple> &tri, Eigen::Vector2i &size);
+
     void computeRotationalInterlockingMatrixDense(Eigen::MatrixXd &mat);                            // used to compute A
 
     void computeTranslationalInterlockingMatrixDense(Eigen::MatrixXd &mat);
 
     void computeRotationalInterlockingMatrixSparse(EigenSpMat &mat);
 
+    // the contact rows of a component without the redundant ones (see the Presolve block in the .cpp)
+    void computePresolvedInterlockingMatrix(const DynamicComponent &component, const vector<int> &localIDs, bool isRotation,
+                                            vector<EigenTriple> &tri, Eigen::Vector2i &size);
+
     void appendAuxiliaryVariables(vector<EigenTriple> &tri, Eigen::Vector2i &size);
 
     void appendMergeConstraints(vector<EigenTriple> &tri, Eigen::Vector2i &size, bool isRotation);
 
+    void appendMergeConstraints(const DynamicComponent &component, const vector<int> &localIDs,
+                                vector<EigenTriple> &tri, Eigen::Vector2i &size, bool isRotation);
+
+    bool computeNullSpaceMotion(const vector<EigenTriple> &tri, Eigen::Vector2i size, Eigen::VectorXd &motion);
+
+public:
+
+    /*************************************************
+    *      Translational Pre-filter (Normal Cones)
+    *************************************************/
+
+    bool filterTranslationalByNormalCones(vector<bool> &immobile, int &freePartID, Vector3 &freeDirection);
+
+    static bool computeConeDirection(const vector<Vector3> &normals, Vector3 &direction);
+
 public:
 
     /*************************************************
@@ -110,6 +149,18 @@ public:
     virtual bool isRotationalInterlocking(shared_ptr<InterlockingData> &data){ return  true;}
 
     virtual bool isEquilibrium(Vector3 gravity, shared_ptr<EquilibriumData> &data){ return  true;}
+
+    // the dynamic parts which only touch each other through fixed parts form independent LPs, solved concurrently
+    bool solveComponents(shared_ptr<InterlockingData> &data, bool rotationalInterlockingCheck, const vector<bool> &isFixed = vector<bool>());
+
+    // the velocities of the component are written by the localIDs of its nodes
+    virtual bool solveComponent(const DynamicComponent &component,
+                                const vector<int> &localIDs,
+                                bool rotationalInterlockingCheck,
+                                Eigen::VectorXd &solution){ return true;}
+
+    // the solution holds the velocities of the dynamic nodes, indexed by dynamicID
+    void unpackSolution(shared_ptr<InterlockingData> &data, bool rotationalInterlockingCheck, const double *solution, int num_var);
 };
 
 #endif //TOPOLITE_INTERLOCKINGSOLVER_H
@@ -5,7 +5,7 @@
 
 #include "InterlockingSolver_Clp.h"
 #include "tbb/tbb.h"
-#include <Eigen/SparseQR>
+#include <sstream>
 
 #include "ClpInterior.hpp"
 #include "ClpSimplex.hpp"
@@ -14,150 +14,136 @@
 
 template<typename Scalar>
 bool InterlockingSolver_Clp<Scalar>::isTranslationalInterlocking(InterlockingSolver_Clp::pInterlockingData &data) {
-    vector<EigenTriple> tris;
-    Eigen::Vector2i size;
 
-    InterlockingSolver<Scalar>::computeTranslationalInterlockingMatrix(tris, size);
-
-    if (!checkSpecialCase(data, tris, false, size)) {
+    // the parts decided by their normal cones do not enter the LP
+    vector<bool> immobile;
+    int freePartID;
+    typename InterlockingSolver<Scalar>::Vector3 freeDirection;
+    if (!InterlockingSolver<Scalar>::filterTranslationalByNormalCones(immobile, freePartID, freeDirection)) {
+        Eigen::VectorXd solution = Eigen::VectorXd::Zero(3 * graph->dynamic_nodes.size());
+        solution.segment(3 * graph->nodes[freePartID]->dynamicID, 3) = freeDirection;
+        unpackSolution(data, false, solution.data(), solution.size());
         return false;
     }
 
-    int num_var = size[1];
-    InterlockingSolver<Scalar>::appendAuxiliaryVariables(tris, size);
-    InterlockingSolver<Scalar>::appendMergeConstraints(tris, size, false);
-
-    return solve(data, tris, false, size[0], size[1], num_var);
+    return solveComponents(data, false, immobile);
 }
 
 template<typename Scalar>
 bool InterlockingSolver_Clp<Scalar>::isRotationalInterlocking(InterlockingSolver_Clp::pInterlockingData &data) {
+    return solveComponents(data, true);
+}
+
+template<typename Scalar>
+bool InterlockingSolver_Clp<Scalar>::solveComponent(const DynamicComponent &component,
+                                                    const vector<int> &localIDs,
+                                                    bool rotationalInterlockingCheck,
+                                                    Eigen::VectorXd &solution) {
     vector<EigenTriple> tris;
     Eigen::Vector2i size;
 
-    InterlockingSolver<Scalar>::computeRotationalInterlockingMatrix(tris, size);
+    InterlockingSolver<Scalar>::computePresolvedInterlockingMatrix(component, localIDs, rotationalInterlockingCheck, tris, size);
+
+    // a component without any contact can move freely
+    if (component.edgeIDs.empty()) {
+        solution = Eigen::VectorXd::Zero(size[1]);
+        int dimension = (rotationalInterlockingCheck ? 6 : 3);
+        for(int id = 0; id < component.nodeIDs.size(); id++) solution[id * dimension] = 1;
+        return false;
+    }
 
-//    std::cout << "special case" << std::endl;
-    if (!checkSpecialCase(data, tris, true, size)) {
+    if (!checkSpecialCase(component, localIDs, solution, tris, rotationalInterlockingCheck, size)) {
         return false;
     }
 
-    // Ignore this for lpopt - Enlarging the matrix
-    int num_var = size[1];
-    InterlockingSolver<Scalar>::appendAuxiliaryVariables(tris, size);
-    InterlockingSolver<Scalar>::appendMergeConstraints(tris, size, true);
+    int num_contact_row = size[0];
+    InterlockingSolver<Scalar>::appendMergeConstraints(component, localIDs, tris, size, rotationalInterlockingCheck);
 
-//    std::cout << "solve" << std::endl;
-    return solve(data, tris, true, size[0], size[1], num_var);
+    return solve(solution, tris, rotationalInterlockingCheck, num_contact_row, size[0], size[1]);
 }
 
 template<typename Scalar>
-bool InterlockingSolver_Clp<Scalar>::checkSpecialCase(pInterlockingData &data,
+bool InterlockingSolver_Clp<Scalar>::checkSpecialCase(const DynamicComponent &component,
+                                                      const vector<int> &localIDs,
+                                                      Eigen::VectorXd &solution,
                                                       vector<EigenTriple> copy_tris,
                                                       bool rotationalInterlockingCheck,
                                                       Eigen::Vector2i copy_size) {
 
-    InterlockingSolver<Scalar>::appendMergeConstraints(copy_tris, copy_size, rotationalInterlockingCheck);
-
-    if (copy_size[0] < copy_size[1]) return true;
-
-    EigenSpMat A(copy_size[0], copy_size[1]);
-    A.setFromTriplets(copy_tris.begin(), copy_tris.end());
+    InterlockingSolver<Scalar>::appendMergeConstraints(component, localIDs, copy_tris, copy_size, rotationalInterlockingCheck);
 
-    Eigen::SparseQR<Eigen::SparseMatrix<double>,
-            Eigen::COLAMDOrdering<int> > solver;
-    solver.compute(A.transpose());
-
-    if (A.cols() - solver.rank() == 0) {
+    if (!InterlockingSolver<Scalar>::computeNullSpaceMotion(copy_tris, copy_size, solution)) {
         return true;
-    } else {
-        Eigen::VectorXd solution = Eigen::MatrixXd(solver.matrixQ()).rightCols(A.cols() - solver.rank()).col(0);
-        std::cout << "||A * x||: " << (A * solution).norm() << ", ||x||: " << solution.norm() << std::endl;
-        unpackSolution(data, rotationalInterlockingCheck, solution.data(), copy_size[1]);
-        return false;
     }
-    return true;
+
+    std::ostringstream log;
+    log << "null space motion, ||x||: " << solution.norm() << std::endl;
+    if (verbose) std::cout << log.str();
+    return false;
 }
 
 template<typename Scalar>
-bool InterlockingSolver_Clp<Scalar>::solve(InterlockingSolver_Clp::pInterlockingData &data, vector<EigenTriple> &tris,
+bool InterlockingSolver_Clp<Scalar>::solve(Eigen::VectorXd &solution, vector<EigenTriple> &tris,
                                            bool rotationalInterlockingCheck,
+                                           int num_contact_row,
                                            int num_row,
-                                           int num_col,
                                            int num_var) {
 
     //Problem definition
-    //tris is equal to a sparse matrix A, which size is [num_row x num_col]
-    //our variables are [x, t], a row vector.
+    //tris is equal to a sparse matrix A, which size is [num_row x num_var]
+    //the first num_contact_row rows are the contact constraints, the others are the merge constraints.
     //x: (size: num_var) is the instant translational and rotational velocity.
-    //t: (size: num_col - num_var) is the auxiliary variable.
-    //the optimization is formulated as:
-    //              min \sum_{i = 0}^{num_row} -t_i
-    //  s.t.            A[x, t] >= 0
-    //                  1 >= t >= 0
+    //the auxiliary variable t of the contact row i would be t_i = A_i x with 1 >= t_i >= 0,
+    //it is eliminated by bounding the row itself, so the LP only has the columns of x:
+    //              min \sum_{i = 0}^{num_contact_row} -A_i x
+    //  s.t.            1 >= A_i x >= 0     (contact rows)
+    //                       A_j x = 0      (merge rows)
     //                    x \in R
     // Ideally if the structure is interlocking, the objective value should be zero.
     // In practice, due to numerical error, we have to allow a small tolerance for the objective value.
 
+    int num_col = num_var;
 
     EigenSpMat spatMat(num_row, num_col);
     spatMat.setFromTriplets(tris.begin(), tris.end());
 
-
     CoinPackedMatrix matrix(true, num_row, num_col, spatMat.nonZeros(), spatMat.valuePtr(), spatMat.innerIndexPtr(),
                             spatMat.outerIndexPtr(), spatMat.innerNonZeroPtr());
 
     // boundaries for rows and colums values
 
-    double *objective = new double[num_col];
-    double *rowLower = new double[num_row];
-    double *rowUpper = new double[num_row];
-    double *colLower = new double[num_col];
-    double *colUpper = new double[num_col];
-
-    //objects
-    for (size_t id = 0; id < num_col; id++) {
-        if (id < num_var)
-            objective[id] = 0;
-        else
-            objective[id] = -1;
+    vector<double> objective(num_col, 0);
+    vector<double> rowLower(num_row, 0);
+    vector<double> rowUpper(num_row, 0);
+    vector<double> colLower(num_col, -COIN_DBL_MAX);
+    vector<double> colUpper(num_col, COIN_DBL_MAX);
+
+    //objects: the sum of the contact rows
+    for (int col = 0; col < num_col; col++) {
+        for (typename EigenSpMat::InnerIterator it(spatMat, col); it; ++it) {
+            if (it.row() < num_contact_row)
+                objective[col] -= it.value();
+        }
     }
 
     //bound
-    for (size_t id = 0; id < num_row; id++)
-        rowLower[id] = 0;
-
-    for (size_t id = 0; id < num_row; id++)
-        rowUpper[id] = 0;
-
-    for (size_t id = 0; id < num_col; id++) {
-        if (id < num_var)
-            colLower[id] = -COIN_DBL_MAX;
-        else
-            colLower[id] = 0;
-    }
-
-    for (size_t id = 0; id < num_col; id++) {
-        if (id < num_var)
-            colUpper[id] = COIN_DBL_MAX;
-        else
-            colUpper[id] = 1;
-    }
+    for (int id = 0; id < num_contact_row; id++)
+        rowUpper[id] = 1;
 
     if (type == SIMPLEX) {
-        return solveSimplex(data, rotationalInterlockingCheck, num_row, num_col, num_var, matrix, colLower, colUpper, objective, rowLower,
-                            rowUpper);
+        return solveSimplex(solution, rotationalInterlockingCheck, num_contact_row, num_row, num_var, matrix,
+                            colLower.data(), colUpper.data(), objective.data(), rowLower.data(), rowUpper.data());
     } else {
-        return solveBarrier(data, rotationalInterlockingCheck, num_row, num_col, num_var, matrix, colLower, colUpper, objective, rowLower,
-                            rowUpper);
+        return solveBarrier(solution, rotationalInterlockingCheck, num_contact_row, num_row, num_var, matrix,
+                            colLower.data(), colUpper.data(), objective.data(), rowLower.data(), rowUpper.data());
     }
 }
 
 template<typename Scalar>
-bool InterlockingSolver_Clp<Scalar>::solveSimplex(pInterlockingData &data,
+bool InterlockingSolver_Clp<Scalar>::solveSimplex(Eigen::VectorXd &solution,
                                                   bool rotationalInterlockingCheck,
+                                                  int num_contact_row,
                                                   int num_row,
-                                                  int num_col,
                                                   int num_var,
                                                   const CoinPackedMatrix &matrix,
                                                   const double *colLower,
@@ -186,36 +172,19 @@ bool InterlockingSolver_Clp<Scalar>::solveSimplex(pInterlockingData &data,
 
     // Solution
     const double target_obj_value = model.rawObjectiveValue();
-    double *solution = model.primalColumnSolution();
+    double *col_solution = model.primalColumnSolution();
     double *row_solution = model.primalRowSolution();
 
-    double max_sol = 0;
-    for (int id = num_var; id < num_col; id++) {
-        max_sol = std::max(solution[id], max_sol);
-    }
-
-    unpackSolution(data, rotationalInterlockingCheck, solution, num_var);
+    solution = Eigen::Map<const Eigen::VectorXd>(col_solution, num_var);
 
-    double min_row_sol = MAX_FLOAT;
-    for (int id = 0; id < num_row; id++) {
-        min_row_sol = std::min(row_solution[id], min_row_sol);
-    }
-
-    std::cout << "min_row:\t" << min_row_sol; //should be around zero
-    std::cout << ",\tmax_t:\t" << std::abs(max_sol); //interlocking if max_t is around zero
-    std::cout << ",\taverage_t:\t" << std::abs(target_obj_value) / num_row << std::endl;//interlocking if average_t is around zero
-    if (max_sol < 5e-6) {
-        return true;
-    } else {
-        return false;
-    }
+    return checkSolution(row_solution, num_contact_row, target_obj_value);
 }
 
 template<typename Scalar>
-bool InterlockingSolver_Clp<Scalar>::solveBarrier(pInterlockingData &data,
+bool InterlockingSolver_Clp<Scalar>::solveBarrier(Eigen::VectorXd &solution,
                                                   bool rotationalInterlockingCheck,
+                                                  int num_contact_row,
                                                   int num_row,
-                                                  int num_col,
                                                   int num_var,
                                                   const CoinPackedMatrix &matrix,
                                                   const double *colLower,
@@ -241,66 +210,38 @@ bool InterlockingSolver_Clp<Scalar>::solveBarrier(pInterlockingData &data,
 
     // Solution
     const double target_obj_value = int_model.rawObjectiveValue();
-    double *solution = int_model.primalColumnSolution();
-    double max_sol = 0;
-    for (int id = num_var; id < num_col; id++) {
-        max_sol = std::max(solution[id], max_sol);
-    }
+    double *col_solution = int_model.primalColumnSolution();
+    double *row_solution = int_model.primalRowSolution();
 
-    unpackSolution(data, rotationalInterlockingCheck, solution, num_var);
+    solution = Eigen::Map<const Eigen::VectorXd>(col_solution, num_var);
 
-    //verify solution
+    return checkSolution(row_solution, num_contact_row, target_obj_value);
+}
 
-    double *row_solution = int_model.primalRowSolution();
+template<typename Scalar>
+bool InterlockingSolver_Clp<Scalar>::checkSolution(const double *row_solution, int num_contact_row, double target_obj_value) {
 
+    // the activity of a contact row is its auxiliary variable t
+    double max_sol = 0;
     double min_row_sol = MAX_FLOAT;
-    for (int id = 0; id < num_row; id++) {
+    for (int id = 0; id < num_contact_row; id++) {
+        max_sol = std::max(row_solution[id], max_sol);
         min_row_sol = std::min(row_solution[id], min_row_sol);
     }
 
-    std::cout << "min_row:\t" << min_row_sol; //should be around zero
-    std::cout << ",\tmax_t:\t" << std::abs(max_sol); //interlocking if max_t is around zero
-    std::cout << ",\taverage_t:\t" << std::abs(target_obj_value) / num_row << std::endl;//interlocking if average_t is around zero
-    if (max_sol < 5e-6) {
+    // components are solved concurrently, so the report is written in one piece
+    std::ostringstream log;
+    log << "min_row:\t" << min_row_sol; //should be around zero
+    log << ",\tmax_t:\t" << std::abs(max_sol); //interlocking if max_t is around zero
+    log << ",\taverage_t:\t" << std::abs(target_obj_value) / std::max(num_contact_row, 1) << std::endl;//interlocking if average_t is around zero
+    if (verbose) std::cout << log.str();
+    if (max_sol < INTERLOCKING_THRESHOLD) {
         return true;
     } else {
         return false;
     }
 }
 
-template<typename Scalar>
-void InterlockingSolver_Clp<Scalar>::unpackSolution(InterlockingSolver_Clp::pInterlockingData &data,
-                                                    bool rotationalInterlockingCheck,
-                                                    const double *solution,
-                                                    int num_var) {
-    data = make_shared<typename InterlockingSolver<Scalar>::InterlockingData>();
-    for (pContactGraphNode node: graph->nodes) {
-        Vector3 trans(0, 0, 0);
-        Vector3 rotate(0, 0, 0);
-        Vector3 center = node->centroid;
-        if (node->dynamicID != -1) {
-            if (rotationalInterlockingCheck) {
-                trans = Vector3(solution[node->dynamicID * 6],
-                                solution[node->dynamicID * 6 + 1],
-                                solution[node->dynamicID * 6 + 2]);
-                rotate = -Vector3(solution[node->dynamicID * 6 + 3],
-                                  solution[node->dynamicID * 6 + 4],
-                                  solution[node->dynamicID * 6 + 5]);
-            } else {
-                trans = Vector3(solution[node->dynamicID * 3],
-                                solution[node->dynamicID * 3 + 1],
-                                solution[node->dynamicID * 3 + 2]);
-            }
-        }
-
-        data->traslation.push_back(trans);
-        data->rotation.push_back(rotate);
-        data->center.push_back(center);
-
-//        std::cout << node->staticID << ":" << trans.transpose() << ", " << rotate.transpose() << std::endl;
-    }
-}
-
 void TemporaryFunction_InterlockingSolver_Clp ()
 {
     InterlockingSolver_Clp<double> solver(nullptr, nullptr);
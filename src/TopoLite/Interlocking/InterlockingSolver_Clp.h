@@ -23,7 +23,11 @@ public:
     typedef shared_ptr<ContactGraph<Scalar>> pContactGraph;
     typedef shared_ptr<ContactGraphNode<Scalar>> pContactGraphNode;
     using InterlockingSolver<Scalar>::graph;
+    using InterlockingSolver<Scalar>::verbose;
+    using InterlockingSolver<Scalar>::solveComponents;
+    using InterlockingSolver<Scalar>::unpackSolution;
     typedef Matrix<Scalar, 3, 1> Vector3;
+    typedef typename InterlockingSolver<Scalar>::DynamicComponent DynamicComponent;
 
     CLP_SOLVER_TYPE type;
 
@@ -42,22 +46,29 @@ public:
 
     bool isRotationalInterlocking(pInterlockingData &data);
 
-    bool checkSpecialCase(pInterlockingData &data,
+    bool solveComponent(const DynamicComponent &component,
+                        const vector<int> &localIDs,
+                        bool rotationalInterlockingCheck,
+                        Eigen::VectorXd &solution);
+
+    bool checkSpecialCase(const DynamicComponent &component,
+                          const vector<int> &localIDs,
+                          Eigen::VectorXd &solution,
                           vector<EigenTriple> copy_tris,
                           bool rotationalInterlockingCheck,
                           Eigen::Vector2i copy_size);
 
-    bool solve(pInterlockingData &data,
+    bool solve(Eigen::VectorXd &solution,
             vector<EigenTriple> &tris,
             bool rotationalInterlockingCheck,
+            int num_contact_row,
             int num_row,
-            int num_col,
             int num_var);
 
-    bool solveSimplex(pInterlockingData &data,
+    bool solveSimplex(Eigen::VectorXd &solution,
                bool rotationalInterlockingCheck,
+               int num_contact_row,
                int num_row,
-               int num_col,
                int num_var,
                const CoinPackedMatrix& matrix,
                const double *colLower,
@@ -66,10 +77,10 @@ public:
                const double *rowLower,
                const double *rowUpper);
 
-    bool solveBarrier(pInterlockingData &data,
+    bool solveBarrier(Eigen::VectorXd &solution,
                       bool rotationalInterlockingCheck,
+                      int num_contact_row,
                       int num_row,
-                      int num_col,
                       int num_var,
                       const CoinPackedMatrix& matrix,
                       const double *colLower,
@@ -78,7 +89,7 @@ public:
                       const double *rowLower,
                       const double *rowUpper);
 
-    void unpackSolution(InterlockingSolver_Clp::pInterlockingData& data, bool rotationalInterlockingCheck, const double *solution, int num_var);
+    bool checkSolution(const double *row_solution, int num_contact_row, double target_obj_value);
 };
 
 #endif //TOPOLITE_INTERLOCKINGSOLVER_CLP_H
@@ -2,6 +2,7 @@
 // Created by robinjodon on 29.04.20.
 //
 #include <cassert>
+#include <cstring>
 #include <iostream>
 #include "tbb/tbb.h"
 #include "InterlockingSolver_Ipopt.h"
@@ -27,7 +28,11 @@ bool InterlockingSolver_Ipopt<Scalar>::isTranslationalInterlocking(InterlockingS
     vector<EigenTriple> tris;
     Eigen::Vector2i size;
 
-    InterlockingSolver<Scalar>::computeTranslationalInterlockingMatrix(tris, size);
+    // the redundant contact rows are dropped before the aux variables are appended
+    typename InterlockingSolver<Scalar>::DynamicComponent component;
+    vector<int> localIDs;
+    InterlockingSolver<Scalar>::computeWholeGraphComponent(component, localIDs);
+    InterlockingSolver<Scalar>::computePresolvedInterlockingMatrix(component, localIDs, false, tris, size);
 
     if (!checkSpecialCase(data, tris, false, size)) {
         return false;
@@ -45,7 +50,11 @@ bool InterlockingSolver_Ipopt<Scalar>::isRotationalInterlocking(InterlockingSolv
     vector<EigenTriple> tris;
     Eigen::Vector2i size;
 
-    InterlockingSolver<Scalar>::computeRotationalInterlockingMatrix(tris, size);
+    // the redundant contact rows are dropped before the aux variables are appended
+    typename InterlockingSolver<Scalar>::DynamicComponent component;
+    vector<int> localIDs;
+    InterlockingSolver<Scalar>::computeWholeGraphComponent(component, localIDs);
+    InterlockingSolver<Scalar>::computePresolvedInterlockingMatrix(component, localIDs, true, tris, size);
 
 //    std::cout << "special case" << std::endl;
     if (!checkSpecialCase(data, tris, true, size)) {
@@ -74,20 +83,86 @@ bool InterlockingSolver_Ipopt<Scalar>::solve(InterlockingSolver_Ipopt::pInterloc
                                              int num_row,
                                              int num_col,
                                              int num_var) {
+    vector<pInterlockingData> datas;
+    vector<bool> results;
+    solveSequence(datas, tris, rotationalInterlockingCheck, num_row, num_col, num_var, {Eigen::VectorXd::Zero(num_row)}, results);
+    data = datas.front();
+    return results.front();
+}
 
-
-    // [0] - Instance for Ipopt App and NLP
-    SmartPtr<IpoptProblem> interlock_pb = new IpoptProblem();       // problem to solve
-    SmartPtr<IpoptApplication> app = IpoptApplicationFactory();     // solver
+template<typename Scalar>
+bool InterlockingSolver_Ipopt<Scalar>::solveSequence(vector<pInterlockingData> &datas,
+                                                     vector<EigenTriple> &tris,
+                                                     bool rotationalInterlockingCheck,
+                                                     int num_row,
+                                                     int num_col,
+                                                     int num_var,
+                                                     const vector<Eigen::VectorXd> &rowLowers,
+                                                     vector<bool> &results) {
+
+    // [0] - The application is created once, the problem is kept as long as the sparsity does not change
+    initializeApplication();
 
     // [1] - Define the matrix B
     EigenSpMat b(num_row, num_col);
     b.setFromTriplets(tris.begin(), tris.end());
 
-    interlock_pb->initialize(b);
+    // ReOptimizeTNLP requires the same TNLP object with the same structure
+    bool reoptimize = IsValid(problem) && problem->update(b);
+    if (!reoptimize) {
+        problem = new IpoptProblem();
+        problem->initialize(b);
+        numProblems++;
+    }
+    problem->verbose = verbose;
+
+    datas.resize(rowLowers.size());
+    results.resize(rowLowers.size());
+    for (size_t id = 0; id < rowLowers.size(); id++)
+    {
+        problem->g_l = rowLowers[id];
+
+        // [2] - Warm start from the previous solution, its multipliers are close to the optimal ones
+        if (problem->has_solution) {
+            app->Options()->SetStringValue("warm_start_init_point", "yes");
+            app->Options()->SetNumericValue("mu_init", 1e-6);
+            numWarmStarts++;
+        } else {
+            app->Options()->SetStringValue("warm_start_init_point", "no");
+            app->Options()->SetNumericValue("mu_init", 0.1);
+        }
 
-    // [2] - Set some options for the solver 
-    app->Options()->SetIntegerValue("print_level", 5);
+        // [3] - Optimzation
+        ApplicationReturnStatus status = reoptimize ? app->ReOptimizeTNLP(problem) : app->OptimizeTNLP(problem);
+        reoptimize = true;
+
+        if (verbose) {
+            if (status == Solve_Succeeded) {
+                printf("\n\n*** The problem solved!\n");
+            } else {
+                printf("\n\n*** The problem FAILED!\n");
+            }
+        }
+
+        unpackSolution(datas[id], rotationalInterlockingCheck, problem->x_solution.data(), num_var);
+        results[id] = problem->has_solution && problem->max_abs_t < 1E-4;
+    }
+
+    return std::find(results.begin(), results.end(), false) == results.end();
+}
+
+template<typename Scalar>
+void InterlockingSolver_Ipopt<Scalar>::initializeApplication() {
+
+    if (IsValid(app)) {
+        return;
+    }
+
+    app = IpoptApplicationFactory();
+
+    // [0] - Quiet unless verbose
+    app->Options()->SetIntegerValue("print_level", verbose ? 5 : 0);
+    app->Options()->SetStringValue("sb", "yes");                        // no banner
 
     // C.2 Termination
     app->Options()->SetNumericValue("tol", 1e-5);
@@ -97,6 +172,7 @@ bool InterlockingSolver_Ipopt<Scalar>::solve(InterlockingSolver_Ipopt::pInterloc
     app->Options()->SetStringValue("jac_c_constant", "yes");
     app->Options()->SetStringValue("jac_d_constant", "yes");
     app->Options()->SetStringValue("hessian_constant", "yes");
+    app->Options()->SetStringValue("hessian_approximation", "exact");   // the exact Hessian is empty, no quasi-Newton update
 
     // C.7 Multiplier update
     app->Options()->SetStringValue("alpha_for_y", "primal-and-full");   // step size use the primal step size and full step if delta x ¡= alpha for y tol
@@ -142,67 +218,20 @@ bool InterlockingSolver_Ipopt<Scalar>::solve(InterlockingSolver_Ipopt::pInterloc
         app->Options()->SetStringValue("mu_oracle", "loqo");
     }
 
-    
+    // C.5 Warm start, the bounds and multipliers of the previous solution are barely pushed inside
+    app->Options()->SetNumericValue("warm_start_bound_push", 1e-9);
+    app->Options()->SetNumericValue("warm_start_mult_bound_push", 1e-9);
+
     // For debugging purposes
     // app->Options()->SetStringValue("derivative_test", "first-order");
 
 
-    // [3] - Intialize the IpoptApplication and process the options
+    // [1] - Intialize the IpoptApplication and process the options
     ApplicationReturnStatus status;
     status = app->Initialize();
     if (status != Solve_Succeeded) {
         printf("\n\n*** Error during initialization!\n");
     }
-    
-    // [5] - Optimzation
-    status = app->OptimizeTNLP(interlock_pb);
-
-    if (status == Solve_Succeeded) {
-        printf("\n\n*** The problem solved!\n");
-    } else {
-        printf("\n\n*** The problem FAILED!\n");
-    }
-
-    unpackSolution(data, rotationalInterlockingCheck, interlock_pb->x_solution.data(), num_var);
-    if(interlock_pb->max_abs_t < 1E-4){
-        return true;
-    }
-    else{
-        return false;
-    }
-}
-
-template<typename Scalar>
-void InterlockingSolver_Ipopt<Scalar>::unpackSolution(InterlockingSolver_Ipopt::pInterlockingData &data,
-                                                      bool rotationalInterlockingCheck,
-                                                      const double *solution,
-                                                      int num_var) {
-    data = make_shared<typename InterlockingSolver<Scalar>::InterlockingData>();
-    for (pContactGraphNode node: graph->nodes) {
-        Vector3 trans(0, 0, 0);
-        Vector3 rotate(0, 0, 0);
-        Vector3 center = (node->centroid).template cast<double>();
-        if (node->dynamicID != -1) {
-            if (rotationalInterlockingCheck) {
-                trans = Vector3(solution[node->dynamicID * 6],
-                                solution[node->dynamicID * 6 + 1],
-                                solution[node->dynamicID * 6 + 2]);
-                rotate = -Vector3(solution[node->dynamicID * 6 + 3],
-                                  solution[node->dynamicID * 6 + 4],
-                                  solution[node->dynamicID * 6 + 5]);
-            } else {
-                trans = Vector3(solution[node->dynamicID * 3],
-                                solution[node->dynamicID * 3 + 1],
-                                solution[node->dynamicID * 3 + 2]);
-            }
-        }
-
-        data->traslation.push_back(trans);
-        data->rotation.push_back(rotate);
-        data->center.push_back(center);
-
-//        std::cout << node->staticID << ":" << trans.transpose() << ", " << rotate.transpose() << std::endl;
-    }
 }
 
 /* ------------------------------------------------------------------------------------------------------------------ */
@@ -213,6 +242,8 @@ void InterlockingSolver_Ipopt<Scalar>::unpackSolution(InterlockingSolver_Ipopt::
 IpoptProblem::IpoptProblem() {
     index_style = TNLP::C_STYLE;
     big_m = 5E7;                    // a smaller bigM works 5e6, solving is faster but final lambda is not exactly 0 
+    has_solution = false;
+    verbose = false;
 }
 
 // destructor
@@ -236,20 +267,62 @@ bool IpoptProblem::initialize(EigenSpMat &mat) {
     n_constraints = mat.rows();                   // Constraints inequalities
 
     mat.prune(0.0, 1E-9);
-    b_coeff = mat; 
+    set_coefficients(mat);
 
     set_vectors_dimensions();
     
     set_bounds_info();
 
-    append_bigm_variables(mat);
+    append_bigm_variables();
+
+    non_zero_jacobian_elements = jac_values.size();     // non zero elements in Jacobian (initial B matrix + id(m,m))
+    non_zero_hessian_elements = 0;                      // the problem is linear: the Hessian of the Lagrangian is empty
 
-    non_zero_jacobian_elements = b_coeff.nonZeros();     // non zero elements in Jacobian (initial B matrix + id(m,m))
-    non_zero_hessian_elements = 0;                             // non-zero elements in Lagrangian Hessian
+    return true;
+}
+
+bool IpoptProblem::update(EigenSpMat &mat) {
+    if (mat.rows() != n_constraints || mat.cols() + 1 != n_var) {
+        return false;
+    }
+
+    vector<int> old_rows, old_cols, old_offsets;
+    vector<Number> old_values;
+    old_rows.swap(jac_rows); old_cols.swap(jac_cols);
+    old_offsets.swap(row_offsets); old_values.swap(jac_values);
+
+    mat.prune(0.0, 1E-9);
+    set_coefficients(mat);
+    append_bigm_variables();
+
+    if (jac_rows != old_rows || jac_cols != old_cols) {
+        jac_rows.swap(old_rows); jac_cols.swap(old_cols);
+        row_offsets.swap(old_offsets); jac_values.swap(old_values);
+        return false;
+    }
 
+    set_bounds_info();
     return true;
 }
 
+void IpoptProblem::set_coefficients(const EigenSpMat &mat) {
+    Eigen::SparseMatrix<Number, Eigen::RowMajor> csr = mat;
+    csr.makeCompressed();
+
+    int nnz = csr.nonZeros();
+    jac_rows.resize(nnz);
+    jac_cols.resize(nnz);
+    jac_values.resize(nnz);
+    row_offsets.resize(csr.rows() + 1);
+
+    std::memcpy(row_offsets.data(), csr.outerIndexPtr(), sizeof(int) * (csr.rows() + 1));
+    std::memcpy(jac_cols.data(), csr.innerIndexPtr(), sizeof(int) * nnz);
+    std::memcpy(jac_values.data(), csr.valuePtr(), sizeof(Number) * nnz);
+    for (int r = 0; r < csr.rows(); r++) {
+        std::fill(jac_rows.begin() + row_offsets[r], jac_rows.begin() + row_offsets[r + 1], r);
+    }
+}
+
 void IpoptProblem::set_vectors_dimensions() {
     // allocate size for x vector
     x.resize(n_var);
@@ -262,14 +335,28 @@ void IpoptProblem::set_vectors_dimensions() {
     g_u.resize(n_constraints);
 }
 
-void IpoptProblem::append_bigm_variables(EigenSpMat &mat) {
-    b_coeff.conservativeResize(mat.rows(), n_var);
-    b_coeff.reserve(mat.nonZeros() + mat.rows());
-    for (int c = 0; c < mat.rows(); ++c) {
-        b_coeff.insert(c, n_var-1) = 1.0;
+void IpoptProblem::append_bigm_variables() {
+    // one more nonzero at the end of every row
+    vector<int> rows, cols, offsets(n_constraints + 1);
+    vector<Number> values;
+    rows.reserve(jac_rows.size() + n_constraints);
+    cols.reserve(jac_rows.size() + n_constraints);
+    values.reserve(jac_rows.size() + n_constraints);
+    for (int r = 0; r < n_constraints; r++) {
+        offsets[r] = values.size();
+        rows.insert(rows.end(), jac_rows.begin() + row_offsets[r], jac_rows.begin() + row_offsets[r + 1]);
+        cols.insert(cols.end(), jac_cols.begin() + row_offsets[r], jac_cols.begin() + row_offsets[r + 1]);
+        values.insert(values.end(), jac_values.begin() + row_offsets[r], jac_values.begin() + row_offsets[r + 1]);
+        rows.push_back(r);
+        cols.push_back(n_var - 1);
+        values.push_back(1.0);
     }
-    b_coeff.finalize();
-    b_coeff.prune(0.0, 1E-9);
+    offsets[n_constraints] = values.size();
+
+    jac_rows.swap(rows);
+    jac_cols.swap(cols);
+    jac_values.swap(values);
+    row_offsets.swap(offsets);
 }
 
 // returns the variable bounds
@@ -314,6 +401,16 @@ bool IpoptProblem::set_bounds_info() {
 bool IpoptProblem::get_starting_point(int n, bool init_x, Number *x, bool init_z, Number *z_L, Number *z_U,
                                       int m, bool init_lambda, Number *lambda) {
 
+    if (has_solution) {
+        if (init_x) std::copy(x_solution.data(), x_solution.data() + n, x);
+        if (init_z) {
+            std::copy(z_L_solution.data(), z_L_solution.data() + n, z_L);
+            std::copy(z_U_solution.data(), z_U_solution.data() + n, z_U);
+        }
+        if (init_lambda) std::copy(lambda_solution.data(), lambda_solution.data() + m, lambda);
+        return true;
+    }
+
     for (int i = 0; i < n_var; i++) {
         if (i < n_var_real) {
             this->x[i] = x[i] = 0.0;
@@ -355,64 +452,31 @@ bool IpoptProblem::eval_grad_f(int n, const Number *x, bool new_x, Number *grad_
 // return the value of the constraints: g(x)
 // Computes g = B * X
 bool IpoptProblem::eval_g(int n, const Number *x, bool new_x, int m, Number *g) {
-    Eigen::Map<const Eigen::VectorXd> vecx(x, n);
-    VectorXd vecg = b_coeff * vecx;
-    std::copy(vecg.data(), vecg.data() + m, g);
+    for (int r = 0; r < m; r++) {
+        Number value = 0;
+        for (int k = row_offsets[r]; k < row_offsets[r + 1]; k++) {
+            value += jac_values[k] * x[jac_cols[k]];
+        }
+        g[r] = value;
+    }
     return true;
 }
 
-// return the triplet structure or values of the Jacobian
+// return the triplet structure or values of the Jacobian, B is constant
 bool IpoptProblem::eval_jac_g(int n, const Number *x, bool new_x,
                               int m, int nele_jac, int *iRow, int *jCol, Number *values) {
     if (values == nullptr) {
-        // return the 2 first triplet index row, col for the structure of the Jacobian
-        int idx = 0;
-        for (int k = 0; k < b_coeff.outerSize(); ++k) {
-            for (SparseMatrix<double>::InnerIterator it(b_coeff, k); it; ++it) {
-                iRow[idx] = it.row();
-                jCol[idx] = it.col();
-                idx++;
-            }
-        }
+        std::memcpy(iRow, jac_rows.data(), sizeof(int) * jac_rows.size());
+        std::memcpy(jCol, jac_cols.data(), sizeof(int) * jac_cols.size());
     } else {
-        // loop through B sparse elements and get values.
-        int idx = 0;
-        for (int k = 0; k < b_coeff.outerSize(); ++k) {
-            for (SparseMatrix<double>::InnerIterator it(b_coeff, k); it; ++it) {
-                values[idx] = it.value();
-                idx++;
-            }
-        }
-
+        std::memcpy(values, jac_values.data(), sizeof(Number) * jac_values.size());
     }
     return true;
 }
 
-//return the structure or values of the Hessian
+// the problem is linear: the Hessian of the Lagrangian has no entry, nothing to return
 bool IpoptProblem::eval_h(int n, const Number *x, bool new_x, Number obj_factor, int m, const Number *lambda,
                           bool new_lambda, int nele_hess, int *iRow, int *jCol, Number *values) {
-
-    if (values == nullptr) {
-        // return the structure. This is a symmetric matrix, fill the lower left triangle only.
-        int idx = 0;
-        for (int row = 0; row < non_zero_hessian_elements; row++) {
-            for (int col = 0; col <= row; col++) {
-                iRow[idx] = row;
-                jCol[idx] = col;
-                idx++;
-            }
-        }
-    } else {
-        // Hessian is zero
-        // fixme: faster and neater declaration here
-        int idx = 0;
-        for (int k = 0; k < b_coeff.outerSize(); ++k) {
-            for (SparseMatrix<double>::InnerIterator it(b_coeff, k); it; ++it) {
-                values[idx] = 0;
-            }
-        }
-    }
-
     return true;
 }
 
@@ -439,13 +503,22 @@ void IpoptProblem::finalize_solution(SolverReturn status,
         }
     }
 
-    printf("Maximum |t|:\t %E\n", max_abs_t);
-    printf("Lambda     :\t %E\n", x[n_var-1]);
-    
-    Number sum_g = 0;
-    for (int i = 0; i < m; i++)
-        sum_g+= std::abs(g[i]);
-    printf("Sum of the final values of the constraints:\t %.3f\n", sum_g);
+    z_L_solution = Eigen::Map<const RVectorXd>(z_L, n);
+    z_U_solution = Eigen::Map<const RVectorXd>(z_U, n);
+    lambda_solution = Eigen::Map<const RVectorXd>(lambda, m);
+
+    // the iterate of a failed solve is neither a warm start nor a proof of interlocking
+    has_solution = (status == SUCCESS || status == STOP_AT_ACCEPTABLE_POINT);
+
+    if (verbose) {
+        printf("Maximum |t|:\t %E\n", max_abs_t);
+        printf("Lambda     :\t %E\n", x[n_var-1]);
+
+        Number sum_g = 0;
+        for (int i = 0; i < m; i++)
+            sum_g+= std::abs(g[i]);
+        printf("Sum of the final values of the constraints:\t %.3f\n", sum_g);
+    }
 }
 
 
@@ -7,6 +7,7 @@
 
 #define HAVE_CSTDDEF
 #include "IpTNLP.hpp"
+#include "IpIpoptApplication.hpp"
 #undef HAVE_CSTDDEF
 
 #include "InterlockingSolver.h"
@@ -15,6 +16,7 @@
 
 using namespace Ipopt;
 
+class IpoptProblem;
 
 template<typename Scalar>
 class InterlockingSolver_Ipopt : public InterlockingSolver<Scalar> {
@@ -27,10 +29,24 @@ public:
     typedef Eigen::Matrix<double, 3, 1> Vector3;
 
     using InterlockingSolver<Scalar>::graph;
+    using InterlockingSolver<Scalar>::verbose;
+    using InterlockingSolver<Scalar>::unpackSolution;
+
+private:
+
+    SmartPtr<IpoptApplication> app;     // created once, with its options
+
+    SmartPtr<IpoptProblem> problem;     // the last problem, re-optimized when the next matrix has the same sparsity
+
+public:
+
+    int numProblems;                    // the problems created, a re-optimized one is not counted again
+
+    int numWarmStarts;                  // the solves started from the previous solution
 
 public:
     InterlockingSolver_Ipopt(pContactGraph _graph, shared_ptr<InputVarList> varList) :
-     InterlockingSolver<Scalar>::InterlockingSolver(_graph, varList) {}
+     InterlockingSolver<Scalar>::InterlockingSolver(_graph, varList) { verbose = false; numProblems = 0; numWarmStarts = 0; }
 
 public:
 
@@ -50,10 +66,20 @@ public:
                int num_col,
                int num_var);
 
-    void unpackSolution(InterlockingSolver_Ipopt::pInterlockingData &data, 
-                        bool rotationalInterlockingCheck, 
-                        const double *solution,
-                        int num_var);
+    /**
+     * @brief solve the same matrix once for each lower bound of the rows (zero in solve), in sequence.
+     *        every solve is warm started from the previous one and re-uses the problem structure of Ipopt.
+     */
+    bool solveSequence(vector<pInterlockingData> &datas,
+                       vector<EigenTriple> &tris,
+                       bool rotationalInterlockingCheck,
+                       int num_row,
+                       int num_col,
+                       int num_var,
+                       const vector<Eigen::VectorXd> &rowLowers,
+                       vector<bool> &results);
+
+    void initializeApplication();
 };
 
 
@@ -106,8 +132,11 @@ public:
     RVectorXd x_l, x_u;
     RVectorXd g_l, g_u;
 
-    /** Coefficients matrix */
-    EigenSpMat b_coeff;                 // matrix containing the constraints coefficients.
+    /** Coefficients matrix B, cached once in CSR order: it is both the Jacobian of g = B * X and the data of eval_g */
+    vector<Index> jac_rows;             // row of each nonzero
+    vector<Index> jac_cols;             // column of each nonzero
+    vector<Number> jac_values;          // value of each nonzero
+    vector<Index> row_offsets;          // the nonzeros of row r are [row_offsets[r], row_offsets[r + 1])
 
 
     /** Objective value, x and x_solution vectors */
@@ -119,6 +148,13 @@ public:
     /** big M */
     Number big_m;
 
+    /** Multipliers of the last solution, to warm start the next solve */
+    RVectorXd z_L_solution, z_U_solution;
+    RVectorXd lambda_solution;
+    bool has_solution;
+
+    bool verbose;                       // print the report of finalize_solution
+
     /** Default constructor */
     IpoptProblem();
 
@@ -143,6 +179,13 @@ public:
      */
     bool initialize(EigenSpMat &mat);
 
+    /**
+     * @brief Replace the coefficients by those of mat if it has the same sparsity (after the big M column is appended)
+     *
+     * @return false if the sparsity differs, the problem is then left unchanged
+     */
+    bool update(EigenSpMat &mat);
+
     /**
      * @brief Get the problem bounds conditions
      *
@@ -165,7 +208,12 @@ public:
      *          \ Bm1 ... Bmn | 1 /
      * 
      */
-    void append_bigm_variables(EigenSpMat &mat);
+    void append_bigm_variables();
+
+    /**
+     * @brief Cache the coefficients of mat in CSR order
+     */
+    void set_coefficients(const EigenSpMat &mat);
 
     /**
      * @brief Set the problem bounds conditions. The following vars are set.
@@ -174,7 +222,7 @@ public:
 
     /**
      * @brief  Get the starting point for solving the pb
-     *         Cannot be used for our problem. If we know a starting point, it is not interlocking.
+     *         Zero for a cold start. A warm start (warm_start_init_point) begins from the last solution and its multipliers.
      *
      * @param n number of variables
      * @param init_x
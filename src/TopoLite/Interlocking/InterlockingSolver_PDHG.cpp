@@ -0,0 +1,269 @@
+#include "InterlockingSolver_PDHG.h"
+#include "tbb/tbb.h"
+#include <sstream>
+
+template<typename Scalar>
+bool InterlockingSolver_PDHG<Scalar>::isTranslationalInterlocking(InterlockingSolver_PDHG::pInterlockingData &data) {
+
+    // the parts decided by their normal cones do not enter the LP
+    vector<bool> immobile;
+    int freePartID;
+    typename InterlockingSolver<Scalar>::Vector3 freeDirection;
+    if (!InterlockingSolver<Scalar>::filterTranslationalByNormalCones(immobile, freePartID, freeDirection)) {
+        Eigen::VectorXd solution = Eigen::VectorXd::Zero(3 * graph->dynamic_nodes.size());
+        solution.segment(3 * graph->nodes[freePartID]->dynamicID, 3) = freeDirection;
+        unpackSolution(data, false, solution.data(), solution.size());
+        return false;
+    }
+
+    return solveComponents(data, false, immobile);
+}
+
+template<typename Scalar>
+bool InterlockingSolver_PDHG<Scalar>::isRotationalInterlocking(InterlockingSolver_PDHG::pInterlockingData &data) {
+    return solveComponents(data, true);
+}
+
+template<typename Scalar>
+bool InterlockingSolver_PDHG<Scalar>::solveComponent(const DynamicComponent &component,
+                                                     const vector<int> &localIDs,
+                                                     bool rotationalInterlockingCheck,
+                                                     Eigen::VectorXd &solution) {
+    vector<EigenTriple> tris;
+    Eigen::Vector2i size;
+
+    InterlockingSolver<Scalar>::computePresolvedInterlockingMatrix(component, localIDs, rotationalInterlockingCheck, tris, size);
+
+    // a component without any contact can move freely
+    if (component.edgeIDs.empty()) {
+        solution = Eigen::VectorXd::Zero(size[1]);
+        int dimension = (rotationalInterlockingCheck ? 6 : 3);
+        for(int id = 0; id < component.nodeIDs.size(); id++) solution[id * dimension] = 1;
+        return false;
+    }
+
+    int num_contact_row = size[0];
+    InterlockingSolver<Scalar>::appendMergeConstraints(component, localIDs, tris, size, rotationalInterlockingCheck);
+
+    // the LP cannot tell a motion which touches no contact from an interlocking one
+    if (InterlockingSolver<Scalar>::computeNullSpaceMotion(tris, size, solution)) {
+        std::ostringstream log;
+        log << "null space motion, ||x||: " << solution.norm() << std::endl;
+        if (verbose) std::cout << log.str();
+        return false;
+    }
+
+    return solve(solution, tris, num_contact_row, size[0], size[1]);
+}
+
+template<typename Scalar>
+bool InterlockingSolver_PDHG<Scalar>::solve(Eigen::VectorXd &solution,
+                                            vector<EigenTriple> &tris,
+                                            int num_contact_row,
+                                            int num_row,
+                                            int num_var) {
+
+    //Problem definition (the same LP as InterlockingSolver_Clp::solve)
+    //              min c^T x,    c = -\sum_{i = 0}^{num_contact_row} A_i
+    //  s.t.            1 >= A_i x >= 0     (contact rows)
+    //                       A_j x = 0      (merge rows)
+    // PDHG looks for the saddle point of
+    //      min_x max_y  c^T x + y^T A x - h*(y),     h*(y) = \sum_i u_i max(y_i, 0)
+    // h* being the conjugate of the indicator of the row bounds [0, u], u_i = 1 for contact rows and 0 for merge rows.
+    // the iteration, with the diagonal step sizes tau (columns) and sigma (rows) is:
+    //      x' = x - tau (c + A^T y)
+    //      y' = prox_{sigma h*}(y + sigma A (2x' - x))
+
+    tbb::tick_count sta = tbb::tick_count::now();
+
+    EigenRowSpMat A(num_row, num_var);
+    A.setFromTriplets(tris.begin(), tris.end());
+    EigenRowSpMat AT = A.transpose();
+
+    Eigen::VectorXd rowUpper = Eigen::VectorXd::Zero(num_row);
+    rowUpper.head(num_contact_row).setOnes();
+
+    Eigen::VectorXd objective;
+    multiply(AT, rowUpper, objective);
+    objective = -objective;
+
+    // diagonal preconditioning (Pock & Chambolle 2011, alpha = 1):
+    // tau_j = 1 / \sum_i |A_ij|, sigma_i = 1 / \sum_j |A_ij| ensure || sigma^1/2 A tau^1/2 || <= 1
+    Eigen::VectorXd tau = Eigen::VectorXd::Zero(num_var);
+    Eigen::VectorXd sigma = Eigen::VectorXd::Zero(num_row);
+    for (int row = 0; row < num_row; row++) {
+        for (typename EigenRowSpMat::InnerIterator it(A, row); it; ++it) {
+            sigma[row] += std::abs(it.value());
+            tau[it.col()] += std::abs(it.value());
+        }
+    }
+    for (int id = 0; id < num_var; id++) tau[id] = tau[id] > 0 ? 0.95 / tau[id] : 0;
+    for (int id = 0; id < num_row; id++) sigma[id] = sigma[id] > 0 ? 0.95 / sigma[id] : 0;
+
+    // omega balances the primal and dual step sizes without changing their product
+    double omega = 1;
+
+    PDHGState current, average, last_restart;
+    current.x = Eigen::VectorXd::Zero(num_var);
+    current.ATy = Eigen::VectorXd::Zero(num_var);
+    current.y = Eigen::VectorXd::Zero(num_row);
+    current.Ax = Eigen::VectorXd::Zero(num_row);
+    last_restart = current;
+
+    PDHGState sum = current;
+    int num_average = 0;
+
+    PDHGResidual restart_residual = computeResidual(current, objective, rowUpper, num_contact_row);
+    double last_candidate_error = restart_residual.error;
+
+    int iter = 0, restart_iter = 0, num_restarts = 0;
+    bool converged = false;
+
+    Eigen::VectorXd x_next, Ax_next;
+    while (iter < maxIterations)
+    {
+        iter++;
+
+        // [1] - the primal step, x is free
+        x_next = current.x - (tau / omega).cwiseProduct(objective + current.ATy);
+        multiply(A, x_next, Ax_next);
+
+        // [2] - the dual step, prox_{sigma h*}(v) = v - sigma * clamp(v / sigma, 0, u)
+        for (int id = 0; id < num_row; id++) {
+            double step = sigma[id] * omega;
+            double v = current.y[id] + step * (2 * Ax_next[id] - current.Ax[id]);
+            if (v < 0) current.y[id] = v;
+            else if (v > step * rowUpper[id]) current.y[id] = v - step * rowUpper[id];
+            else current.y[id] = 0;
+        }
+
+        current.x.swap(x_next);
+        current.Ax.swap(Ax_next);
+        multiply(AT, current.y, current.ATy);
+
+        sum.x += current.x; sum.y += current.y;
+        sum.Ax += current.Ax; sum.ATy += current.ATy;
+        num_average++;
+
+        if (iter % restartFrequency != 0) continue;
+
+        // [3] - restart from the average or the current iterate, whichever has the lower KKT error
+        average.x = sum.x / num_average; average.y = sum.y / num_average;
+        average.Ax = sum.Ax / num_average; average.ATy = sum.ATy / num_average;
+
+        PDHGResidual current_residual = computeResidual(current, objective, rowUpper, num_contact_row);
+        PDHGResidual average_residual = computeResidual(average, objective, rowUpper, num_contact_row);
+        bool use_average = average_residual.error < current_residual.error;
+        const PDHGResidual &candidate_residual = use_average ? average_residual : current_residual;
+
+        if (candidate_residual.error <= 1) {
+            if (use_average) current = average;
+            converged = true;
+            break;
+        }
+
+        // a feasible motion which pushes some contact far above the threshold already proves mobility
+        if (current_residual.primal <= 0.1 * INTERLOCKING_THRESHOLD
+            && num_contact_row > 0 && current.Ax.head(num_contact_row).maxCoeff() > 0.5) {
+            converged = true;
+            break;
+        }
+
+        // the restart criteria of PDLP (Applegate et al. 2021), with the KKT error as the progress measure
+        bool restart = candidate_residual.error <= 0.2 * restart_residual.error
+                       || (candidate_residual.error <= 0.8 * restart_residual.error && candidate_residual.error > last_candidate_error)
+                       || (iter - restart_iter) >= 0.36 * iter;
+        last_candidate_error = candidate_residual.error;
+
+        if (restart)
+        {
+            if (use_average) current = average;
+
+            // the primal weight follows the ratio of the dual and primal movements, smoothed in log scale
+            double dx = (current.x - last_restart.x).norm();
+            double dy = (current.y - last_restart.y).norm();
+            if (dx > FLOAT_ERROR_SMALL && dy > FLOAT_ERROR_SMALL) {
+                omega = std::sqrt(omega * dy / dx);
+            }
+
+            last_restart = current;
+            restart_residual = candidate_residual;
+            restart_iter = iter;
+            num_restarts++;
+
+            sum.x.setZero(); sum.y.setZero(); sum.Ax.setZero(); sum.ATy.setZero();
+            num_average = 0;
+        }
+    }
+
+    solution = current.x;
+
+    double max_sol = 0;
+    double min_row_sol = MAX_FLOAT;
+    for (int id = 0; id < num_contact_row; id++) {
+        max_sol = std::max(current.Ax[id], max_sol);
+        min_row_sol = std::min(current.Ax[id], min_row_sol);
+    }
+
+    // components are solved concurrently, so the report is written in one piece
+    std::ostringstream log;
+    log << "min_row:\t" << min_row_sol;
+    log << ",\tmax_t:\t" << max_sol;
+    log << ",\titer:\t" << iter << ",\trestarts:\t" << num_restarts;
+    log << ",\ttime:\t" << (tbb::tick_count::now() - sta).seconds();
+    if (!converged) log << ",\tnot converged";
+    log << std::endl;
+    if (verbose) std::cout << log.str();
+
+    // a small max_t of an unfinished run proves nothing, the assembly is then reported as not interlocking
+    if (!converged) return false;
+
+    return max_sol < INTERLOCKING_THRESHOLD;
+}
+
+template<typename Scalar>
+typename InterlockingSolver_PDHG<Scalar>::PDHGResidual
+InterlockingSolver_PDHG<Scalar>::computeResidual(const PDHGState &state,
+                                                 const Eigen::VectorXd &objective,
+                                                 const Eigen::VectorXd &rowUpper,
+                                                 int num_contact_row)
+{
+    PDHGResidual residual;
+
+    residual.primal = 0;
+    double dual_objective = 0;
+    for (int id = 0; id < state.Ax.size(); id++) {
+        residual.primal = std::max(residual.primal, std::max(-state.Ax[id], state.Ax[id] - rowUpper[id]));
+        dual_objective -= rowUpper[id] * std::max(state.y[id], 0.0);
+    }
+
+    residual.dual = state.ATy.size() > 0 ? (objective + state.ATy).cwiseAbs().maxCoeff() : 0;
+
+    double primal_objective = objective.dot(state.x);
+    residual.gap = std::abs(primal_objective - dual_objective);
+
+    // the rows are bounded in [0, 1], so the primal tolerance is absolute and well below the interlocking threshold
+    double objective_norm = objective.size() > 0 ? objective.cwiseAbs().maxCoeff() : 0;
+    residual.error = std::max(residual.primal / (0.1 * INTERLOCKING_THRESHOLD),
+                     std::max(residual.dual / (relativeTolerance * (1 + objective_norm)),
+                              residual.gap / (relativeTolerance * (1 + std::abs(primal_objective) + std::abs(dual_objective)))));
+    return residual;
+}
+
+template<typename Scalar>
+void InterlockingSolver_PDHG<Scalar>::multiply(const EigenRowSpMat &A, const Eigen::VectorXd &x, Eigen::VectorXd &y)
+{
+    y.resize(A.rows());
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, A.rows()), [&](const tbb::blocked_range<size_t>& r)
+    {
+        for(size_t id = r.begin(); id != r.end(); ++id){
+            double value = 0;
+            for (typename EigenRowSpMat::InnerIterator it(A, id); it; ++it) {
+                value += it.value() * x[it.col()];
+            }
+            y[id] = value;
+        }
+    });
+}
+
+template class InterlockingSolver_PDHG<double>;
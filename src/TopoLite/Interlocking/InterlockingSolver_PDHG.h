@@ -0,0 +1,88 @@
+#ifndef TOPOLITE_INTERLOCKINGSOLVER_PDHG_H
+#define TOPOLITE_INTERLOCKINGSOLVER_PDHG_H
+
+#include "InterlockingSolver.h"
+
+/**
+ * @brief Solve the interlocking LP of InterlockingSolver_Clp with a primal-dual hybrid gradient method (PDHG),
+ *        which only needs products with A and A^T. They are computed in parallel and the memory stays linear in the
+ *        number of nonzeros, so very large assemblies can be checked where the factorizations of Clp/Ipopt do not fit.
+ *        The steps are diagonally preconditioned by the row/column sums of |A|, and the iterates restart from their
+ *        average whenever it has reduced the KKT error enough.
+ *        The feasibility tolerance follows INTERLOCKING_THRESHOLD, the row activity below which a solution is interlocking.
+ * @tparam Scalar
+ */
+template <typename Scalar>
+class InterlockingSolver_PDHG : public InterlockingSolver<Scalar>{
+public:
+    typedef shared_ptr<typename InterlockingSolver<Scalar>::InterlockingData> pInterlockingData;
+    typedef Eigen::SparseMatrix<double, Eigen::RowMajor>  EigenRowSpMat;
+    typedef Eigen::Triplet<double>  EigenTriple;
+    typedef shared_ptr<ContactGraph<Scalar>> pContactGraph;
+    typedef shared_ptr<ContactGraphNode<Scalar>> pContactGraphNode;
+    using InterlockingSolver<Scalar>::graph;
+    using InterlockingSolver<Scalar>::verbose;
+    using InterlockingSolver<Scalar>::solveComponents;
+    using InterlockingSolver<Scalar>::unpackSolution;
+    typedef Matrix<Scalar, 3, 1> Vector3;
+    typedef typename InterlockingSolver<Scalar>::DynamicComponent DynamicComponent;
+
+    struct PDHGState{
+        Eigen::VectorXd x, y;       // primal (velocities) and dual (contact forces) iterates
+        Eigen::VectorXd Ax, ATy;    // their products, kept up to date instead of recomputed
+    };
+
+    struct PDHGResidual{
+        double primal;              // max violation of 0 <= A_i x <= 1 (contact rows), A_j x = 0 (merge rows)
+        double dual;                // max |c + A^T y|
+        double gap;                 // |c^T x - dual objective|
+        double error;               // the largest of the three, relative to its tolerance; converged when <= 1
+    };
+
+public:
+
+    int maxIterations;              // a run stopped by this cap is never reported as interlocking
+
+    int restartFrequency;           // iterations between two evaluations of the restart criteria
+
+    double relativeTolerance;       // of the dual residual and of the duality gap
+
+public:
+    InterlockingSolver_PDHG(pContactGraph _graph, shared_ptr<InputVarList> varList)
+    : InterlockingSolver<Scalar>::InterlockingSolver(_graph, varList),
+    maxIterations(100000), restartFrequency(64), relativeTolerance(1e-6)
+    {
+
+    }
+
+public:
+
+    bool isTranslationalInterlocking(pInterlockingData &data);
+
+    bool isRotationalInterlocking(pInterlockingData &data);
+
+    bool solveComponent(const DynamicComponent &component,
+                        const vector<int> &localIDs,
+                        bool rotationalInterlockingCheck,
+                        Eigen::VectorXd &solution);
+
+    bool solve(Eigen::VectorXd &solution,
+               vector<EigenTriple> &tris,
+               int num_contact_row,
+               int num_row,
+               int num_var);
+
+public:
+
+    // y = A * x, parallel over the rows of A
+    static void multiply(const EigenRowSpMat &A, const Eigen::VectorXd &x, Eigen::VectorXd &y);
+
+private:
+
+    PDHGResidual computeResidual(const PDHGState &state,
+                                 const Eigen::VectorXd &objective,
+                                 const Eigen::VectorXd &rowUpper,
+                                 int num_contact_row);
+};
+
+#endif //TOPOLITE_INTERLOCKINGSOLVER_PDHG_H
@@ -14,7 +14,7 @@
 #include "Utility/HelpDefine.h"
 
 #include "igl/boundary_loop.h"
-#include "igl/readOBJ.h"
+#include "IO/OBJReader.h"
 #include "Polygon.h"
 #include "PolyMesh.h"
 #include <unordered_map>
@@ -567,17 +567,63 @@ bool PolyMesh<Scalar>::readOBJModel(const vector<vector<double>> &V, const vecto
 }
 
 
+template<typename Scalar>
+bool PolyMesh<Scalar>::readOBJModel(const vector<double> &V, const vector<double> &TC, const vector<int> &F, const vector<int> &FTC, const vector<int> &faceOffsets, bool normalized)
+{
+    clear();
+
+    vertexList.resize(V.size() / 3);
+    for(size_t id = 0; id < vertexList.size(); id++)
+    {
+        vertexList[id] = make_shared<VPoint<Scalar>>();
+        vertexList[id]->pos = Vector3(V[3 * id], V[3 * id + 1], V[3 * id + 2]);
+        vertexList[id]->verID = id;
+    }
+
+    textureList.resize(TC.size() / 2);
+    for(size_t id = 0; id < textureList.size(); id++)
+    {
+        textureList[id] = make_shared<VTex<Scalar>>();
+        textureList[id]->texCoord = Vector2(TC[2 * id], TC[2 * id + 1]);
+        textureList[id]->texID = id;
+    }
+
+    polyList.resize(faceOffsets.empty() ? 0 : faceOffsets.size() - 1);
+    for(size_t id = 0; id < polyList.size(); id++)
+    {
+        shared_ptr<_Polygon<Scalar>> poly = make_shared<_Polygon<Scalar>>();
+        poly->vers.reserve(faceOffsets[id + 1] - faceOffsets[id]);
+        for(int jd = faceOffsets[id]; jd < faceOffsets[id + 1]; jd++)
+        {
+            poly->vers.push_back(vertexList[F[jd]]);
+            if(jd < FTC.size() && FTC[jd] >= 0 && FTC[jd] < textureList.size())
+                poly->texs.push_back(textureList[FTC[jd]]);
+        }
+        polyList[id] = poly;
+    }
+
+    texturedModel = !TC.empty();
+
+    if(normalized)
+    {
+        normalize();
+    }
+
+    removeDuplicatedVertices();
+    return true;
+}
+
 template<typename Scalar>
 bool PolyMesh<Scalar>::readOBJModel(
         const char *fileName,
         bool normalized)
 {
-	vector<vector<double>> V, TC, N;
-	vector<vector<int>> F, FTC, FTN;
-    
-	if(igl::readOBJ(fileName, V, TC, N,F, FTC, FTN))
+    OBJReader reader;
+    OBJData data;
+
+	if(reader.read(fileName, data))
 	{
-        return readOBJModel(V, TC, F, FTC, normalized);
+        return readOBJModel(data.V, data.TC, data.F, data.FTC, data.faceOffsets, normalized);
     }
 	else {
 	    return false;
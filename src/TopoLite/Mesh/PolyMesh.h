@@ -153,6 +153,13 @@ public:
      */
     bool readOBJModel(const vector<vector<double>> &V, const vector<vector<double>> &TC, const vector<vector<int>> &F, const vector<vector<int>> &FTC, bool normalized);
 
+    /*!
+     * \brief: Read OBJ File (from flat arrays, see OBJData)
+     * \param faceOffsets: the corners of face i are F[faceOffsets[i]] ... F[faceOffsets[i + 1] - 1]
+     * \param FTC: texture index of every corner, -1 for none
+     */
+    bool readOBJModel(const vector<double> &V, const vector<double> &TC, const vector<int> &F, const vector<int> &FTC, const vector<int> &faceOffsets, bool normalized);
+
     void removeDuplicatedVertices(double eps = FLOAT_ERROR_LARGE);
 
     void mergeFaces(double eps = 1e-3);
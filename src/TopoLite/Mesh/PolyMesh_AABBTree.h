@@ -10,6 +10,10 @@
 #include "Mesh/PolyMesh.h"
 #include <igl/AABB.h>
 #include <igl/boundary_loop.h>
+#include <igl/triangle_triangle_adjacency.h>
+#include <tbb/tbb.h>
+#include <algorithm>
+#include <cstdint>
 
 using Eigen::Vector2d;
 
@@ -276,6 +280,20 @@ public:
     typedef Matrix<Scalar, 3, 1> Vector3;
     typedef Matrix<Scalar, Eigen::Dynamic, 1> VectorX;
     typedef shared_ptr<_Polygon<Scalar>> pPolygon;
+
+    typedef igl::AABB<MatrixX, 2> TexTreeNode;
+
+    /**
+     * @brief Output of a batched texture point query, stored in flat arrays.
+     *        faceIDs[i] is the polygon (in polyList) containing the i-th query or -1,
+     *        triIDs[i] is the fan triangle (row of tF) containing it or -1,
+     *        barycentric[3i ... 3i + 2] are its coordinates w.r.t. the corners of tF.row(triIDs[i]).
+     */
+    struct TexPointQueryResult{
+        vector<int> faceIDs;
+        vector<int> triIDs;
+        vector<Scalar> barycentric;
+    };
     
 public:
     using PolyMesh<Scalar>::texturedModel;
@@ -291,6 +309,10 @@ public:
 
     Eigen::VectorXi tC, pC;
 
+    MatrixXi tTT;   ///> triangle-triangle adjacency of the texture mesh, used as a walking guess by findTexPoints
+
+    const static int texQueryChunkSize = 64;    ///> queries in one chunk share the previous-hit guess
+
 public:
 
     /**
@@ -311,6 +333,7 @@ public:
     {
         PolyMesh<Scalar>::convertTexToEigenMesh(tV, tF, tC);
         texTree.init(tV, tF);
+        if(tF.rows() > 0) igl::triangle_triangle_adjacency(tF, tTT);
 
         MatrixX V, T;
         MatrixXi F;
@@ -342,6 +365,55 @@ public:
         return nullptr;
     }
 
+    /**
+     * @brief Batched version of findTexPoint.
+     *        Queries are sorted along a Morton curve and cut into fixed-size chunks processed in parallel.
+     *        Inside a chunk, the triangle found for the previous query (and its neighbors) is tested first,
+     *        the texture tree is only descended when this guess fails.
+     * @param pts, the 2D query points
+     * @param result, flat arrays of face IDs, fan triangle IDs and barycentric coordinates
+     * @note chunks are fixed, therefore the result does not depend on the thread scheduling.
+     */
+    void findTexPoints(const vector<Vector2> &pts, TexPointQueryResult &result)
+    {
+        size_t num_pts = pts.size();
+        result.faceIDs.assign(num_pts, -1);
+        result.triIDs.assign(num_pts, -1);
+        result.barycentric.assign(num_pts * 3, 0);
+        if(num_pts == 0 || tF.rows() == 0) return;
+
+        // 1) sort the queries by their Morton codes
+        vector<size_t> order;
+        computeMortonOrder(pts, order);
+
+        // 2) locate the queries chunk by chunk
+        tbb::enumerable_thread_specific<vector<const TexTreeNode *>> stacks;
+        size_t num_chunks = (num_pts + texQueryChunkSize - 1) / texQueryChunkSize;
+        tbb::parallel_for(tbb::blocked_range<size_t>(0, num_chunks), [&](const tbb::blocked_range<size_t> &r)
+        {
+            vector<const TexTreeNode *> &stack = stacks.local();
+            for(size_t chunkID = r.begin(); chunkID != r.end(); ++chunkID)
+            {
+                int prev_tri = -1;
+                size_t sta = chunkID * texQueryChunkSize;
+                size_t end = std::min(num_pts, sta + texQueryChunkSize);
+                for(size_t kd = sta; kd < end; kd++)
+                {
+                    size_t qID = order[kd];
+                    Scalar *bary = &result.barycentric[qID * 3];
+                    int triID = findTexTriangleNear(pts[qID], prev_tri, bary);
+                    if(triID == -1) triID = findTexTriangleInTree(pts[qID], stack, bary);
+                    if(triID != -1)
+                    {
+                        result.triIDs[qID] = triID;
+                        result.faceIDs[qID] = tC(triID);
+                        prev_tri = triID;
+                    }
+                }
+            }
+        });
+    }
+
     // fixme: Unused function so far
     bool findBoundaryIntersec(const Line<Scalar> &line, Vector2 &tex2D, Vector3 &pos3D){
         return lineTree.findIntersec(line, tex2D, pos3D);
@@ -350,6 +422,109 @@ public:
     // todo: implement this
     Vector3d findMeshNearestPoint(Vector3 pt);
 
+private:
+
+    /**
+     * @brief Compute the barycentric coordinates of pt w.r.t. the texture triangle triID
+     * @return true if pt is inside the triangle (up to FLOAT_ERROR_SMALL)
+     */
+    bool computeTexTriangleBarycentric(int triID, const Vector2 &pt, Scalar *bary) const
+    {
+        Vector2 a = tV.row(tF(triID, 0)), b = tV.row(tF(triID, 1)), c = tV.row(tF(triID, 2));
+        Vector2 ab = b - a, ac = c - a, ap = pt - a;
+        Scalar det = ab.x() * ac.y() - ab.y() * ac.x();
+        if(std::abs(det) < FLOAT_ERROR_SMALL * FLOAT_ERROR_SMALL) return false;
+        Scalar w1 = (ap.x() * ac.y() - ap.y() * ac.x()) / det;
+        Scalar w2 = (ab.x() * ap.y() - ab.y() * ap.x()) / det;
+        Scalar w0 = 1 - w1 - w2;
+        if(w0 < -FLOAT_ERROR_SMALL || w1 < -FLOAT_ERROR_SMALL || w2 < -FLOAT_ERROR_SMALL) return false;
+        bary[0] = w0; bary[1] = w1; bary[2] = w2;
+        return true;
+    }
+
+    /**
+     * @brief Test the guess triangle and its edge neighbors
+     * @return the triangle containing pt or -1
+     */
+    int findTexTriangleNear(const Vector2 &pt, int guess, Scalar *bary) const
+    {
+        if(guess == -1) return -1;
+        if(computeTexTriangleBarycentric(guess, pt, bary)) return guess;
+        for(int id = 0; id < tTT.cols(); id++)
+        {
+            int neighbor = tTT(guess, id);
+            if(neighbor >= 0 && computeTexTriangleBarycentric(neighbor, pt, bary)) return neighbor;
+        }
+        return -1;
+    }
+
+    /**
+     * @brief Descend the texture tree without recursion, the stack is reused across queries
+     * @return the first triangle containing pt or -1
+     */
+    int findTexTriangleInTree(const Vector2 &pt, vector<const TexTreeNode *> &stack, Scalar *bary) const
+    {
+        stack.clear();
+        stack.push_back(&texTree);
+        while(!stack.empty())
+        {
+            const TexTreeNode *node = stack.back();
+            stack.pop_back();
+            if(node == nullptr || node->m_box.isEmpty()) continue;
+            if(!node->m_box.contains(pt)) continue;
+            if(node->is_leaf())
+            {
+                if(computeTexTriangleBarycentric(node->m_primitive, pt, bary)) return node->m_primitive;
+                continue;
+            }
+            // push right first, so that the left child is visited first as in igl::AABB::find
+            stack.push_back(node->m_right);
+            stack.push_back(node->m_left);
+        }
+        return -1;
+    }
+
+    /**
+     * @brief Sort the points along a Morton (Z-order) curve of their bounding box
+     */
+    void computeMortonOrder(const vector<Vector2> &pts, vector<size_t> &order) const
+    {
+        Vector2 minPt = pts.front(), maxPt = pts.front();
+        for(const Vector2 &pt : pts){
+            minPt = minPt.cwiseMin(pt);
+            maxPt = maxPt.cwiseMax(pt);
+        }
+        Vector2 scale = (maxPt - minPt).cwiseMax(Vector2(FLOAT_ERROR_SMALL, FLOAT_ERROR_SMALL)).cwiseInverse() * 65535.0;
+
+        vector<std::pair<uint32_t, size_t>> keys(pts.size());
+        tbb::parallel_for(tbb::blocked_range<size_t>(0, pts.size()), [&](const tbb::blocked_range<size_t> &r)
+        {
+            for(size_t id = r.begin(); id != r.end(); ++id)
+            {
+                Vector2 q = (pts[id] - minPt).cwiseProduct(scale);
+                uint32_t x = (uint32_t)std::max(Scalar(0), std::min(Scalar(65535), q.x()));
+                uint32_t y = (uint32_t)std::max(Scalar(0), std::min(Scalar(65535), q.y()));
+                keys[id] = std::make_pair(spreadBits(x) | (spreadBits(y) << 1), id);
+            }
+        });
+        tbb::parallel_sort(keys.begin(), keys.end());
+
+        order.resize(pts.size());
+        for(size_t id = 0; id < keys.size(); id++){
+            order[id] = keys[id].second;
+        }
+    }
+
+    static uint32_t spreadBits(uint32_t x)
+    {
+        x &= 0x0000ffff;
+        x = (x | (x << 8)) & 0x00ff00ff;
+        x = (x | (x << 4)) & 0x0f0f0f0f;
+        x = (x | (x << 2)) & 0x33333333;
+        x = (x | (x << 1)) & 0x55555555;
+        return x;
+    }
+
 };
 
 
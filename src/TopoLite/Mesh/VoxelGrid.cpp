@@ -0,0 +1,141 @@
+#include "VoxelGrid.h"
+
+#include <tbb/tbb.h>
+#include <fstream>
+#include <unordered_map>
+
+template<typename Scalar>
+void VoxelGrid<Scalar>::clear()
+{
+    dims = Eigen::Vector3i(0, 0, 0);
+    labels.clear();
+    numParts = 0;
+    voxelSize = 1;
+    origin = Vector3(-0.5, -0.5, 0.5);
+}
+
+template<typename Scalar>
+bool VoxelGrid<Scalar>::readPUZ(const char *fileName)
+{
+    clear();
+
+    std::ifstream filein(fileName);
+    if(filein.fail()) return false;
+
+    // the file lists the columns (grid x), the rows (grid z) and the layers (grid y)
+    int nx = 0, ny = 0, nz = 0;
+    if(!(filein >> nx >> ny >> nz) || nx <= 0 || ny <= 0 || nz <= 0) return false;
+
+    vector<int> _labels((size_t)nx * ny * nz);
+    for(size_t id = 0; id < _labels.size(); id++){
+        if(!(filein >> _labels[id]) || _labels[id] < 0) return false;
+    }
+
+    return setLabels(Eigen::Vector3i(nx, nz, ny), _labels);
+}
+
+template<typename Scalar>
+bool VoxelGrid<Scalar>::setLabels(const Eigen::Vector3i &_dims, const vector<int> &_labels)
+{
+    clear();
+    if(_labels.size() != (size_t)_dims[0] * _dims[1] * _dims[2]) return false;
+
+    // the part k - 1 is named after the label k, a label without any voxel would leave an empty part
+    int maxLabel = _labels.empty() ? 0 : *std::max_element(_labels.begin(), _labels.end());
+    vector<bool> used(maxLabel + 1, false);
+    for(int label: _labels){
+        if(label < 0) return false;
+        used[label] = true;
+    }
+    if(std::find(used.begin() + 1, used.end(), false) != used.end()) return false;
+
+    dims = _dims;
+    labels = _labels;
+    numParts = maxLabel;
+    voxelSize = (Scalar)1.0 / (dims.maxCoeff() + 1);
+    origin = Vector3(-0.5, -0.5, 0.5);
+    return true;
+}
+
+template<typename Scalar>
+size_t VoxelGrid<Scalar>::numVoxels() const
+{
+    return labels.size() - std::count(labels.begin(), labels.end(), 0);
+}
+
+template<typename Scalar>
+void VoxelGrid<Scalar>::getPartMeshes(vector<pPolyMesh> &meshes) const
+{
+    // [1] - bucket the voxels by part
+    vector<vector<size_t>> partVoxels(numParts);
+    for(size_t id = 0; id < labels.size(); id++){
+        if(labels[id] > 0) partVoxels[labels[id] - 1].push_back(id);
+    }
+
+    // [2] - every part keeps the faces whose neighbor has another label
+    meshes.clear();
+    meshes.resize(numParts);
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, numParts), [&](const tbb::blocked_range<size_t>& r)
+    {
+        for(size_t partID = r.begin(); partID != r.end(); ++partID)
+        {
+            vector<double> V, TC;
+            vector<int> F, FTC, faceOffsets = {0};
+            std::unordered_map<size_t, int> gridPointIDs;
+
+            auto vertexID = [&](const Eigen::Vector3i &pt){
+                size_t key = ((size_t)pt[1] * (dims[2] + 1) + pt[2]) * (dims[0] + 1) + pt[0];
+                auto find_it = gridPointIDs.find(key);
+                if(find_it != gridPointIDs.end()) return find_it->second;
+
+                Vector3 pos = position(pt[0], pt[1], pt[2]);
+                V.insert(V.end(), {(double)pos[0], (double)pos[1], (double)pos[2]});
+                int vid = gridPointIDs.size();
+                gridPointIDs[key] = vid;
+                return vid;
+            };
+
+            for(size_t voxelID: partVoxels[partID])
+            {
+                Eigen::Vector3i cell(voxelID % dims[0], voxelID / ((size_t)dims[0] * dims[2]), (voxelID / dims[0]) % dims[2]);
+                for(int axis = 0; axis < 3; axis++)
+                {
+                    for(int side = 0; side <= 1; side++)
+                    {
+                        Eigen::Vector3i neighbor = cell;
+                        neighbor[axis] += side ? 1 : -1;
+                        if(label(neighbor[0], neighbor[1], neighbor[2]) == partID + 1) continue;
+
+                        // the square at cell[axis] + side, its corners turn around the world outward normal
+                        int u = (axis + 1) % 3, v = (axis + 2) % 3;
+                        Eigen::Vector3i corner = cell;
+                        corner[axis] += side;
+                        Eigen::Vector3i corners[4] = {corner, corner, corner, corner};
+                        corners[1][u]++;
+                        corners[2][u]++; corners[2][v]++;
+                        corners[3][v]++;
+
+                        Vector3 normal = axisDirection(axis) * (side ? 1 : -1);
+                        Vector3 p0 = position(corners[0][0], corners[0][1], corners[0][2]);
+                        Vector3 p1 = position(corners[1][0], corners[1][1], corners[1][2]);
+                        Vector3 p2 = position(corners[2][0], corners[2][1], corners[2][2]);
+                        bool reverse = (p1 - p0).cross(p2 - p0).dot(normal) < 0;
+
+                        for(int jd = 0; jd < 4; jd++){
+                            F.push_back(vertexID(corners[reverse ? 3 - jd : jd]));
+                            FTC.push_back(-1);
+                        }
+                        faceOffsets.push_back(F.size());
+                    }
+                }
+            }
+
+            pPolyMesh mesh = make_shared<PolyMesh<Scalar>>(getVarList());
+            mesh->readOBJModel(V, TC, F, FTC, faceOffsets, false);
+            meshes[partID] = mesh;
+        }
+    });
+}
+
+template class VoxelGrid<double>;
+template class VoxelGrid<float>;
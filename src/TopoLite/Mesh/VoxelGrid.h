@@ -0,0 +1,86 @@
+#ifndef TOPOLITE_VOXELGRID_H
+#define TOPOLITE_VOXELGRID_H
+
+#include "TopoLite/Mesh/PolyMesh.h"
+#include "TopoLite/Utility/TopoObject.h"
+
+#include <Eigen/Dense>
+#include <string>
+#include <vector>
+
+/**
+ * @brief A voxel assembly: every cell of a regular grid is empty (label 0) or belongs to the part (label - 1).
+ *        The grid is placed as the part_*.obj exported with the .puz puzzles:
+ *        cell (x, y, z) spans [-0.5 + x * s, -0.5 + (x + 1) * s] * [-0.5 + y * s, -0.5 + (y + 1) * s] * [0.5 - (z + 1) * s, 0.5 - z * s],
+ *        where s = 1 / (max(dims) + 1), i.e. the grid z axis runs along the world -z.
+ * @tparam Scalar
+ */
+template<typename Scalar>
+class VoxelGrid : public TopoObject{
+public:
+    typedef Matrix<Scalar, 3, 1> Vector3;
+
+    typedef shared_ptr<PolyMesh<Scalar>> pPolyMesh;
+
+public:
+
+    Eigen::Vector3i dims;       // number of cells along the grid x, y, z
+
+    vector<int> labels;         // the label of cell (x, y, z) is labels[index(x, y, z)]
+
+    int numParts;               // the largest label, every label from 1 to numParts has voxels
+
+    Scalar voxelSize;
+
+    Vector3 origin;             // the world position of the grid point (0, 0, 0)
+
+public:
+
+    VoxelGrid(shared_ptr<InputVarList> var) : TopoObject(var){
+        clear();
+    }
+
+public:
+
+    void clear();
+
+    /*!
+     * \brief: Read a .puz puzzle: "nx ny nz", then nz layers of ny rows of nx labels.
+     *         A layer of the file is a grid y slice and a row is a grid z row.
+     */
+    bool readPUZ(const char *fileName);
+
+    // false if a label is negative or some label between 1 and the largest one is missing
+    bool setLabels(const Eigen::Vector3i &_dims, const vector<int> &_labels);
+
+    // the boundary faces of each part as unit squares, the same vertices are shared
+    void getPartMeshes(vector<pPolyMesh> &meshes) const;
+
+public:
+
+    size_t index(int x, int y, int z) const{
+        return ((size_t)y * dims[2] + z) * dims[0] + x;
+    }
+
+    // 0 outside of the grid
+    int label(int x, int y, int z) const{
+        if(x < 0 || y < 0 || z < 0 || x >= dims[0] || y >= dims[1] || z >= dims[2]) return 0;
+        return labels[index(x, y, z)];
+    }
+
+    // the world position of a grid point
+    Vector3 position(int x, int y, int z) const{
+        return origin + Vector3(x, y, -z) * voxelSize;
+    }
+
+    // the world direction of the grid axis
+    static Vector3 axisDirection(int axis){
+        Vector3 direction(0, 0, 0);
+        direction[axis] = axis == 2 ? -1 : 1;
+        return direction;
+    }
+
+    size_t numVoxels() const;
+};
+
+#endif //TOPOLITE_VOXELGRID_H
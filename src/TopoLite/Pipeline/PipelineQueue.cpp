@@ -0,0 +1,247 @@
+#include "PipelineQueue.h"
+
+#if defined(GCC_VERSION_LESS_8)
+#include <experimental/filesystem>
+    using namespace std::experimental::filesystem;
+#else
+#include <filesystem>
+using namespace std::filesystem;
+#endif
+
+PipelineQueue::PipelineQueue(int num_workers, int num_threads, int cache_capacity)
+    : arena(std::max(num_threads, 1)), nextID(0), stopped(false), cacheCapacity(std::max(cache_capacity, 0)), cacheClock(0)
+{
+    for(int id = 0; id < std::max(num_workers, 1); id++){
+        workers.push_back(std::thread(&PipelineQueue::work, this));
+    }
+}
+
+PipelineQueue::~PipelineQueue()
+{
+    stop();
+}
+
+int PipelineQueue::submit(const PipelineJob &job, int priority)
+{
+    shared_ptr<JobEntry> entry = make_shared<JobEntry>();
+    entry->priority = priority;
+    entry->job = job;
+    entry->status = JOB_QUEUED;
+    entry->cancelled = false;
+
+    {
+        std::lock_guard<std::mutex> lock(jobMutex);
+        entry->id = nextID++;
+        jobs[entry->id] = entry;
+        queue.insert(std::make_pair(-priority, entry->id));
+    }
+    queueCondition.notify_one();
+    return entry->id;
+}
+
+bool PipelineQueue::cancel(int jobID)
+{
+    std::lock_guard<std::mutex> lock(jobMutex);
+    auto find_it = jobs.find(jobID);
+    if(find_it == jobs.end()) return false;
+
+    shared_ptr<JobEntry> entry = find_it->second;
+    if(entry->status == JOB_QUEUED){
+        queue.erase(std::make_pair(-entry->priority, entry->id));
+        entry->status = JOB_CANCELLED;
+        entry->result.input = entry->job.input;
+        entry->result.error = "cancelled";
+        doneCondition.notify_all();
+        return true;
+    }
+    else if(entry->status == JOB_RUNNING){
+        entry->cancelled = true;
+        return true;
+    }
+    return false;
+}
+
+PipelineQueue::JobStatus PipelineQueue::status(int jobID)
+{
+    std::lock_guard<std::mutex> lock(jobMutex);
+    auto find_it = jobs.find(jobID);
+    if(find_it == jobs.end()) return JOB_UNKNOWN;
+    return find_it->second->status;
+}
+
+bool PipelineQueue::result(int jobID, PipelineResult &result, bool wait)
+{
+    std::unique_lock<std::mutex> lock(jobMutex);
+    auto find_it = jobs.find(jobID);
+    if(find_it == jobs.end()) return false;
+
+    shared_ptr<JobEntry> entry = find_it->second;
+    auto finished = [&]{ return entry->status == JOB_DONE || entry->status == JOB_CANCELLED; };
+    if(wait) doneCondition.wait(lock, [&]{ return finished() || stopped; });
+    if(!finished()) return false;
+
+    result = entry->result;
+    return true;
+}
+
+bool PipelineQueue::release(int jobID)
+{
+    std::lock_guard<std::mutex> lock(jobMutex);
+    auto find_it = jobs.find(jobID);
+    if(find_it == jobs.end()) return false;
+    if(find_it->second->status != JOB_DONE && find_it->second->status != JOB_CANCELLED) return false;
+    jobs.erase(find_it);
+    return true;
+}
+
+void PipelineQueue::stop()
+{
+    {
+        std::lock_guard<std::mutex> lock(jobMutex);
+        if(stopped) return;
+        stopped = true;
+        for(auto &[id, entry]: jobs) entry->cancelled = true;
+    }
+    queueCondition.notify_all();
+    doneCondition.notify_all();
+
+    for(std::thread &worker: workers){
+        if(worker.joinable()) worker.join();
+    }
+}
+
+std::string PipelineQueue::statusName(JobStatus status)
+{
+    switch (status) {
+        case JOB_QUEUED: return "queued";
+        case JOB_RUNNING: return "running";
+        case JOB_DONE: return "done";
+        case JOB_CANCELLED: return "cancelled";
+        default: return "unknown";
+    }
+}
+
+void PipelineQueue::work()
+{
+    while(true)
+    {
+        shared_ptr<JobEntry> entry;
+        {
+            std::unique_lock<std::mutex> lock(jobMutex);
+            queueCondition.wait(lock, [&]{ return stopped || !queue.empty(); });
+            if(stopped) return;
+
+            entry = jobs[queue.begin()->second];
+            queue.erase(queue.begin());
+            entry->status = JOB_RUNNING;
+        }
+
+        // all the workers share the arena, so the thread budget holds across the concurrent jobs
+        arena.execute([&]{ runJob(entry); });
+
+        {
+            std::lock_guard<std::mutex> lock(jobMutex);
+            entry->status = entry->cancelled ? JOB_CANCELLED : JOB_DONE;
+        }
+        doneCondition.notify_all();
+    }
+}
+
+void PipelineQueue::runJob(shared_ptr<JobEntry> entry)
+{
+    tbb::tick_count sta = tbb::tick_count::now();
+
+    const PipelineJob &job = entry->job;
+    PipelineResult &result = entry->result;
+    TopoPipeline<double> pipeline;
+
+    try{
+        CachedParts parts;
+        std::string type = job.parts.empty() ? TopoPipeline<double>::inputType(job.input) : "parts";
+        bool isProject = (type == "xml" || type == "json");
+
+        if(type == "puz"){
+            // a puzzle is read and built on its grid faster than its parts are cached
+            pipeline.checkVoxels(job, result);
+        }
+        else if(isProject && findCachedParts(job.input, parts)){
+            result.input = job.input;
+            result.type = type;
+            result.cached = true;
+        }
+        else{
+            shared_ptr<IOData> data = make_shared<IOData>();
+            if(pipeline.loadParts(job, data, parts.meshes, parts.atBoundary, result)){
+                parts.varList = data->varList;
+                if(isProject) cacheParts(job.input, result.files, parts);
+            }
+        }
+
+        if(!parts.meshes.empty() && !entry->cancelled){
+            pipeline.checkParts(job, parts.varList, parts.meshes, parts.atBoundary, result);
+        }
+    }
+    catch (const std::exception &e){
+        result.success = false;
+        result.error = e.what();
+    }
+
+    if(entry->cancelled){
+        result.success = false;
+        result.error = "cancelled";
+    }
+    result.total_time = (tbb::tick_count::now() - sta).seconds();
+}
+
+bool PipelineQueue::findCachedParts(const std::string &filename, CachedParts &parts)
+{
+    std::map<std::string, std::string> fileTimes;
+    {
+        std::lock_guard<std::mutex> lock(cacheMutex);
+        auto find_it = cache.find(filename);
+        if(find_it == cache.end()) return false;
+        fileTimes = find_it->second.fileTimes;
+    }
+
+    // a changed surface or cross data invalidates the project as well
+    for(auto &[file, time]: fileTimes){
+        if(modificationTime(file) != time) return false;
+    }
+
+    std::lock_guard<std::mutex> lock(cacheMutex);
+    auto find_it = cache.find(filename);
+    if(find_it == cache.end() || find_it->second.fileTimes != fileTimes) return false;
+    find_it->second.lastUse = ++cacheClock;
+    parts = find_it->second;
+    return true;
+}
+
+void PipelineQueue::cacheParts(const std::string &filename, const vector<std::string> &files, const CachedParts &parts)
+{
+    CachedParts entry = parts;
+    entry.fileTimes.clear();
+    entry.fileTimes[filename] = modificationTime(filename);
+    for(const std::string &file: files){
+        entry.fileTimes[file] = modificationTime(file);
+    }
+
+    std::lock_guard<std::mutex> lock(cacheMutex);
+    entry.lastUse = ++cacheClock;
+    cache[filename] = entry;
+
+    // forget the projects used least recently
+    while(cache.size() > cacheCapacity){
+        auto oldest = std::min_element(cache.begin(), cache.end(), [](const auto &a, const auto &b){
+            return a.second.lastUse < b.second.lastUse;
+        });
+        cache.erase(oldest);
+    }
+}
+
+std::string PipelineQueue::modificationTime(const std::string &filename)
+{
+    std::error_code error;
+    auto time = last_write_time(filename, error);
+    if(error) return "";
+    return std::to_string(time.time_since_epoch().count());
+}
@@ -0,0 +1,116 @@
+#ifndef TOPOLITE_PIPELINEQUEUE_H
+#define TOPOLITE_PIPELINEQUEUE_H
+
+#include "TopoPipeline.h"
+
+#include <tbb/tbb.h>
+#include <atomic>
+#include <condition_variable>
+#include <map>
+#include <mutex>
+#include <set>
+#include <thread>
+
+/**
+ * @brief A long-lived scheduler of pipeline jobs for a server.
+ *        The jobs wait in a queue ordered by priority (then by submission) and run on a fixed pool of workers,
+ *        which all execute inside one tbb::task_arena kept for the lifetime of the queue.
+ *        The parts of a project are cached by file and by the modification times of the project and of the files it
+ *        references, a job on an unchanged project only rebuilds its contact graph and solves it.
+ *        The cache keeps the cacheCapacity projects used last.
+ *        A queued job is cancelled at once, a running one at the end of its current stage.
+ */
+class PipelineQueue{
+public:
+    typedef shared_ptr<PolyMesh<double>> pPolyMesh;
+
+    enum JobStatus{
+        JOB_UNKNOWN = 0,
+        JOB_QUEUED = 1,
+        JOB_RUNNING = 2,
+        JOB_DONE = 3,
+        JOB_CANCELLED = 4,
+    };
+
+    struct JobEntry{
+        int id;
+        int priority;
+        PipelineJob job;
+        JobStatus status;
+        PipelineResult result;
+        std::atomic<bool> cancelled;
+    };
+
+    struct CachedParts{
+        std::map<std::string, std::string> fileTimes;   // the modification time of each file read for the project
+        size_t lastUse;
+        shared_ptr<InputVarList> varList;
+        vector<pPolyMesh> meshes;
+        vector<bool> atBoundary;
+    };
+
+public:
+
+    PipelineQueue(int num_workers, int num_threads, int cache_capacity = 16);
+
+    ~PipelineQueue();
+
+public:
+
+    // larger priorities run first
+    int submit(const PipelineJob &job, int priority = 0);
+
+    bool cancel(int jobID);
+
+    JobStatus status(int jobID);
+
+    // false if the job does not exist, or if it is not finished and wait is false
+    bool result(int jobID, PipelineResult &result, bool wait);
+
+    // forget a finished job
+    bool release(int jobID);
+
+    void stop();
+
+    static std::string statusName(JobStatus status);
+
+private:
+
+    void work();
+
+    void runJob(shared_ptr<JobEntry> entry);
+
+    bool findCachedParts(const std::string &filename, CachedParts &parts);
+
+    void cacheParts(const std::string &filename, const vector<std::string> &files, const CachedParts &parts);
+
+    static std::string modificationTime(const std::string &filename);
+
+private:
+
+    tbb::task_arena arena;
+
+    vector<std::thread> workers;
+
+    std::map<int, shared_ptr<JobEntry>> jobs;
+
+    std::set<std::pair<int, int>> queue;        // (-priority, id)
+
+    int nextID;
+
+    bool stopped;
+
+    std::mutex jobMutex;
+
+    std::condition_variable queueCondition, doneCondition;
+
+    std::map<std::string, CachedParts> cache;
+
+    size_t cacheCapacity;
+
+    size_t cacheClock;
+
+    std::mutex cacheMutex;
+};
+
+#endif //TOPOLITE_PIPELINEQUEUE_H
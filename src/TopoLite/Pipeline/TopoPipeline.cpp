@@ -0,0 +1,350 @@
+#include "TopoPipeline.h"
+#include "IO/XMLIO_backward.h"
+#include "IO/JsonIOReader.h"
+#include "IO/OBJReader.h"
+#include "CrossMesh/CrossMeshCreator.h"
+#include "Structure/StrucCreator.h"
+#include "Interlocking/InterlockingSolver_Clp.h"
+#include "Interlocking/InterlockingSolver_PDHG.h"
+
+#include <tbb/tbb.h>
+#include <algorithm>
+
+nlohmann::json PipelineResult::to_json() const
+{
+    nlohmann::json json;
+    json["input"] = input;
+    json["type"] = type;
+    json["success"] = success;
+    if(!success) json["error"] = error;
+    json["num_parts"] = num_parts;
+    json["num_contacts"] = num_contacts;
+    json["is_interlocking"] = is_interlocking;
+    json["cached"] = cached;
+    if(!files.empty()) json["files"] = files;
+    json["read_time"] = read_time;
+    json["structure_time"] = structure_time;
+    json["contact_time"] = contact_time;
+    json["solve_time"] = solve_time;
+    json["total_time"] = total_time;
+    return json;
+}
+
+template<typename Scalar>
+PipelineResult TopoPipeline<Scalar>::run(const PipelineJob &job)
+{
+    tbb::tick_count sta = tbb::tick_count::now();
+
+    PipelineResult result;
+    try{
+        if(job.parts.empty() && inputType(job.input) == "puz"){
+            checkVoxels(job, result);
+            result.total_time = (tbb::tick_count::now() - sta).seconds();
+            return result;
+        }
+
+        shared_ptr<IOData> data = make_shared<IOData>();
+        vector<pPolyMesh> meshes;
+        vector<bool> atBoundary;
+        if(loadParts(job, data, meshes, atBoundary, result)){
+            checkParts(job, data->varList, meshes, atBoundary, result);
+        }
+    }
+    catch (const std::exception &e){
+        result.success = false;
+        result.error = e.what();
+    }
+
+    result.total_time = (tbb::tick_count::now() - sta).seconds();
+    return result;
+}
+
+template<typename Scalar>
+bool TopoPipeline<Scalar>::loadParts(const PipelineJob &job,
+                                     shared_ptr<IOData> &data,
+                                     vector<pPolyMesh> &meshes,
+                                     vector<bool> &atBoundary,
+                                     PipelineResult &result)
+{
+    result.input = job.input;
+    result.type = job.parts.empty() ? inputType(job.input) : "parts";
+
+    if(result.type == "parts"){
+        meshes = job.parts;
+        atBoundary = job.partAtBoundary;
+        atBoundary.resize(meshes.size(), false);
+    }
+    else if(result.type == "obj"){
+        tbb::tick_count sta = tbb::tick_count::now();
+        if(!readParts(job.input, job.boundaryParts, data->varList, meshes, atBoundary)){
+            result.error = "no readable .obj part in the directory";
+        }
+        result.read_time = (tbb::tick_count::now() - sta).seconds();
+    }
+    else if(result.type == "puz"){
+        tbb::tick_count sta = tbb::tick_count::now();
+        VoxelGrid<Scalar> grid(data->varList);
+        if(readVoxels(job.input, job.boundaryParts, grid, atBoundary)){
+            grid.getPartMeshes(meshes);
+        }
+        else{
+            result.error = "cannot read the puzzle";
+        }
+        result.read_time = (tbb::tick_count::now() - sta).seconds();
+    }
+    else if(!result.type.empty()){
+        createStructure(job.input, data, meshes, atBoundary, result);
+    }
+    else{
+        result.error = "unknown input type";
+    }
+
+    if(meshes.empty() && result.error.empty()){
+        result.error = "no part is created";
+    }
+    return !meshes.empty();
+}
+
+template<typename Scalar>
+void TopoPipeline<Scalar>::checkParts(const PipelineJob &job,
+                                      shared_ptr<InputVarList> varList,
+                                      const vector<pPolyMesh> &meshes,
+                                      vector<bool> atBoundary,
+                                      PipelineResult &result)
+{
+    result.num_parts = meshes.size();
+
+    tbb::tick_count sta = tbb::tick_count::now();
+    pContactGraph graph = make_shared<ContactGraph<Scalar>>(varList);
+    graph->buildFromMeshes(meshes, atBoundary, job.contactEps, false);
+    result.num_contacts = graph->edges.size();
+    result.contact_time = (tbb::tick_count::now() - sta).seconds();
+
+    solve(job, graph, varList, result);
+}
+
+template<typename Scalar>
+void TopoPipeline<Scalar>::checkVoxels(const PipelineJob &job, PipelineResult &result)
+{
+    result.input = job.input;
+    result.type = "puz";
+
+    tbb::tick_count sta = tbb::tick_count::now();
+    shared_ptr<InputVarList> varList = make_shared<InputVarList>();
+    InitVar(varList.get());
+    VoxelGrid<Scalar> grid(varList);
+    vector<bool> atBoundary;
+    bool read = readVoxels(job.input, job.boundaryParts, grid, atBoundary);
+    result.read_time = (tbb::tick_count::now() - sta).seconds();
+    if(!read){
+        result.error = "cannot read the puzzle";
+        return;
+    }
+    result.num_parts = grid.numParts;
+
+    sta = tbb::tick_count::now();
+    pContactGraph graph = make_shared<ContactGraph<Scalar>>(varList);
+    graph->buildFromVoxels(grid, atBoundary, false);
+    result.num_contacts = graph->edges.size();
+    result.contact_time = (tbb::tick_count::now() - sta).seconds();
+
+    solve(job, graph, varList, result);
+}
+
+template<typename Scalar>
+void TopoPipeline<Scalar>::solve(const PipelineJob &job, pContactGraph graph, shared_ptr<InputVarList> varList, PipelineResult &result)
+{
+    tbb::tick_count sta = tbb::tick_count::now();
+    pInterlockingSolver solver = createSolver(graph, varList, job.solverType);
+    shared_ptr<typename InterlockingSolver<Scalar>::InterlockingData> interlockData;
+    if(job.rotational)
+        result.is_interlocking = solver->isRotationalInterlocking(interlockData);
+    else
+        result.is_interlocking = solver->isTranslationalInterlocking(interlockData);
+    result.solve_time = (tbb::tick_count::now() - sta).seconds();
+
+    result.success = true;
+}
+
+template<typename Scalar>
+bool TopoPipeline<Scalar>::createStructure(const std::string &filename,
+                                           shared_ptr<IOData> &data,
+                                           vector<pPolyMesh> &meshes,
+                                           vector<bool> &atBoundary,
+                                           PipelineResult &result)
+{
+    //0) read the project
+    tbb::tick_count sta = tbb::tick_count::now();
+    bool read = false;
+    if(result.type == "xml"){
+        XMLIO_backward IO;
+        read = IO.XMLReader(filename, *data) && data->varList;
+        if(read) data->varList->add((int)1, "layerOfBoundary",  "");
+
+        // the surfaces and the cross data referenced by the project
+        result.files = {filename};
+        for(auto &[file, time]: IO.loadTimes){
+            if(file != filename) result.files.push_back(file);
+        }
+    }
+    else{
+        JsonIOReader reader(filename, data);
+        read = reader.read();
+        result.files = {filename};
+    }
+    result.read_time = (tbb::tick_count::now() - sta).seconds();
+    if(!read){
+        result.error = "cannot read the project";
+        return false;
+    }
+
+    //1) the cross mesh, as in the TopoCreator
+    sta = tbb::tick_count::now();
+    shared_ptr<CrossMeshCreator<Scalar>> crossMeshCreator = make_shared<CrossMeshCreator<Scalar>>(data->varList);
+    if(data->reference_surface){
+        crossMeshCreator->setReferenceSurface(data->reference_surface);
+    }
+    if(data->pattern_mesh){
+        crossMeshCreator->setPatternMesh(data->pattern_mesh);
+    }
+
+    if(data->cross_mesh != nullptr){
+        crossMeshCreator->setCrossMesh(data->cross_mesh);
+        crossMeshCreator->updateCrossMeshBoundary(data->varList->getIntList("boundary_crossIDs"));
+    }
+    else if(data->reference_surface != nullptr && data->pattern_mesh != nullptr){
+        crossMeshCreator->createCrossMeshFromRSnPattern(false, data->varList->getMatrix4d("texturedMat"));
+        crossMeshCreator->createAugmentedVectors();
+    }
+
+    //2) the blocks
+    if(crossMeshCreator->crossMesh){
+        StrucCreator<Scalar> strucCreator(data->varList);
+        strucCreator.compute(crossMeshCreator->crossMesh);
+        for(auto block: strucCreator.blocks){
+            if(block && block->polyMesh){
+                meshes.push_back(block->polyMesh);
+                atBoundary.push_back(block->at_boundary());
+            }
+        }
+    }
+    result.structure_time = (tbb::tick_count::now() - sta).seconds();
+
+    if(meshes.empty()){
+        result.error = "no cross mesh in the project";
+        return false;
+    }
+    return true;
+}
+
+template<typename Scalar>
+bool TopoPipeline<Scalar>::readParts(const std::string &dirname,
+                                     const vector<std::string> &boundaryParts,
+                                     shared_ptr<InputVarList> varList,
+                                     vector<pPolyMesh> &meshes,
+                                     vector<bool> &atBoundary)
+{
+    vector<path> files;
+    for(const auto &entry: directory_iterator(dirname)){
+        if(entry.path().extension() == ".obj") files.push_back(entry.path());
+    }
+    std::sort(files.begin(), files.end());
+
+    vector<std::string> filenames;
+    atBoundary.resize(files.size());
+    for(size_t id = 0; id < files.size(); id++)
+    {
+        filenames.push_back(files[id].string());
+
+        std::string stem = files[id].stem().string();
+        std::string lower = stem;
+        std::transform(lower.begin(), lower.end(), lower.begin(), ::tolower);
+        atBoundary[id] = lower.find("boundary") != std::string::npos
+                || std::find(boundaryParts.begin(), boundaryParts.end(), stem) != boundaryParts.end();
+    }
+
+    if(!OBJReader::readMeshes(filenames, varList, meshes, false)){
+        meshes.clear();
+        atBoundary.clear();
+        return false;
+    }
+
+    // the contact tolerance is relative to the unit box, as in the StructureChecker
+    Box<Scalar> bbx;
+    for(auto mesh: meshes){
+        Box<Scalar> meshbbx = mesh->bbox();
+        if(bbx.size.norm() < FLOAT_ERROR_SMALL){
+            bbx = meshbbx;
+        }
+        else{
+            bbx = Box<Scalar>(bbx, meshbbx);
+        }
+    }
+
+    if(bbx.size.norm() > FLOAT_ERROR_LARGE){
+        Scalar scaleFactor = std::min(1.0 / bbx.size[0], std::min(1.0 / bbx.size[1], 1.0 / bbx.size[2]));
+        for(auto mesh: meshes){
+            mesh->scaleMesh(Matrix<Scalar, 3, 1>(scaleFactor, scaleFactor, scaleFactor));
+        }
+    }
+
+    return !meshes.empty();
+}
+
+template<typename Scalar>
+bool TopoPipeline<Scalar>::readVoxels(const std::string &filename,
+                                      const vector<std::string> &boundaryParts,
+                                      VoxelGrid<Scalar> &grid,
+                                      vector<bool> &atBoundary)
+{
+    if(!grid.readPUZ(filename.c_str()) || grid.numParts == 0) return false;
+
+    atBoundary.assign(grid.numParts, false);
+    for(int id = 0; id < grid.numParts; id++){
+        std::string name = "part_" + std::to_string(id + 1);
+        atBoundary[id] = std::find(boundaryParts.begin(), boundaryParts.end(), name) != boundaryParts.end();
+    }
+    return true;
+}
+
+template<typename Scalar>
+typename TopoPipeline<Scalar>::pInterlockingSolver TopoPipeline<Scalar>::createSolver(pContactGraph graph,
+                                                                                      shared_ptr<InputVarList> varList,
+                                                                                      int solverType)
+{
+    switch (solverType) {
+        case CLP_BARRIER:{
+            auto solver = make_shared<InterlockingSolver_Clp<Scalar>>(graph, varList, BARRIER);
+            solver->verbose = false;
+            return solver;
+        }
+        case PDHG:{
+            auto solver = make_shared<InterlockingSolver_PDHG<Scalar>>(graph, varList);
+            solver->verbose = false;
+            return solver;
+        }
+        default:{
+            auto solver = make_shared<InterlockingSolver_Clp<Scalar>>(graph, varList, SIMPLEX);
+            solver->verbose = false;
+            return solver;
+        }
+    }
+}
+
+/**
+ * @return "xml", "json", "puz", "obj" for a directory of parts, or an empty string.
+ */
+template<typename Scalar>
+std::string TopoPipeline<Scalar>::inputType(const std::string &input)
+{
+    path input_path(input);
+    if(is_directory(input_path)) return "obj";
+    std::string extension = input_path.extension().string();
+    std::transform(extension.begin(), extension.end(), extension.begin(), ::tolower);
+    if(extension == ".xml") return "xml";
+    if(extension == ".json") return "json";
+    if(extension == ".puz") return "puz";
+    return "";
+}
+
+template class TopoPipeline<double>;
@@ -0,0 +1,107 @@
+#ifndef TOPOLITE_TOPOPIPELINE_H
+#define TOPOLITE_TOPOPIPELINE_H
+
+#include "IO/IOData.h"
+#include "Interlocking/ContactGraph.h"
+#include "Interlocking/InterlockingSolver.h"
+
+#include <nlohmann/json.hpp>
+#include <string>
+#include <vector>
+
+/**
+ * @brief One input of the pipeline: a .xml/.json project, a directory of .obj parts, a .puz voxel puzzle, or the parts themselves.
+ */
+struct PipelineJob{
+    std::string input;
+
+    vector<shared_ptr<PolyMesh<double>>> parts;     // used instead of the input when it is not empty, in the unit box
+    vector<bool> partAtBoundary;
+
+    vector<std::string> boundaryParts;  // stems of the .obj parts fixed as boundary, besides the ones named "*boundary*",
+                                        // "part_k" for the label k of a .puz puzzle
+
+    int solverType = 0;                 // TopoPipeline::SolverType
+
+    bool rotational = true;
+
+    float contactEps = 1e-3;
+};
+
+/**
+ * @brief The outcome of one job, written as one JSON line.
+ *        The times are in seconds, a stage which did not run takes 0.
+ */
+struct PipelineResult{
+    std::string input;
+    std::string type;                   // "xml", "json", "obj", "puz" or "parts"
+    bool success = false;
+    std::string error;
+
+    int num_parts = 0;
+    int num_contacts = 0;
+    bool is_interlocking = false;
+    bool cached = false;                // the parts of the project were reused from an earlier job
+    vector<std::string> files;          // the files read for a project, the project first
+
+    double read_time = 0;
+    double structure_time = 0;          // cross mesh and blocks, for the projects only
+    double contact_time = 0;
+    double solve_time = 0;
+    double total_time = 0;
+
+    nlohmann::json to_json() const;
+};
+
+/**
+ * @brief The headless cross mesh -> structure -> contact graph -> interlocking pipeline.
+ *        The projects are set up as in the TopoCreator, the .obj part sets as in the StructureChecker.
+ *        A run only touches its own data, so several runs can proceed concurrently.
+ * @tparam Scalar
+ */
+template<typename Scalar>
+class TopoPipeline{
+public:
+    typedef shared_ptr<PolyMesh<Scalar>> pPolyMesh;
+    typedef shared_ptr<ContactGraph<Scalar>> pContactGraph;
+    typedef shared_ptr<InterlockingSolver<Scalar>> pInterlockingSolver;
+
+    enum SolverType{
+        CLP_SIMPLEX = 0,
+        CLP_BARRIER = 1,
+        PDHG = 3
+    };
+
+public:
+
+    PipelineResult run(const PipelineJob &job);
+
+    // step 1: the parts of the job, false if there is none
+    bool loadParts(const PipelineJob &job, shared_ptr<IOData> &data, vector<pPolyMesh> &meshes, vector<bool> &atBoundary, PipelineResult &result);
+
+    // step 2: the contact graph of the parts and the interlocking check, the parts are not modified
+    void checkParts(const PipelineJob &job, shared_ptr<InputVarList> varList, const vector<pPolyMesh> &meshes, vector<bool> atBoundary, PipelineResult &result);
+
+    // steps 1 and 2 of a .puz puzzle, its contact graph is built on the grid without any part mesh
+    void checkVoxels(const PipelineJob &job, PipelineResult &result);
+
+public:
+
+    // read a project and build its cross mesh and blocks
+    bool createStructure(const std::string &filename, shared_ptr<IOData> &data, vector<pPolyMesh> &meshes, vector<bool> &atBoundary, PipelineResult &result);
+
+    // read the .obj files of a directory in name order, scaled into the unit box
+    bool readParts(const std::string &dirname, const vector<std::string> &boundaryParts, shared_ptr<InputVarList> varList,
+                   vector<pPolyMesh> &meshes, vector<bool> &atBoundary);
+
+    // read a .puz puzzle, the part k - 1 is named "part_k"
+    bool readVoxels(const std::string &filename, const vector<std::string> &boundaryParts, VoxelGrid<Scalar> &grid, vector<bool> &atBoundary);
+
+    void solve(const PipelineJob &job, pContactGraph graph, shared_ptr<InputVarList> varList, PipelineResult &result);
+
+    static pInterlockingSolver createSolver(pContactGraph graph, shared_ptr<InputVarList> varList, int solverType);
+
+    static std::string inputType(const std::string &input);
+};
+
+#endif //TOPOLITE_TOPOPIPELINE_H
@@ -16,6 +16,7 @@
 
 #include <Eigen/Dense>
 #include <vector>
+#include <algorithm>
 #include "HelpDefine.h"
 
 using Eigen::Matrix;
@@ -26,6 +27,8 @@ class ConvexHull2D{
 public:
     typedef Matrix<Scalar, 3, 1> Vector3;
     typedef std::vector<Matrix<Scalar, 3, 1>> ListVector3;
+    typedef Matrix<Scalar, 2, 1> Vector2;
+    typedef std::vector<Matrix<Scalar, 2, 1>> ListVector2;
 
     ConvexHull2D(){
 
@@ -38,10 +41,18 @@ public:
 
     void compute(const ListVector3 &in, Vector3 normal, ListVector3 &out);
 
+    // Chain Hull Algorithm on projected points, "in" is sorted in place
+    void compute(ListVector2 &in, ListVector2 &out);
+
+    // 2D frame of the plane with the given normal
+    void computeFrame(const Vector3 &normal, Vector3 &x_axis, Vector3 &y_axis);
+
 private:
 
     Scalar cross(const Vector3 &O, const Vector3 &A, const Vector3 &B);
 
+    Scalar cross(const Vector2 &O, const Vector2 &A, const Vector2 &B);
+
     // Sort Points Based on X - and Y - coordinate
     void sortXY(ListVector3 &Array);
 };
@@ -92,15 +103,41 @@ void ConvexHull2D<Scalar>::compute(const ListVector3 &in, ListVector3 &out)
 }
 
 template<typename Scalar>
-void ConvexHull2D<Scalar>::compute(const ListVector3 &in, Vector3 normal, ListVector3 &out){
+void ConvexHull2D<Scalar>::compute(ListVector2 &in, ListVector2 &out)
+{
+    out.clear();
+    int n = in.size(), k = 0;
+    if (n <= 1){
+        return;
+    }
 
-    Vector3 center(0, 0, 0);
-    for(Vector3 pt: in){
-        center += pt;
+    out.resize(2 * n);
+
+    // Sort points lexicographically
+    std::sort(in.begin(), in.end(), [](const Vector2 &a, const Vector2 &b){
+        return a.x() < b.x() || (a.x() == b.x() && a.y() < b.y());
+    });
+
+    // Build lower hull
+    for (int i = 0; i < n; ++i) {
+        while (k >= 2 && cross(out[k - 2], out[k - 1], in[i]) <= 0) k--;
+        out[k++] = in[i];
     }
-    center /= in.size();
 
-    Vector3 x_axis, y_axis;
+    // Build upper hull
+    for (int i = n - 2, t = k + 1; i >= 0; i--) {
+        while (k >= t && cross(out[k - 2], out[k - 1], in[i]) <= 0) k--;
+        out[k++] = in[i];
+    }
+
+    out.resize(k - 1);
+
+    reverse(out.begin(), out.end());
+}
+
+template<typename Scalar>
+void ConvexHull2D<Scalar>::computeFrame(const Vector3 &normal, Vector3 &x_axis, Vector3 &y_axis)
+{
     x_axis = normal.cross(Vector3(1, 0, 0));
     if(x_axis.norm() < FLOAT_ERROR_LARGE)
         x_axis = normal.cross(Vector3(0, 1, 0));
@@ -108,16 +145,31 @@ void ConvexHull2D<Scalar>::compute(const ListVector3 &in, Vector3 normal, ListVe
 
     y_axis = normal.cross(x_axis);
     y_axis.normalize();
+}
+
+template<typename Scalar>
+void ConvexHull2D<Scalar>::compute(const ListVector3 &in, Vector3 normal, ListVector3 &out){
+
+    Vector3 center(0, 0, 0);
+    for(const Vector3 &pt: in){
+        center += pt;
+    }
+    center /= in.size();
+
+    Vector3 x_axis, y_axis;
+    computeFrame(normal, x_axis, y_axis);
 
-    ListVector3 in2D;
-    for(Vector3 pt: in){
-        in2D.push_back(Vector3((pt - center).dot(x_axis), (pt - center).dot(y_axis), 0));
+    ListVector2 in2D, out2D;
+    in2D.reserve(in.size());
+    for(const Vector3 &pt: in){
+        in2D.push_back(Vector2((pt - center).dot(x_axis), (pt - center).dot(y_axis)));
     }
 
-    compute(in2D, out);
+    compute(in2D, out2D);
 
-    for(Vector3 &pt: out){
-        pt = pt[0] * x_axis + pt[1] * y_axis + center;
+    out.clear();
+    for(const Vector2 &pt: out2D){
+        out.push_back(pt[0] * x_axis + pt[1] * y_axis + center);
     }
 
     return;
@@ -135,6 +187,12 @@ Scalar ConvexHull2D<Scalar>::cross(const Vector3 &O, const Vector3 &A, const Vec
     return (A.x() - O.x()) * (B.y() - O.y()) - (A.y() - O.y()) * (B.x() - O.x());
 }
 
+template<typename Scalar>
+Scalar ConvexHull2D<Scalar>::cross(const Vector2 &O, const Vector2 &A, const Vector2 &B)
+{
+    return (A.x() - O.x()) * (B.y() - O.y()) - (A.y() - O.y()) * (B.x() - O.x());
+}
+
 
 
 //**************************************************************************************//
@@ -45,6 +45,7 @@
 
 #define FLOAT_ERROR_SMALL           1e-7
 #define FLOAT_ERROR_LARGE           1e-5
+#define INTERLOCKING_THRESHOLD      5e-6    // max contact activity of an interlocking LP solution
 #define CLIPPER_INTERGER_SCALE      1e8f
 
 
@@ -0,0 +1,36 @@
+#ifndef TOPOLITE_PARALLELPREFIXSUM_H
+#define TOPOLITE_PARALLELPREFIXSUM_H
+
+#include <tbb/tbb.h>
+#include <vector>
+
+/**
+ * @brief Exclusive prefix sum used by the count-then-fill passes.
+ *        offsets has counts.size() + 1 entries, the items of i are written in [offsets[i], offsets[i + 1]).
+ *        The result does not depend on the thread scheduling.
+ * @return the total count
+ */
+template<typename Count>
+size_t computeParallelPrefixSum(const std::vector<Count> &counts, std::vector<size_t> &offsets)
+{
+    offsets.resize(counts.size() + 1);
+    offsets[0] = 0;
+    size_t total = tbb::parallel_scan(
+            tbb::blocked_range<size_t>(0, counts.size()),
+            size_t(0),
+            [&](const tbb::blocked_range<size_t>& r, size_t sum, bool is_final_scan)->size_t {
+                for(size_t id = r.begin(); id != r.end(); ++id)
+                {
+                    sum += counts[id];
+                    if(is_final_scan) offsets[id + 1] = sum;
+                }
+                return sum;
+            },
+            [](size_t x, size_t y)->size_t {
+                return x + y;
+            }
+    );
+    return total;
+}
+
+#endif //TOPOLITE_PARALLELPREFIXSUM_H
@@ -3,6 +3,7 @@
 
 #include <clipper.hpp>
 #include <cmath>
+#include <algorithm>
 #include <Eigen/Dense>
 
 #include "TopoObject.h"
@@ -33,6 +34,18 @@ public:
 
     void computePolygonsIntersection(const PolyVector3 &polyA, const PolyVector3 &polyB, PolysVector3 &polyIntsec);
 
+    void computePolygonsIntersection_Clipper(const PolyVector3 &polyA, const PolyVector3 &polyB, PolysVector3 &polyIntsec);
+
+    bool computePolygonsIntersection_Convex(const PolyVector3 &polyA, const PolyVector3 &polyB, PolysVector3 &polyIntsec);
+
+    /*!
+     * \brief: append the intersection polygons into a flat buffer.
+     *          polyEnds stores the end of each polygon in points, the caller starts it with {0}.
+     *          polygons with less than 3 points are skipped.
+     *          the scratch buffers of this object are reused, so one object per thread avoids allocation per call.
+     */
+    void computePolygonsIntersection(const PolyVector3 &polyA, const PolyVector3 &polyB, PolyVector3 &points, vector<size_t> &polyEnds);
+
     bool check2DPolygonsIntersection(const PolyVector2 &polyA, const PolyVector2 &polyB, Scalar &area);
 
 public:
@@ -51,9 +64,31 @@ public:
 
     Vector3 computeCenter(const PolyVector3 &poly);
 
+    Scalar computeSignedArea(const PolyVector2 &poly);
+
+    bool isConvex(const PolyVector2 &poly);
+
+    void clipByHalfPlane(const PolyVector2 &subject, const Vector2 &sta, const Vector2 &end, Scalar offset, PolyVector2 &out);
+
     ClipperLib::Path projectToNormalPlane(const PolyVector3 &poly, Vector3 xaxis, Vector3 yaxis, Vector3 origin, Scalar Scale);
 
     PolyVector3 projectTo3D(const ClipperLib::Path &path, Vector3 xaxis, Vector3 yaxis, Vector3 origin, Scalar scale);
+
+private:
+
+    bool clipConvexPolygons(const PolyVector3 &polyA, const PolyVector3 &polyB);
+
+private:
+
+    // scratch buffers, reused from one call to the next
+    PolysVector2 scratch_polys2D;
+    PolyVector2 scratch_subject, scratch_clipped;
+    PolyVector3 scratch_polylist;                   // result of clipConvexPolygons
+    PolysVector3 scratch_polylists;
+
+    ClipperLib::Clipper clipper_solver;
+    ClipperLib::ClipperOffset clipper_offset;
+    ClipperLib::Paths clipper_paths;
 };
 
 template<typename Scalar>
@@ -126,6 +161,17 @@ template<typename Scalar>
 void PolyPolyBoolean<Scalar>::computePolygonsIntersection(const PolyPolyBoolean::PolyVector3 &polyA,
                                                           const PolyPolyBoolean::PolyVector3 &polyB,
                                                           PolyPolyBoolean::PolysVector3 &polyIntsec) {
+    // faces of convex parts are convex, Clipper is only needed for the general case
+    if(computePolygonsIntersection_Convex(polyA, polyB, polyIntsec))
+        return;
+
+    computePolygonsIntersection_Clipper(polyA, polyB, polyIntsec);
+}
+
+template<typename Scalar>
+void PolyPolyBoolean<Scalar>::computePolygonsIntersection_Clipper(const PolyPolyBoolean::PolyVector3 &polyA,
+                                                                  const PolyPolyBoolean::PolyVector3 &polyB,
+                                                                  PolyPolyBoolean::PolysVector3 &polyIntsec) {
     polyIntsec.clear();
 
     Vector3 x_axis, y_axis, origin;
@@ -141,13 +187,16 @@ void PolyPolyBoolean<Scalar>::computePolygonsIntersection(const PolyPolyBoolean:
     pathA = projectToNormalPlane(polyA, x_axis, y_axis, origin, Scale);
     pathB = projectToNormalPlane(polyB, x_axis, y_axis, origin, Scale);
 
-    ClipperLib::Clipper solver;
+    ClipperLib::Clipper &solver = clipper_solver;
+    solver.Clear();
     solver.AddPath(pathA, ClipperLib::ptSubject, true);
     solver.AddPath(pathB, ClipperLib::ptClip, true);
-    ClipperLib::Paths path_int;
+    ClipperLib::Paths &path_int = clipper_paths;
+    path_int.clear();
     solver.StrictlySimple(true);
     solver.Execute(ClipperLib::ctIntersection, path_int, ClipperLib::pftEvenOdd, ClipperLib::pftEvenOdd);
-    ClipperLib::ClipperOffset offset;
+    ClipperLib::ClipperOffset &offset = clipper_offset;
+    offset.Clear();
     offset.AddPaths(path_int, ClipperLib::jtSquare, ClipperLib::etClosedPolygon);
     offset.Execute(path_int, -10);
     ClipperLib::SimplifyPolygons(path_int);
@@ -164,6 +213,111 @@ void PolyPolyBoolean<Scalar>::computePolygonsIntersection(const PolyPolyBoolean:
     return;
 }
 
+template<typename Scalar>
+bool PolyPolyBoolean<Scalar>::computePolygonsIntersection_Convex(const PolyPolyBoolean::PolyVector3 &polyA,
+                                                                 const PolyPolyBoolean::PolyVector3 &polyB,
+                                                                 PolyPolyBoolean::PolysVector3 &polyIntsec) {
+    if(!clipConvexPolygons(polyA, polyB))
+        return false;
+
+    polyIntsec.clear();
+    if(!scratch_polylist.empty())
+        polyIntsec.push_back(scratch_polylist);
+    return true;
+}
+
+template<typename Scalar>
+void PolyPolyBoolean<Scalar>::computePolygonsIntersection(const PolyPolyBoolean::PolyVector3 &polyA,
+                                                          const PolyPolyBoolean::PolyVector3 &polyB,
+                                                          PolyPolyBoolean::PolyVector3 &points,
+                                                          vector<size_t> &polyEnds) {
+    if(clipConvexPolygons(polyA, polyB))
+    {
+        if(scratch_polylist.size() >= 3){
+            points.insert(points.end(), scratch_polylist.begin(), scratch_polylist.end());
+            polyEnds.push_back(points.size());
+        }
+        return;
+    }
+
+    computePolygonsIntersection_Clipper(polyA, polyB, scratch_polylists);
+    for(const PolyVector3 &polylist: scratch_polylists){
+        if(polylist.size() < 3) continue;
+        points.insert(points.end(), polylist.begin(), polylist.end());
+        polyEnds.push_back(points.size());
+    }
+}
+
+/*!
+ * \brief: intersection of two convex polygons lying on the same plane, the result is stored in scratch_polylist.
+ *          the polygons are clipped in the plane frame of polyA, in floating point.
+ *          as the Clipper version, the intersection is shrunk by 10 / Scale so that edge/vertex contacts vanish.
+ * \return: false if the inputs are not convex (or degenerate).
+ */
+template<typename Scalar>
+bool PolyPolyBoolean<Scalar>::clipConvexPolygons(const PolyPolyBoolean::PolyVector3 &polyA,
+                                                 const PolyPolyBoolean::PolyVector3 &polyB) {
+    scratch_polylist.clear();
+    if(polyA.size() < 3 || polyB.size() < 3)
+        return false;
+
+    Vector3 x_axis, y_axis, origin;
+    computeFrame(polyA, x_axis, y_axis, origin);
+    if(x_axis.norm() < 0.5 || y_axis.norm() < 0.5)
+        return false;
+
+    // 1) project both polygons into the plane frame
+    scratch_polys2D.resize(2);
+    for(size_t id = 0; id < 2; id++)
+    {
+        const PolyVector3 &poly = id == 0 ? polyA : polyB;
+        scratch_polys2D[id].clear();
+        for(const Vector3 &pos: poly){
+            scratch_polys2D[id].push_back(Vector2((pos - origin).dot(x_axis), (pos - origin).dot(y_axis)));
+        }
+    }
+    Scalar offset = 10 / computeScale(scratch_polys2D);
+
+    // 2) make them counter-clockwise
+    for(size_t id = 0; id < 2; id++)
+    {
+        Scalar area = computeSignedArea(scratch_polys2D[id]);
+        if(std::abs(area) < offset * offset)
+            return false;
+        if(area < 0)
+            std::reverse(scratch_polys2D[id].begin(), scratch_polys2D[id].end());
+        if(!isConvex(scratch_polys2D[id]))
+            return false;
+    }
+
+    // 3) clip polyA by the shrunk half planes of both polygons
+    scratch_subject = scratch_polys2D[0];
+    for(size_t id = 0; id < 2 && !scratch_subject.empty(); id++)
+    {
+        const PolyVector2 &clip = scratch_polys2D[id];
+        for(size_t jd = 0; jd < clip.size() && !scratch_subject.empty(); jd++)
+        {
+            const Vector2 &sta = clip[jd];
+            const Vector2 &end = clip[(jd + 1) % clip.size()];
+            if((end - sta).norm() < FLOAT_ERROR_SMALL)
+                continue;
+            clipByHalfPlane(scratch_subject, sta, end, offset, scratch_clipped);
+            std::swap(scratch_subject, scratch_clipped);
+        }
+    }
+
+    if(scratch_subject.size() < 3 || computeSignedArea(scratch_subject) < offset * offset)
+        return true;
+
+    // 4) back to 3D
+    for(const Vector2 &pt: scratch_subject){
+        scratch_polylist.push_back(x_axis * pt.x() + y_axis * pt.y() + origin);
+    }
+    cleanPath(scratch_polylist);
+
+    return true;
+}
+
 template<typename Scalar>
 bool PolyPolyBoolean<Scalar>::check2DPolygonsIntersection(const PolyPolyBoolean::PolyVector2 &polyA,
                                                           const PolyPolyBoolean::PolyVector2 &polyB,
@@ -314,6 +468,68 @@ Matrix<Scalar, 3, 1> PolyPolyBoolean<Scalar>::computeCenter(const PolyPolyBoolea
     return center;
 }
 
+template<typename Scalar>
+Scalar PolyPolyBoolean<Scalar>::computeSignedArea(const PolyPolyBoolean::PolyVector2 &poly)
+{
+    Scalar area = 0;
+    for(size_t id = 0; id < poly.size(); id++)
+    {
+        const Vector2 &curr = poly[id];
+        const Vector2 &next = poly[(id + 1) % poly.size()];
+        area += curr.x() * next.y() - curr.y() * next.x();
+    }
+    return area / 2;
+}
+
+template<typename Scalar>
+bool PolyPolyBoolean<Scalar>::isConvex(const PolyPolyBoolean::PolyVector2 &poly)
+{
+    // poly should be counter-clockwise, collinear corners are allowed
+    int N = poly.size();
+    for(int id = 0; id < N; id++)
+    {
+        Vector2 tA = poly[id] - poly[(id - 1 + N) % N];
+        Vector2 tB = poly[(id + 1) % N] - poly[id];
+        Scalar cross_product = tA.x() * tB.y() - tA.y() * tB.x();
+        if(cross_product < -FLOAT_ERROR_LARGE * tA.norm() * tB.norm())
+            return false;
+    }
+    return true;
+}
+
+/*!
+ * \brief: one step of Sutherland-Hodgman, keep the part of subject on the left of (sta, end) at a distance larger than offset
+ */
+template<typename Scalar>
+void PolyPolyBoolean<Scalar>::clipByHalfPlane(const PolyPolyBoolean::PolyVector2 &subject,
+                                              const PolyPolyBoolean::Vector2 &sta,
+                                              const PolyPolyBoolean::Vector2 &end,
+                                              Scalar offset,
+                                              PolyPolyBoolean::PolyVector2 &out)
+{
+    out.clear();
+    Vector2 edge = (end - sta).normalized();
+    int N = subject.size();
+    if(N == 0) return;
+
+    auto distance = [&](const Vector2 &pt) -> Scalar{
+        return edge.x() * (pt.y() - sta.y()) - edge.y() * (pt.x() - sta.x()) - offset;
+    };
+
+    Scalar dcurr = distance(subject[0]);
+    for(int id = 0; id < N; id++)
+    {
+        const Vector2 &curr = subject[id];
+        const Vector2 &next = subject[(id + 1) % N];
+        Scalar dnext = distance(next);
+        if(dcurr >= 0)
+            out.push_back(curr);
+        if((dcurr >= 0) != (dnext >= 0))
+            out.push_back(curr + (next - curr) * (dcurr / (dcurr - dnext)));
+        dcurr = dnext;
+    }
+}
+
 template<typename Scalar>
 ClipperLib::Path
 PolyPolyBoolean<Scalar>::projectToNormalPlane(  const PolyPolyBoolean::PolyVector3 &poly,
@@ -381,19 +597,19 @@ Scalar PolyPolyBoolean<Scalar>::computeScale(const PolyPolyBoolean::PolysVector2
     Scalar Scale = 1;
     int maxdigit = 0;
 
-    for(PolyVector2 poly:polys)
+    for(const PolyVector2 &poly:polys)
     {
         for(size_t id = 0; id < poly.size(); id++)
         {
             Vector2 pos = poly[id];
-            Scalar x = pos.x();
-            Scalar y = pos.y();
+            Scalar x = std::abs(pos.x());
+            Scalar y = std::abs(pos.y());
             int digit = std::floor(std::max(std::log10(x) + 1, std::log10(y) + 1));
             maxdigit = std::max(digit, maxdigit);
         }
     }
 
-    Scale = std::max(Scale, std::pow(10, std::max(0, 8 - maxdigit)));
+    Scale = std::max(Scale, (Scalar)(std::pow(10, std::max(0, 8 - maxdigit))));
     return Scale;
 }
 
@@ -79,6 +79,26 @@ TEST_CASE("BaseMeshCreator")
             _polyMesh->getTextureMesh()->writeOBJModel("Pattern/polymesh.obj");
         }
 
+        SECTION("computeBaseCrossMesh is deterministic")
+        {
+            data.varList->add(true, "smooth_bdry", "");
+            baseMeshCreator.computeBaseCrossMesh(interactMat, baseMesh2D, crossMesh, true);
+
+            shared_ptr<PolyMesh<double>> baseMesh2D_again;
+            shared_ptr<CrossMesh<double>> crossMesh_again;
+            baseMeshCreator.computeBaseCrossMesh(interactMat, baseMesh2D_again, crossMesh_again, true);
+
+            REQUIRE(crossMesh->size() == crossMesh_again->size());
+            REQUIRE(crossMesh->vertexList.size() == crossMesh_again->vertexList.size());
+            for(size_t id = 0; id < crossMesh->vertexList.size(); id++){
+                REQUIRE(crossMesh->vertexList[id]->pos == crossMesh_again->vertexList[id]->pos);
+            }
+            for(size_t id = 0; id < crossMesh->size(); id++){
+                REQUIRE(crossMesh->cross(id)->size() == crossMesh_again->cross(id)->size());
+                REQUIRE(crossMesh->cross(id)->vers[0]->verID == crossMesh_again->cross(id)->vers[0]->verID);
+            }
+        }
+
         SECTION("getTextureCoord"){
 
             // map 2D pattern vertices on 3D input surface
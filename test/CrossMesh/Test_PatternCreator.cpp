@@ -35,4 +35,101 @@ TEST_CASE("PatternCreator")
         patternCreator.create2DPattern(CROSS_RHOMBUS, 10, crossMesh);
         crossMesh->writeOBJModel("Pattern/rhombus.obj");
     }
+
+    SECTION("lattice reproduces the BFS tiling"){
+        for(PatternType patternID : {CROSS_SQUARE, CROSS_HEXAGON, CROSS_OCTAGON_SQUARE, CROSS_PENTAGON_SNOW})
+        {
+            PatternCreator<double>::PatternLattice lattice;
+            REQUIRE(patternCreator.computePatternLattice(patternID, lattice));
+
+            vector<PatternCreator<double>::pPolygon> polys;
+            vector<int> depths;
+            patternCreator.createPolygons_BFS(patternID, 8, polys, depths);
+            for(PatternCreator<double>::pPolygon poly : polys)
+            {
+                Eigen::Vector2i cell = lattice.computeCell(poly->center());
+                bool found = false;
+                for(size_t kd = 0; kd < lattice.cellPolygons.size(); kd++){
+                    Eigen::Vector3d centroid = lattice.cellCentroids[kd] + cell.x() * lattice.latticeA + cell.y() * lattice.latticeB;
+                    if((centroid - poly->center()).norm() < 1e-5 && patternCreator.isTranslatedPolygon(poly, lattice.cellPolygons[kd])){
+                        found = true;
+                    }
+                }
+                REQUIRE(found);
+            }
+        }
+    }
+
+    SECTION("lattice pattern is the BFS pattern"){
+        PatternCreator<double>::clearPatternCache();
+        for(int patternID = 1; patternID <= MAX_PATTERN_TYPE; patternID++)
+        {
+            for(int patternRadius : {1, 2, 3, 6, 10})
+            {
+                PatternCreator<double>::pCrossMesh bfsMesh;
+                patternCreator.create2DPattern_BFS(PatternType(patternID), patternRadius, bfsMesh);
+                patternCreator.create2DPattern(PatternType(patternID), patternRadius, crossMesh);
+                REQUIRE(crossMesh->size() == bfsMesh->size());
+
+                // both are normalized by the bounding box of the same vertices
+                std::map<Eigen::Vector3d, size_t, PatternCreator<double>::pVertex_compare> bfsCenters;
+                for(size_t id = 0; id < bfsMesh->size(); id++){
+                    bfsCenters[bfsMesh->cross(id)->center()] = bfsMesh->cross(id)->size();
+                }
+                for(size_t id = 0; id < crossMesh->size(); id++){
+                    auto find_it = bfsCenters.find(crossMesh->cross(id)->center());
+                    REQUIRE(find_it != bfsCenters.end());
+                    REQUIRE(find_it->second == crossMesh->cross(id)->size());
+                }
+            }
+        }
+        PatternCreator<double>::clearPatternCache();
+    }
+
+    SECTION("lattice pattern shares vertices"){
+        patternCreator.create2DPattern(CROSS_HEXAGON, 10, crossMesh);
+        for(size_t id = 0; id < crossMesh->size(); id++){
+            REQUIRE(crossMesh->cross(id)->vers.size() == 6);
+        }
+        // the vertex indices are computed analytically, welding should not find any duplicated vertex
+        size_t num_vertices = crossMesh->vertexList.size();
+        crossMesh->update();
+        REQUIRE(crossMesh->vertexList.size() == num_vertices);
+    }
+
+    SECTION("pattern cache"){
+        PatternCreator<double>::clearPatternCache();
+        REQUIRE(PatternCreator<double>::findCachedPattern(CROSS_HEXAGON, 10) == nullptr);
+
+        patternCreator.create2DPattern(CROSS_HEXAGON, 10, crossMesh);
+        PatternCreator<double>::pPatternBuffer buffer = PatternCreator<double>::findCachedPattern(CROSS_HEXAGON, 10);
+        REQUIRE(buffer != nullptr);
+        REQUIRE(PatternCreator<double>::findCachedPattern(CROSS_HEXAGON, 9) == nullptr);
+
+        // a cache hit gives the same geometry in new meshes
+        PatternCreator<double>::pCrossMesh cachedMesh;
+        patternCreator.create2DPattern(CROSS_HEXAGON, 10, cachedMesh);
+        REQUIRE(PatternCreator<double>::findCachedPattern(CROSS_HEXAGON, 10) == buffer);
+        REQUIRE(cachedMesh != crossMesh);
+        REQUIRE(cachedMesh->size() == crossMesh->size());
+        REQUIRE(cachedMesh->vertexList.size() == crossMesh->vertexList.size());
+        for(size_t id = 0; id < crossMesh->vertexList.size(); id++){
+            REQUIRE(cachedMesh->vertexList[id] != crossMesh->vertexList[id]);
+            REQUIRE((cachedMesh->vertexList[id]->pos - crossMesh->vertexList[id]->pos).norm() < 1e-7);
+        }
+
+        // the lattice is shared by the radii of a type
+        PatternCreator<double>::pPatternLattice lattice = patternCreator.findPatternLattice(CROSS_HEXAGON);
+        REQUIRE(lattice != nullptr);
+        patternCreator.create2DPattern(CROSS_HEXAGON, 9, crossMesh);
+        REQUIRE(patternCreator.findPatternLattice(CROSS_HEXAGON) == lattice);
+
+        // the BFS fallback is cached as well
+        patternCreator.create2DPattern(CROSS_SQUARE_RHOMBUS, 5, crossMesh);
+        REQUIRE(PatternCreator<double>::findCachedPattern(CROSS_SQUARE_RHOMBUS, 5) != nullptr);
+        patternCreator.create2DPattern(CROSS_SQUARE_RHOMBUS, 5, cachedMesh);
+        REQUIRE(cachedMesh->size() == crossMesh->size());
+
+        PatternCreator<double>::clearPatternCache();
+    }
 }
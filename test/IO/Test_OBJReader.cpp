@@ -0,0 +1,97 @@
+#include <catch2/catch.hpp>
+#include "IO/OBJReader.h"
+
+#if defined(GCC_VERSION_LESS_8)
+#include <experimental/filesystem>
+    using namespace std::experimental::filesystem;
+#else
+#include <filesystem>
+using namespace std::filesystem;
+#endif
+
+TEST_CASE("OBJReader")
+{
+    OBJReader reader;
+    OBJData data;
+
+    SECTION("records"){
+        std::string text = "# a square\r\n"
+                           "o square\n"
+                           "v 0 0 0\n"
+                           "v 1.5e0 0 -0.0\n"
+                           "v 1 1 0\r\n"
+                           "vt 0.25 0.5\n"
+                           "vn 0 0 1\n"
+                           "f 1/1/1 2//1 -1 -3/-1\n"
+                           "  f 1 2 3";
+        REQUIRE(reader.parse(text.data(), text.size(), data));
+        REQUIRE(data.numVertices() == 3);
+        REQUIRE(data.V[3] == 1.5);
+        REQUIRE(data.TC == vector<double>({0.25, 0.5}));
+        REQUIRE(data.numFaces() == 2);
+        REQUIRE(data.F == vector<int>({0, 1, 2, 0, 0, 1, 2}));
+        REQUIRE(data.FTC == vector<int>({0, -1, -1, 0, -1, -1, -1}));
+        REQUIRE(data.faceOffsets == vector<int>({0, 4, 7}));
+    }
+
+    SECTION("numbers"){
+        std::string text = "v -12.625 3.0E-2 +7\nv 0.1 1e25 123456789012345678901234\n";
+        REQUIRE(reader.parse(text.data(), text.size(), data));
+        REQUIRE(data.V[0] == -12.625);
+        REQUIRE(data.V[1] == Approx(0.03).epsilon(1e-15));
+        REQUIRE(data.V[2] == 7);
+        REQUIRE(data.V[3] == 0.1);
+        REQUIRE(data.V[4] == 1e25);
+        REQUIRE(data.V[5] == Approx(1.23456789012345678901234e23).epsilon(1e-15));
+    }
+
+    SECTION("invalid faces"){
+        std::string text = "v 0 0 0\nf 1 2 3\n";
+        REQUIRE(!reader.parse(text.data(), text.size(), data));
+        text = "v 0 0 0\nf 1 x\n";
+        REQUIRE(!reader.parse(text.data(), text.size(), data));
+    }
+
+    SECTION("chunks"){
+        path filepath = path(UNITTEST_DATAPATH) / "Mesh/primitives/Icosphere.obj";
+        REQUIRE(reader.read(filepath.string(), data));
+        REQUIRE(data.numVertices() == 42);
+        REQUIRE(data.TC.size() == 62 * 2);
+        REQUIRE(data.numFaces() == 80);
+
+        // a chunk of a few lines: the negative indices refer to the earlier chunks
+        std::string text;
+        for(int id = 0; id < 100; id++){
+            text += "v " + std::to_string(id) + " 0 0\nv " + std::to_string(id) + " 1 0\nv 0 0 1\nf -3 -2 -1\n";
+        }
+        OBJData chunked;
+        reader.chunkSize = 16;
+        REQUIRE(reader.parse(text.data(), text.size(), chunked));
+        reader.chunkSize = 1 << 22;
+        REQUIRE(reader.parse(text.data(), text.size(), data));
+        REQUIRE(chunked.V == data.V);
+        REQUIRE(chunked.F == data.F);
+        REQUIRE(chunked.faceOffsets == data.faceOffsets);
+        REQUIRE(chunked.F[297] == 297);
+    }
+
+    SECTION("parts"){
+        vector<std::string> filenames;
+        for(int id = 1; id <= 9; id++){
+            filenames.push_back((path(UNITTEST_DATAPATH) / ("Voxel/Cube/part_" + std::to_string(id) + ".obj")).string());
+        }
+
+        shared_ptr<InputVarList> varList = make_shared<InputVarList>();
+        InitVar(varList.get());
+        vector<shared_ptr<PolyMesh<double>>> meshes;
+        REQUIRE(OBJReader::readMeshes(filenames, varList, meshes, false));
+        REQUIRE(meshes.size() == 9);
+        for(auto mesh: meshes){
+            REQUIRE(!mesh->polyList.empty());
+        }
+
+        filenames.push_back("missing.obj");
+        REQUIRE(!OBJReader::readMeshes(filenames, varList, meshes, false));
+        REQUIRE(meshes.back() == nullptr);
+    }
+}
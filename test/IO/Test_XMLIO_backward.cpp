@@ -23,6 +23,14 @@ TEST_CASE("Read XML"){
         xmlFileName = xmlFileName / "TopoInterlock/XML/origin.xml";
         IOData data;
         xmlio.XMLReader(xmlFileName, data);
+        REQUIRE(data.boundary_crossIDs.size() == 42);
+        REQUIRE(data.boundary_crossIDs.front() == 61);
+        REQUIRE(data.pickPartIDs.empty());
+        REQUIRE(data.varList->getBool("texturedModel") == data.reference_surface->texturedModel);
+
+        // the project, its reference surface and its cross data
+        REQUIRE(xmlio.loadTimes.size() == 3);
+
         data.cross_mesh->writeOBJModel("CrossMesh.obj");
         data.reference_surface->writeOBJModel("Reference.obj");
     }
@@ -0,0 +1,25 @@
+#ifndef TOPOLITE_TEST_BOXMESH_H
+#define TOPOLITE_TEST_BOXMESH_H
+
+#include "Mesh/PolyMesh.h"
+
+// an axis aligned box with outward facing quads
+inline shared_ptr<PolyMesh<double>> createBoxMesh(Eigen::Vector3d minCorner, Eigen::Vector3d maxCorner, shared_ptr<InputVarList> varList)
+{
+    shared_ptr<PolyMesh<double>> mesh = make_shared<PolyMesh<double>>(varList);
+    Eigen::Vector3d c[8];
+    for(int id = 0; id < 8; id++){
+        c[id] = Eigen::Vector3d((id & 1) ? maxCorner[0] : minCorner[0],
+                                (id & 2) ? maxCorner[1] : minCorner[1],
+                                (id & 4) ? maxCorner[2] : minCorner[2]);
+    }
+    int faces[6][4] = {{0, 2, 3, 1}, {4, 5, 7, 6}, {0, 1, 5, 4}, {2, 6, 7, 3}, {0, 4, 6, 2}, {1, 3, 7, 5}};
+    for(auto &face: faces){
+        shared_ptr<_Polygon<double>> poly = make_shared<_Polygon<double>>();
+        for(int id: face) poly->push_back(c[id]);
+        mesh->polyList.push_back(poly);
+    }
+    return mesh;
+}
+
+#endif //TOPOLITE_TEST_BOXMESH_H
@@ -0,0 +1,69 @@
+#include <catch2/catch.hpp>
+#include "Interlocking/BoundarySearch.h"
+#include "BoxMesh.h"
+
+using pPolyMesh = shared_ptr<PolyMesh<double>>;
+using Eigen::Vector3d;
+
+TEST_CASE("Boundary search of a column of boxes")
+{
+    shared_ptr<InputVarList> varList = make_shared<InputVarList>();
+    InitVar(varList.get());
+
+    // a well made of a fixed base and four fixed walls, A in the well, B on A, a lid C on B
+    vector<pPolyMesh> meshes;
+    meshes.push_back(createBoxMesh(Vector3d(0, 0, 0), Vector3d(1, 1, 1), varList));
+    meshes.push_back(createBoxMesh(Vector3d(0, 0, 1), Vector3d(1, 1, 2), varList));
+    meshes.push_back(createBoxMesh(Vector3d(0, 0, 2), Vector3d(1, 1, 3), varList));
+    meshes.push_back(createBoxMesh(Vector3d(-1, 0, 1), Vector3d(0, 1, 3), varList));
+    meshes.push_back(createBoxMesh(Vector3d(1, 0, 1), Vector3d(2, 1, 3), varList));
+    meshes.push_back(createBoxMesh(Vector3d(0, -1, 1), Vector3d(1, 0, 3), varList));
+    meshes.push_back(createBoxMesh(Vector3d(0, 1, 1), Vector3d(1, 2, 3), varList));
+    meshes.push_back(createBoxMesh(Vector3d(0, 0, 3), Vector3d(1, 1, 4), varList));
+    vector<bool> atBoundary = {true, false, false, true, true, true, true, false};
+
+    shared_ptr<ContactGraph<double>> graph = make_shared<ContactGraph<double>>(varList);
+
+    SECTION("the lid is the key"){
+        graph->buildFromMeshes(meshes, atBoundary);
+        BoundarySearch<double> search(graph, varList, 2);
+        search.verbose = false;
+        REQUIRE(search.search() == true);
+        REQUIRE(search.solutions == vector<vector<int>>({{7}}));
+
+        // the pruning loses no set: the minimal sets solved one by one are the same
+        BoundarySearch<double> exhaustive(graph, varList, 2);
+        vector<vector<int>> minimal_sets;
+        vector<vector<int>> candidates = {{}, {1}, {2}, {7}, {1, 2}, {1, 7}, {2, 7}};
+        for(const vector<int> &candidate: candidates){
+            bool is_minimal = true;
+            for(const vector<int> &set: minimal_sets){
+                if(std::includes(candidate.begin(), candidate.end(), set.begin(), set.end())) is_minimal = false;
+            }
+            if(is_minimal && exhaustive.evaluateCandidate(candidate).interlocking) minimal_sets.push_back(candidate);
+        }
+        REQUIRE(search.solutions == minimal_sets);
+
+        // the LPs are not solved twice
+        int num_cached = search.num_cached;
+        REQUIRE(search.evaluateCandidate({7}).interlocking == true);
+        REQUIRE(search.num_cached == num_cached + 1);
+    }
+
+    SECTION("interlocking without any key"){
+        atBoundary.back() = true;
+        graph->buildFromMeshes(meshes, atBoundary);
+        BoundarySearch<double> search(graph, varList, 2);
+        search.verbose = false;
+        REQUIRE(search.search() == true);
+        REQUIRE(search.solutions == vector<vector<int>>({{}}));
+    }
+
+    SECTION("no key small enough"){
+        graph->buildFromMeshes(meshes, atBoundary);
+        BoundarySearch<double> search(graph, varList, 0);
+        search.verbose = false;
+        REQUIRE(search.search() == false);
+        REQUIRE(search.solutions.empty());
+    }
+}
@@ -277,6 +277,63 @@ TEST_CASE("Class ContactGraph") {
 
     }
 
+    SECTION("dynamic components. A is at boundary and touches B and C") {
+        pPolygon pB = make_shared<_Polygon<double>>();
+        pB->push_back(Vector3d(1, 1, 0));
+        pB->push_back(Vector3d(1, 3, 0));
+        pB->push_back(Vector3d(3, 3, 0));
+        pB->push_back(Vector3d(3, 1, 0));
+
+        pPolygon pC = make_shared<_Polygon<double>>();
+        pC->push_back(Vector3d(-1, -1, 0));
+        pC->push_back(Vector3d(-1,  1, 0));
+        pC->push_back(Vector3d( 1,  1, 0));
+        pC->push_back(Vector3d( 1, -1, 0));
+
+        pPolyMesh meshA = make_shared<PolyMesh<double>>(varList);
+        meshA->polyList.push_back(pA);
+
+        pPolyMesh meshB = make_shared<PolyMesh<double>>(varList);
+        meshB->polyList.push_back(pB);
+
+        pPolyMesh meshC = make_shared<PolyMesh<double>>(varList);
+        meshC->polyList.push_back(pC);
+
+        vector<pPolyMesh> meshes;
+        meshes.push_back(meshA);
+        meshes.push_back(meshB);
+        meshes.push_back(meshC);
+
+        vector<bool> atBoundary;
+        atBoundary.push_back(true);
+        atBoundary.push_back(false);
+        atBoundary.push_back(false);
+
+        shared_ptr<ContactGraph<double>> graph = make_shared<ContactGraph<double>>(varList);
+        graph->buildFromMeshes(meshes, atBoundary);
+        REQUIRE(graph->edges.size() == 2);
+
+        vector<ContactGraph<double>::DynamicComponent> components;
+        vector<int> localIDs;
+
+        // the boundary node A is a cut point
+        REQUIRE(graph->computeDynamicComponents(components, localIDs) == 2);
+        REQUIRE(components[0].nodeIDs == vector<int>({1}));
+        REQUIRE(components[1].nodeIDs == vector<int>({2}));
+        REQUIRE(components[0].edgeIDs.size() == 1);
+        REQUIRE(components[1].edgeIDs.size() == 1);
+        REQUIRE(components[0].edgeIDs[0] != components[1].edgeIDs[0]);
+        REQUIRE(localIDs == vector<int>({-1, 0, 0}));
+
+        // merged nodes always move together
+        graph->mergeNode(graph->nodes[1], graph->nodes[2]);
+        REQUIRE(graph->computeDynamicComponents(components, localIDs) == 1);
+        REQUIRE(components[0].nodeIDs == vector<int>({1, 2}));
+        REQUIRE(components[0].edgeIDs.size() == 2);
+        REQUIRE(components[0].mergeIDs == vector<int>({0}));
+        REQUIRE(localIDs == vector<int>({-1, 0, 1}));
+    }
+
     SECTION("both A B at boundary") {
 
         pPolygon pB = make_shared<_Polygon<double>>();
@@ -337,4 +394,82 @@ TEST_CASE("Class ContactGraph") {
         contactMesh->writeOBJModel("debug.obj");
     }
 
-}
\ No newline at end of file
+}
+
+TEST_CASE("ContactGraph from voxels") {
+    shared_ptr<InputVarList> varList = make_shared<InputVarList>();
+    InitVar(varList.get());
+
+    VoxelGrid<double> grid(varList);
+    REQUIRE(grid.readPUZ("data/Voxel/bunny_15x14x11_K80.puz"));
+
+    vector<pPolyMesh> meshes;
+    for(int id = 1; id <= 80; id++){
+        pPolyMesh mesh = make_shared<PolyMesh<double>>(varList);
+        std::string filename = "data/Voxel/bunny/part_" + std::to_string(id) + ".obj";
+        mesh->readOBJModel(filename.c_str(), false);
+        meshes.push_back(mesh);
+    }
+
+    vector<bool> atBoundary(80, false);
+    atBoundary[0] = atBoundary[1] = true;
+
+    shared_ptr<ContactGraph<double>> meshGraph = make_shared<ContactGraph<double>>(varList);
+    meshGraph->buildFromMeshes(meshes, atBoundary, 1e-3, false);
+
+    shared_ptr<ContactGraph<double>> voxelGraph = make_shared<ContactGraph<double>>(varList);
+    REQUIRE(voxelGraph->buildFromVoxels(grid, atBoundary, false));
+
+    SECTION("the same contacts as the exported parts") {
+        REQUIRE(voxelGraph->nodes.size() == 80);
+        REQUIRE(voxelGraph->dynamic_nodes.size() == 78);
+
+        auto contact_keys = [](shared_ptr<ContactGraph<double>> graph, double &area){
+            std::set<std::tuple<int, int, int, int, int>> keys;
+            area = 0;
+            for(auto edge: graph->edges){
+                keys.insert({edge->partIDA, edge->partIDB,
+                             (int)std::round(edge->normal[0]), (int)std::round(edge->normal[1]), (int)std::round(edge->normal[2])});
+                for(auto poly: edge->polygons) area += poly->area();
+            }
+            return keys;
+        };
+
+        double meshArea, voxelArea;
+        REQUIRE(contact_keys(meshGraph, meshArea) == contact_keys(voxelGraph, voxelArea));
+        REQUIRE(voxelArea == Approx(meshArea).epsilon(1e-4));
+
+        for(int id = 0; id < 80; id++){
+            REQUIRE((voxelGraph->nodes[id]->centerofmass - meshGraph->nodes[id]->centerofmass).norm() == Approx(0).margin(1e-6));
+            REQUIRE(voxelGraph->nodes[id]->mass == Approx(meshGraph->nodes[id]->mass));
+        }
+    }
+
+    SECTION("convex hull") {
+        REQUIRE(voxelGraph->buildFromVoxels(grid, atBoundary, true));
+        REQUIRE(meshGraph->buildFromMeshes(meshes, atBoundary, 1e-3, true));
+        REQUIRE(voxelGraph->edges.size() == meshGraph->edges.size());
+    }
+}
+
+TEST_CASE("ContactGraph from voxel strips") {
+    shared_ptr<InputVarList> varList = make_shared<InputVarList>();
+    InitVar(varList.get());
+
+    // the slabs 1, 2, 1, 2 along x, three cells along z: the contacts of the planes x = 1 and x = 3 have the same direction
+    VoxelGrid<double> grid(varList);
+    vector<int> labels;
+    for(int z = 0; z < 3; z++) labels.insert(labels.end(), {1, 2, 1, 2});
+    REQUIRE(grid.setLabels(Eigen::Vector3i(4, 1, 3), labels));
+
+    vector<bool> atBoundary(2, false);
+    shared_ptr<ContactGraph<double>> graph = make_shared<ContactGraph<double>>(varList);
+    REQUIRE(graph->buildFromVoxels(grid, atBoundary, false));
+
+    // one strip per plane
+    REQUIRE(graph->edges.size() == 3);
+    for(auto edge: graph->edges){
+        REQUIRE(edge->polygons.size() == 1);
+        REQUIRE(edge->polygons[0]->area() == Approx(3 * grid.voxelSize * grid.voxelSize));
+    }
+}
@@ -0,0 +1,65 @@
+#include <catch2/catch.hpp>
+#include "Interlocking/DisassemblyPlanner.h"
+#include "BoxMesh.h"
+
+using pPolyMesh = shared_ptr<PolyMesh<double>>;
+using Eigen::Vector3d;
+
+TEST_CASE("Disassembly of stacked boxes")
+{
+    shared_ptr<InputVarList> varList = make_shared<InputVarList>();
+    InitVar(varList.get());
+
+    // a well made of a fixed base and four fixed walls, A in the well, B on A
+    vector<pPolyMesh> meshes;
+    meshes.push_back(createBoxMesh(Vector3d(0, 0, 0), Vector3d(1, 1, 1), varList));
+    meshes.push_back(createBoxMesh(Vector3d(0, 0, 1), Vector3d(1, 1, 2), varList));
+    meshes.push_back(createBoxMesh(Vector3d(0, 0, 2), Vector3d(1, 1, 3), varList));
+    meshes.push_back(createBoxMesh(Vector3d(-1, 0, 1), Vector3d(0, 1, 3), varList));
+    meshes.push_back(createBoxMesh(Vector3d(1, 0, 1), Vector3d(2, 1, 3), varList));
+    meshes.push_back(createBoxMesh(Vector3d(0, -1, 1), Vector3d(1, 0, 3), varList));
+    meshes.push_back(createBoxMesh(Vector3d(0, 1, 1), Vector3d(1, 2, 3), varList));
+    vector<bool> atBoundary = {true, false, false, true, true, true, true};
+
+    shared_ptr<ContactGraph<double>> graph = make_shared<ContactGraph<double>>(varList);
+
+    SECTION("top to bottom"){
+        graph->buildFromMeshes(meshes, atBoundary);
+        DisassemblyPlanner<double> planner(graph, varList);
+        planner.verbose = false;
+        REQUIRE(planner.computeSequence() == true);
+        REQUIRE(planner.sequence.size() == 2);
+        REQUIRE(planner.sequence[0].partIDs == vector<int>({2}));
+        REQUIRE(planner.sequence[1].partIDs == vector<int>({1}));
+        for(auto &step: planner.sequence){
+            REQUIRE((step.direction - Vector3d(0, 0, 1)).norm() == Approx(0).margin(1e-6));
+        }
+    }
+
+    SECTION("merged parts leave together"){
+        graph->buildFromMeshes(meshes, atBoundary);
+        graph->mergeNode(graph->nodes[1], graph->nodes[2]);
+        DisassemblyPlanner<double> planner(graph, varList);
+        planner.verbose = false;
+        REQUIRE(planner.computeSequence() == true);
+        REQUIRE(planner.sequence.size() == 1);
+        REQUIRE(planner.sequence[0].partIDs == vector<int>({1, 2}));
+    }
+
+    SECTION("closed by a lid"){
+        meshes.push_back(createBoxMesh(Vector3d(0, 0, 3), Vector3d(1, 1, 4), varList));
+        atBoundary.push_back(true);
+        graph->buildFromMeshes(meshes, atBoundary);
+
+        DisassemblyPlanner<double> planner(graph, varList);
+        planner.verbose = false;
+        REQUIRE(planner.computeSequence() == false);
+        REQUIRE(planner.blockedParts == vector<int>({1, 2}));
+
+        // unlocking B frees A
+        REQUIRE(planner.computeSequence({2}) == true);
+        REQUIRE(planner.sequence.size() == 2);
+        REQUIRE(planner.sequence[0].round == 0);
+        REQUIRE(planner.sequence[1].partIDs == vector<int>({1}));
+    }
+}
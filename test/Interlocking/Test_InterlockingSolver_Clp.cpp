@@ -80,6 +80,91 @@ TEST_CASE("Bunny Example Clp")
 }
 
 
+TEST_CASE("Presolved interlocking matrix")
+{
+    vector<shared_ptr<PolyMesh<double>>> meshList;
+    vector<bool> atboundary;
+    shared_ptr<InputVarList> varList = make_shared<InputVarList>();
+    InitVar(varList.get());
+
+    for(int id = 1; id <= 80; id++){
+        char number[50];
+        sprintf(number, "%d.obj", id);
+        std::string part_filename = "data/Voxel/bunny/part_";
+        part_filename += number;
+        shared_ptr<PolyMesh<double>> polyMesh = make_shared<PolyMesh<double>>(varList);
+        polyMesh->readOBJModel(part_filename.c_str(), false);
+
+        meshList.push_back(polyMesh);
+        atboundary.push_back(id == 1);
+    }
+
+    // without the convex hull, every contact polygon is an edge
+    shared_ptr<ContactGraph<double>>graph = make_shared<ContactGraph<double>>(varList);
+    graph->buildFromMeshes(meshList, atboundary, 0.002, false);
+
+    InterlockingSolver_Clp<double> solver(graph, varList);
+    InterlockingSolver<double>::DynamicComponent component;
+    vector<int> localIDs;
+    solver.computeWholeGraphComponent(component, localIDs);
+
+    for(int isRotation = 0; isRotation < 2; isRotation++)
+    {
+        vector<InterlockingSolver<double>::EigenTriple> tris, presolved_tris;
+        Eigen::Vector2i size, presolved_size;
+        if(isRotation) solver.computeRotationalInterlockingMatrix(tris, size);
+        else solver.computeTranslationalInterlockingMatrix(tris, size);
+        solver.computePresolvedInterlockingMatrix(component, localIDs, isRotation, presolved_tris, presolved_size);
+
+        REQUIRE(presolved_size[0] < size[0]);
+        REQUIRE(presolved_size[1] == size[1]);
+
+        Eigen::SparseMatrix<double> A(size[0], size[1]), B(presolved_size[0], presolved_size[1]);
+        A.setFromTriplets(tris.begin(), tris.end());
+        B.setFromTriplets(presolved_tris.begin(), presolved_tris.end());
+
+        // the removed rows are implied: the extreme values of the rows do not change
+        for(int id = 0; id < 10; id++){
+            Eigen::VectorXd x = Eigen::VectorXd::Random(size[1]);
+            Eigen::VectorXd Ax = A * x, Bx = B * x;
+            REQUIRE(Ax.maxCoeff() == Approx(Bx.maxCoeff()));
+            REQUIRE(Ax.minCoeff() == Approx(Bx.minCoeff()));
+        }
+    }
+}
+
+TEST_CASE("Normal cone of contact directions")
+{
+    typedef InterlockingSolver<double>::Vector3 Vector3;
+    vector<Vector3> normals = {Vector3(1, 0, 0), Vector3(-1, 0, 0), Vector3(0, 1, 0), Vector3(0, -1, 0), Vector3(0, 0, 1)};
+    Vector3 direction;
+
+    SECTION("open box"){
+        REQUIRE(InterlockingSolver<double>::computeConeDirection(normals, direction) == true);
+        REQUIRE((direction - Vector3(0, 0, 1)).norm() == Approx(0).margin(1e-7));
+    }
+
+    SECTION("closed box"){
+        normals.push_back(Vector3(0, 0, -1));
+        REQUIRE(InterlockingSolver<double>::computeConeDirection(normals, direction) == false);
+    }
+
+    SECTION("tetrahedron"){
+        normals = {Vector3(1, 1, 1), Vector3(1, -1, -1), Vector3(-1, 1, -1), Vector3(-1, -1, 1)};
+        REQUIRE(InterlockingSolver<double>::computeConeDirection(normals, direction) == false);
+
+        normals.pop_back();
+        REQUIRE(InterlockingSolver<double>::computeConeDirection(normals, direction) == true);
+        for(Vector3 nrm: normals) REQUIRE(nrm.dot(direction) >= -1e-7);
+    }
+
+    SECTION("two opposite normals"){
+        normals = {Vector3(0, 0, 1), Vector3(0, 0, -1)};
+        REQUIRE(InterlockingSolver<double>::computeConeDirection(normals, direction) == true);
+        REQUIRE(direction.z() == Approx(0).margin(1e-7));
+    }
+}
+
 TEST_CASE("Ania Example Clp"){
     std::string file_name[5] = { "piece4_tri.obj", "piece0.obj", "piece1.obj", "piece3.obj", "piece2.obj"};
 
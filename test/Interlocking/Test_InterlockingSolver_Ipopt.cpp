@@ -46,6 +46,65 @@ using namespace Eigen;
          shared_ptr<typename InterlockingSolver<double>::InterlockingData> interlockData;
          REQUIRE(solver.isRotationalInterlocking(interlockData) == true);
      }
+     SECTION("warm started sequence"){
+         // the second solve re-optimizes the same problem from the first solution
+         atboundary[0] = true;
+         atboundary[1] = true;
+         shared_ptr<ContactGraph<double>>graph = make_shared<ContactGraph<double>>(varList);
+         graph->buildFromMeshes(meshList, atboundary, 1e-3);
+
+         InterlockingSolver_Ipopt<double> solver(graph, varList);
+         shared_ptr<typename InterlockingSolver<double>::InterlockingData> interlockData;
+         REQUIRE(solver.isRotationalInterlocking(interlockData) == true);
+         REQUIRE(solver.isRotationalInterlocking(interlockData) == true);
+         REQUIRE(solver.numProblems == 1);
+         REQUIRE(solver.numWarmStarts == 1);
+     }
+     SECTION("sequence of row bounds"){
+         atboundary[0] = true;
+         atboundary[1] = true;
+         shared_ptr<ContactGraph<double>>graph = make_shared<ContactGraph<double>>(varList);
+         graph->buildFromMeshes(meshList, atboundary, 1e-3);
+
+         InterlockingSolver_Ipopt<double> solver(graph, varList);
+         typename InterlockingSolver<double>::DynamicComponent component;
+         vector<int> localIDs;
+         vector<Triplet<double>> tris;
+         Vector2i size;
+         solver.computeWholeGraphComponent(component, localIDs);
+         solver.computePresolvedInterlockingMatrix(component, localIDs, true, tris, size);
+         int num_var = size[1];
+         solver.appendAuxiliaryVariables(tris, size);
+         solver.appendMergeConstraints(tris, size, true);
+
+         // the rows A * x + t >= 0, then relaxed by 1e-2
+         vector<VectorXd> rowLowers = {VectorXd::Zero(size[0]), VectorXd::Constant(size[0], -1e-2)};
+         vector<shared_ptr<typename InterlockingSolver<double>::InterlockingData>> datas;
+         vector<bool> results;
+         solver.solveSequence(datas, tris, true, size[0], size[1], num_var, rowLowers, results);
+         REQUIRE(results.size() == 2);
+         REQUIRE(results[0] == true);
+
+         // one problem, the second bound is started from the solution of the first one
+         REQUIRE(solver.numProblems == 1);
+         REQUIRE(solver.numWarmStarts == 1);
+
+         // the same results as a fresh solver for each bound
+         for(int id = 0; id < 2; id++){
+             InterlockingSolver_Ipopt<double> fresh_solver(graph, varList);
+             vector<shared_ptr<typename InterlockingSolver<double>::InterlockingData>> fresh_datas;
+             vector<bool> fresh_results;
+             fresh_solver.solveSequence(fresh_datas, tris, true, size[0], size[1], num_var, {rowLowers[id]}, fresh_results);
+             REQUIRE(fresh_solver.numWarmStarts == 0);
+             REQUIRE(fresh_results[0] == results[id]);
+         }
+
+         // the same matrix again: update() keeps the problem and both solves are warm started
+         solver.solveSequence(datas, tris, true, size[0], size[1], num_var, rowLowers, results);
+         REQUIRE(solver.numProblems == 1);
+         REQUIRE(solver.numWarmStarts == 3);
+         REQUIRE(results[0] == true);
+     }
      SECTION("fix key"){
          // if only set the key to be fixed
          // the reset parts could move together, therefore the structure is not interlocking
@@ -128,7 +187,7 @@ TEST_CASE("IpoptProblem eval_g") {
 
     SparseMatrix<double> b(4, 6);
     b.setFromTriplets(triplets.begin(), triplets.end());
-    ipb->b_coeff = b;
+    ipb->set_coefficients(b);
 
     VectorXd g(6), x(6), g_expected(4);
     x << 1, 2, 3, 4, 5, 6; 
@@ -157,7 +216,7 @@ TEST_CASE("IpoptProblem eval_jac_g") {
 
     SparseMatrix<double> b(4, 6);
     b.setFromTriplets(triplets.begin(), triplets.end());
-    ipb->b_coeff = b;
+    ipb->set_coefficients(b);
 
     VectorXd j(4), j_expected(4);
     j_expected << 1, 2, 1, 1;
@@ -192,6 +251,43 @@ TEST_CASE("IpoptProblem eval_jac_g") {
     }
 }
 
+TEST_CASE("IpoptProblem CSR coefficients") {
+    SmartPtr<IpoptProblem> ipb = new IpoptProblem();       // problem to solve
+
+    std::vector<Triplet<double>> triplets;
+    triplets.push_back(Triplet<double>(0, 0, 1));
+    triplets.push_back(Triplet<double>(0, 2, 2));
+    triplets.push_back(Triplet<double>(1, 1, -1));
+    triplets.push_back(Triplet<double>(1, 3, 1));
+
+    SparseMatrix<double> b(2, 4);
+    b.setFromTriplets(triplets.begin(), triplets.end());
+    ipb->initialize(b);
+
+    // each row ends with the big M column
+    REQUIRE(ipb->non_zero_jacobian_elements == 6);
+    REQUIRE(ipb->jac_rows == vector<int>({0, 0, 0, 1, 1, 1}));
+    REQUIRE(ipb->jac_cols == vector<int>({0, 2, 4, 1, 3, 4}));
+
+    double x[5] = {1, 2, 3, 4, 5}, g[2];
+    ipb->eval_g(5, x, false, 2, g);
+    REQUIRE(g[0] == 12);
+    REQUIRE(g[1] == 7);
+
+    SECTION("same sparsity") {
+        SparseMatrix<double> b2 = b * 2.0;
+        REQUIRE(ipb->update(b2) == true);
+        REQUIRE(ipb->jac_values[1] == 4);
+    }
+
+    SECTION("different sparsity") {
+        SparseMatrix<double> b3(2, 4);
+        b3.insert(0, 1) = 1;
+        REQUIRE(ipb->update(b3) == false);
+        REQUIRE(ipb->jac_values[1] == 2);
+    }
+}
+
 // TEST_CASE("Ania Example: Special Case"){
 //     //Read all Parts
 
@@ -0,0 +1,85 @@
+#include <catch2/catch.hpp>
+#include "Interlocking/InterlockingSolver_PDHG.h"
+#include "BoxMesh.h"
+
+using pPolyMesh = shared_ptr<PolyMesh<double>>;
+using Eigen::Vector3d;
+
+TEST_CASE("PDHG interlocking LP")
+{
+    shared_ptr<InputVarList> varList = make_shared<InputVarList>();
+    InitVar(varList.get());
+
+    SECTION("a single row"){
+        // min -x s.t. 0 <= x <= 1: x = 1
+        InterlockingSolver_PDHG<double> solver(nullptr, varList);
+        vector<Eigen::Triplet<double>> tris = {Eigen::Triplet<double>(0, 0, 1)};
+        Eigen::VectorXd solution;
+        REQUIRE(solver.solve(solution, tris, 1, 1, 1) == false);
+        REQUIRE(solution[0] == Approx(1).margin(1e-4));
+    }
+
+    SECTION("two opposite rows"){
+        // min 0 s.t. 0 <= x <= 1, 0 <= -x <= 1: x = 0
+        InterlockingSolver_PDHG<double> solver(nullptr, varList);
+        vector<Eigen::Triplet<double>> tris = {Eigen::Triplet<double>(0, 0, 1), Eigen::Triplet<double>(1, 0, -1)};
+        Eigen::VectorXd solution;
+        REQUIRE(solver.solve(solution, tris, 2, 2, 1) == true);
+        REQUIRE(std::abs(solution[0]) < INTERLOCKING_THRESHOLD);
+    }
+
+    SECTION("parallel product"){
+        Eigen::SparseMatrix<double, Eigen::RowMajor> A(300, 200);
+        vector<Eigen::Triplet<double>> tris;
+        for(int id = 0; id < 300; id++){
+            tris.push_back(Eigen::Triplet<double>(id, id % 200, 1 + id));
+            tris.push_back(Eigen::Triplet<double>(id, (id * 7) % 200, -0.5));
+        }
+        A.setFromTriplets(tris.begin(), tris.end());
+        Eigen::VectorXd x = Eigen::VectorXd::LinSpaced(200, -1, 1), y;
+        InterlockingSolver_PDHG<double>::multiply(A, x, y);
+        REQUIRE((y - A * x).norm() == Approx(0).margin(1e-9));
+    }
+
+    SECTION("boxes in a well"){
+        // a well made of a fixed base and four fixed walls, A in the well, B on A, C on B
+        vector<pPolyMesh> meshes;
+        meshes.push_back(createBoxMesh(Vector3d(0, 0, 0), Vector3d(1, 1, 1), varList));
+        meshes.push_back(createBoxMesh(Vector3d(0, 0, 1), Vector3d(1, 1, 2), varList));
+        meshes.push_back(createBoxMesh(Vector3d(0, 0, 2), Vector3d(1, 1, 3), varList));
+        meshes.push_back(createBoxMesh(Vector3d(-1, 0, 1), Vector3d(0, 1, 4), varList));
+        meshes.push_back(createBoxMesh(Vector3d(1, 0, 1), Vector3d(2, 1, 4), varList));
+        meshes.push_back(createBoxMesh(Vector3d(0, -1, 1), Vector3d(1, 0, 4), varList));
+        meshes.push_back(createBoxMesh(Vector3d(0, 1, 1), Vector3d(1, 2, 4), varList));
+        meshes.push_back(createBoxMesh(Vector3d(0, 0, 3), Vector3d(1, 1, 4), varList));
+        vector<bool> atBoundary = {true, false, false, true, true, true, true, false};
+
+        shared_ptr<ContactGraph<double>> graph = make_shared<ContactGraph<double>>(varList);
+        shared_ptr<InterlockingSolver<double>::InterlockingData> data;
+
+        // the column can be lifted
+        graph->buildFromMeshes(meshes, atBoundary);
+        InterlockingSolver_PDHG<double> open_solver(graph, varList);
+        REQUIRE(open_solver.isRotationalInterlocking(data) == false);
+        REQUIRE(data->traslation[7][2] > 0);
+
+        // a fixed top closes the well
+        atBoundary.back() = true;
+        graph = make_shared<ContactGraph<double>>(varList);
+        graph->buildFromMeshes(meshes, atBoundary);
+        InterlockingSolver_PDHG<double> closed_solver(graph, varList);
+        closed_solver.verbose = false;
+        REQUIRE(closed_solver.isRotationalInterlocking(data) == true);
+        REQUIRE(closed_solver.isTranslationalInterlocking(data) == true);
+
+        // the two boxes between the base and the top only hold each other, the LP decides both
+        REQUIRE(closed_solver.numConeImmobileParts == 0);
+        REQUIRE(closed_solver.numConeLPParts == 2);
+
+        // an unfinished run cannot certify the interlocking
+        InterlockingSolver_PDHG<double> capped_solver(graph, varList);
+        capped_solver.maxIterations = 1;
+        REQUIRE(capped_solver.isRotationalInterlocking(data) == false);
+        REQUIRE(capped_solver.isTranslationalInterlocking(data) == false);
+    }
+}
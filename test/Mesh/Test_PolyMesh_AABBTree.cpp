@@ -53,6 +53,51 @@ TEST_CASE("PolyMesh_AABBTree - Test findTexPoint")
     }
 }
 
+TEST_CASE("PolyMesh_AABBTree - Test findTexPoints")
+{
+    shared_ptr<InputVarList> varList;
+    varList = make_shared<InputVarList>();
+    InitVar(varList.get());
+    shared_ptr<PolyMesh<double>> polyMesh = make_shared<PolyMesh<double>>(varList);
+    polyMesh->readOBJModel("data/Mesh/primitives/Icosphere.obj", true);
+    PolyMesh_AABBTree<double> aabbTree(*polyMesh);
+    aabbTree.buildTexTree();
+
+    vector<Vector2d> pts;
+    for(int id = 0; id <= 40; id++){
+        for(int jd = 0; jd <= 40; jd++){
+            pts.push_back(Vector2d(-0.1 + id * 0.03, -0.1 + jd * 0.03));
+        }
+    }
+
+    PolyMesh_AABBTree<double>::TexPointQueryResult result;
+    aabbTree.findTexPoints(pts, result);
+    REQUIRE(result.faceIDs.size() == pts.size());
+    REQUIRE(result.barycentric.size() == pts.size() * 3);
+
+    SECTION("same answer as findTexPoint"){
+        for(size_t id = 0; id < pts.size(); id++)
+        {
+            shared_ptr<_Polygon<double>> poly = aabbTree.findTexPoint(pts[id]);
+            REQUIRE((poly == nullptr) == (result.faceIDs[id] == -1));
+        }
+    }
+
+    SECTION("barycentric coordinates recover the query"){
+        for(size_t id = 0; id < pts.size(); id++)
+        {
+            int triID = result.triIDs[id];
+            if(triID == -1) continue;
+            Vector2d pt(0, 0);
+            for(int kd = 0; kd < 3; kd++){
+                Vector2d corner = aabbTree.tV.row(aabbTree.tF(triID, kd));
+                pt += corner * result.barycentric[id * 3 + kd];
+            }
+            REQUIRE((pt - pts[id]).norm() == Approx(0).margin(1e-6));
+        }
+    }
+}
+
 TEST_CASE("AABBTree_Line Quads - Test findIntersec") {
     AABBTree_Line<double> aabb_line;
     shared_ptr<InputVarList> varList;
@@ -0,0 +1,52 @@
+#include <catch2/catch.hpp>
+#include "Mesh/VoxelGrid.h"
+#include "IO/InputVar.h"
+
+TEST_CASE("VoxelGrid")
+{
+    shared_ptr<InputVarList> varList = make_shared<InputVarList>();
+    InitVar(varList.get());
+    VoxelGrid<double> grid(varList);
+
+    SECTION("read puz"){
+        REQUIRE(grid.readPUZ("data/Voxel/bunny_15x14x11_K80.puz"));
+        REQUIRE(grid.dims == Eigen::Vector3i(15, 11, 14));
+        REQUIRE(grid.numParts == 80);
+        REQUIRE(grid.voxelSize == Approx(1.0 / 16));
+        REQUIRE(!grid.readPUZ("data/Voxel/missing.puz"));
+    }
+
+    SECTION("labels"){
+        REQUIRE(grid.setLabels(Eigen::Vector3i(3, 1, 1), {2, 0, 1}));
+        REQUIRE(grid.numParts == 2);
+        REQUIRE(grid.numVoxels() == 2);
+
+        // the label 2 has no voxel
+        REQUIRE(!grid.setLabels(Eigen::Vector3i(3, 1, 1), {3, 0, 1}));
+        REQUIRE(grid.numParts == 0);
+        REQUIRE(!grid.setLabels(Eigen::Vector3i(3, 1, 1), {-1, 0, 1}));
+        REQUIRE(!grid.setLabels(Eigen::Vector3i(2, 1, 1), {0, 0, 1}));
+    }
+
+    SECTION("part meshes are placed as the exported parts"){
+        REQUIRE(grid.readPUZ("data/Voxel/Cube_4x4x4_K9.puz"));
+        REQUIRE(grid.numVoxels() == 64);
+
+        vector<shared_ptr<PolyMesh<double>>> meshes;
+        grid.getPartMeshes(meshes);
+        REQUIRE(meshes.size() == 9);
+
+        for(int id = 0; id < 9; id++)
+        {
+            PolyMesh<double> part(varList);
+            std::string filename = "data/Voxel/Cube/part_" + std::to_string(id + 1) + ".obj";
+            REQUIRE(part.readOBJModel(filename.c_str(), false));
+
+            int count = std::count(grid.labels.begin(), grid.labels.end(), id + 1);
+            REQUIRE(meshes[id]->volume() == Approx(count * 0.008));
+            REQUIRE(meshes[id]->volume() == Approx(part.volume()));
+            REQUIRE((meshes[id]->bbox().minPt - part.bbox().minPt).norm() == Approx(0).margin(1e-6));
+            REQUIRE((meshes[id]->bbox().maxPt - part.bbox().maxPt).norm() == Approx(0).margin(1e-6));
+        }
+    }
+}
@@ -0,0 +1,98 @@
+#include <catch2/catch.hpp>
+#include "Pipeline/PipelineQueue.h"
+
+#if defined(GCC_VERSION_LESS_8)
+#include <experimental/filesystem>
+    using namespace std::experimental::filesystem;
+#else
+#include <filesystem>
+using namespace std::filesystem;
+#endif
+
+TEST_CASE("PipelineQueue")
+{
+    path dataPath(UNITTEST_DATAPATH);
+    PipelineJob job;
+    job.input = (dataPath / "TopoInterlock/XML/origin.xml").string();
+
+    SECTION("the parts of a project are reused"){
+        PipelineQueue queue(1, 2);
+        int first = queue.submit(job);
+        int second = queue.submit(job);
+
+        PipelineResult result;
+        REQUIRE(queue.result(first, result, true));
+        REQUIRE(result.success);
+        REQUIRE(!result.cached);
+        int num_contacts = result.num_contacts;
+
+        REQUIRE(queue.result(second, result, true));
+        REQUIRE(result.success);
+        REQUIRE(result.cached);
+        REQUIRE(result.num_contacts == num_contacts);
+        REQUIRE(queue.status(second) == PipelineQueue::JOB_DONE);
+
+        REQUIRE(queue.release(second));
+        REQUIRE(queue.status(second) == PipelineQueue::JOB_UNKNOWN);
+    }
+
+    SECTION("the cache follows the referenced files"){
+        path folder = temp_directory_path() / "TopoLite_PipelineQueue";
+        remove_all(folder);
+        create_directories(folder);
+        copy(dataPath / "TopoInterlock/XML/origin_data", folder / "origin_data", copy_options::recursive);
+        copy_file(dataPath / "TopoInterlock/XML/origin.xml", folder / "origin.xml");
+        copy_file(dataPath / "TopoInterlock/XML/origin.xml", folder / "copy.xml");
+
+        PipelineJob origin = job, other = job;
+        origin.input = (folder / "origin.xml").string();
+        other.input = (folder / "copy.xml").string();
+
+        PipelineQueue queue(1, 2, 1);
+        PipelineResult result;
+        REQUIRE(queue.result(queue.submit(origin), result, true));
+        REQUIRE(result.success);
+        REQUIRE(!result.cached);
+        REQUIRE(result.files.size() > 1);
+
+        // a referenced file is modified
+        last_write_time(result.files[1], last_write_time(result.files[1]) + std::chrono::hours(1));
+        REQUIRE(queue.result(queue.submit(origin), result, true));
+        REQUIRE(!result.cached);
+        REQUIRE(queue.result(queue.submit(origin), result, true));
+        REQUIRE(result.cached);
+
+        // a single project is kept
+        REQUIRE(queue.result(queue.submit(other), result, true));
+        REQUIRE(!result.cached);
+        REQUIRE(queue.result(queue.submit(origin), result, true));
+        REQUIRE(!result.cached);
+
+        remove_all(folder);
+    }
+
+    SECTION("a queued job is cancelled"){
+        PipelineQueue queue(1, 2);
+        int running = queue.submit(job);
+        int low = queue.submit(job, -1);
+        int high = queue.submit(job, 1);
+        REQUIRE(queue.cancel(low));
+
+        PipelineResult result;
+        REQUIRE(queue.result(low, result, true));
+        REQUIRE(queue.status(low) == PipelineQueue::JOB_CANCELLED);
+        REQUIRE(result.error == "cancelled");
+
+        REQUIRE(queue.result(high, result, true));
+        REQUIRE(result.success);
+        REQUIRE(queue.result(running, result, true));
+    }
+
+    SECTION("unknown job"){
+        PipelineQueue queue(1, 1);
+        PipelineResult result;
+        REQUIRE(queue.status(42) == PipelineQueue::JOB_UNKNOWN);
+        REQUIRE(!queue.result(42, result, true));
+        REQUIRE(!queue.cancel(42));
+    }
+}
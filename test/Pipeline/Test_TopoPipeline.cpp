@@ -0,0 +1,79 @@
+#include <catch2/catch.hpp>
+#include "Pipeline/TopoPipeline.h"
+
+#if defined(GCC_VERSION_LESS_8)
+#include <experimental/filesystem>
+    using namespace std::experimental::filesystem;
+#else
+#include <filesystem>
+using namespace std::filesystem;
+#endif
+
+TEST_CASE("TopoPipeline")
+{
+    TopoPipeline<double> pipeline;
+    path dataPath(UNITTEST_DATAPATH);
+
+    SECTION("input type"){
+        REQUIRE(TopoPipeline<double>::inputType((dataPath / "TopoInterlock/XML/origin.xml").string()) == "xml");
+        REQUIRE(TopoPipeline<double>::inputType((dataPath / "TopoInterlock/Json/origin.json").string()) == "json");
+        REQUIRE(TopoPipeline<double>::inputType((dataPath / "TopoInterlock/XML/origin_data/PartGeometry").string()) == "obj");
+        REQUIRE(TopoPipeline<double>::inputType((dataPath / "Mesh/primitives/cube.obj").string()).empty());
+    }
+
+    SECTION("xml project"){
+        PipelineJob job;
+        job.input = (dataPath / "TopoInterlock/XML/origin.xml").string();
+        PipelineResult result = pipeline.run(job);
+        REQUIRE(result.success);
+        REQUIRE(result.num_parts > 0);
+        REQUIRE(result.num_contacts > 0);
+        REQUIRE(result.to_json()["type"] == "xml");
+    }
+
+    SECTION("obj parts"){
+        PipelineJob job;
+        job.input = (dataPath / "TopoInterlock/XML/origin_data/PartGeometry").string();
+
+        vector<shared_ptr<PolyMesh<double>>> meshes;
+        vector<bool> atBoundary;
+        shared_ptr<InputVarList> varList = make_shared<InputVarList>();
+        InitVar(varList.get());
+        REQUIRE(pipeline.readParts(job.input, job.boundaryParts, varList, meshes, atBoundary));
+        REQUIRE(meshes.size() == 62);
+        REQUIRE(std::count(atBoundary.begin(), atBoundary.end(), true) == 1);
+
+        PipelineResult result = pipeline.run(job);
+        REQUIRE(result.success);
+        REQUIRE(result.num_parts == 62);
+    }
+
+    SECTION("voxel puzzle"){
+        PipelineJob job;
+        job.input = (dataPath / "Voxel/bunny_15x14x11_K80.puz").string();
+        job.boundaryParts = {"part_1", "part_2"};
+        REQUIRE(TopoPipeline<double>::inputType(job.input) == "puz");
+
+        PipelineResult result = pipeline.run(job);
+        REQUIRE(result.success);
+        REQUIRE(result.type == "puz");
+        REQUIRE(result.num_parts == 80);
+        REQUIRE(result.num_contacts > 0);
+
+        // the part meshes give the same parts
+        shared_ptr<IOData> data = make_shared<IOData>();
+        vector<shared_ptr<PolyMesh<double>>> meshes;
+        vector<bool> atBoundary;
+        REQUIRE(pipeline.loadParts(job, data, meshes, atBoundary, result));
+        REQUIRE(meshes.size() == 80);
+        REQUIRE(std::count(atBoundary.begin(), atBoundary.end(), true) == 2);
+    }
+
+    SECTION("missing input"){
+        PipelineJob job;
+        job.input = (dataPath / "TopoInterlock/XML/missing.xml").string();
+        PipelineResult result = pipeline.run(job);
+        REQUIRE(result.success == false);
+        REQUIRE(result.to_json().contains("error"));
+    }
+}
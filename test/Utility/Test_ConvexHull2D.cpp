@@ -75,4 +75,14 @@ TEST_CASE(){
     convexhull2d.compute(pts, outPts);
 
     REQUIRE(compareListVector3(outPts, resPts) == true);
-}
\ No newline at end of file
+
+    // the same hull on projected 2D points
+    ConvexHull2D<double>::ListVector2 pts2D, outPts2D;
+    for(Eigen::Vector3d pt: pts) pts2D.push_back(pt.head(2));
+    convexhull2d.compute(pts2D, outPts2D);
+
+    REQUIRE(outPts2D.size() == outPts.size());
+    for(size_t id = 0; id < outPts.size(); id++){
+        REQUIRE((outPts2D[id] - outPts[id].head(2)).norm() < 1e-12);
+    }
+}
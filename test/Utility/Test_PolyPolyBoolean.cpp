@@ -2,7 +2,9 @@
 // Created by ziqwang on 2019-12-11.
 //
 #include "Utility/PolyPolyBoolean.h"
+#include "Mesh/PolyMesh.h"
 #include <catch2/catch.hpp>
+#include <tbb/tick_count.h>
 using Eigen::Vector3d;
 using Eigen::Vector2d;
 
@@ -13,6 +15,14 @@ void Scale_ListVector3d(vector<Vector3d>& poly, double Scale = 10000){
     return;
 }
 
+double computeArea_ListVector3d(const vector<Vector3d>& poly){
+    Vector3d area(0, 0, 0);
+    for(size_t id = 0; id < poly.size(); id++){
+        area += poly[id].cross(poly[(id + 1) % poly.size()]);
+    }
+    return area.norm() / 2;
+}
+
 TEST_CASE("Class PolyPolyBoolean")
 {
     shared_ptr<InputVarList> varList = make_shared<InputVarList>();
@@ -266,5 +276,112 @@ TEST_CASE("Class PolyPolyBoolean")
         REQUIRE(area == Approx(1.0 / 2).margin(1e-6));
     }
 
+    SECTION("convex intersection agrees with Clipper")
+    {
+        vector<Vector3d> A;
+        A.push_back(Vector3d(0, 0, 1));
+        A.push_back(Vector3d(1, 0, 1));
+        A.push_back(Vector3d(1, 0.8, 1));
+        A.push_back(Vector3d(1, 1, 1));
+        A.push_back(Vector3d(0.8, 1, 1));
+        A.push_back(Vector3d(0, 1, 1));
+
+        // B has the opposite orientation, as the contact faces of two parts
+        vector<Vector3d> B;
+        B.push_back(Vector3d(1.5, 1.5, 1));
+        B.push_back(Vector3d(1.5, 0.5, 1));
+        B.push_back(Vector3d(0.4, 0.5, 1));
+
+        vector<vector<Vector3d>> convexIntersec, clipperIntersec;
+        REQUIRE(polyBoolean.computePolygonsIntersection_Convex(A, B, convexIntersec));
+        polyBoolean.computePolygonsIntersection_Clipper(A, B, clipperIntersec);
+
+        REQUIRE(convexIntersec.size() == 1);
+        REQUIRE(clipperIntersec.size() == 1);
+        REQUIRE(convexIntersec[0].size() == clipperIntersec[0].size());
+        REQUIRE(computeArea_ListVector3d(convexIntersec[0]) == Approx(computeArea_ListVector3d(clipperIntersec[0])).margin(1e-5));
+        for(Vector3d pt: convexIntersec[0]){
+            REQUIRE(pt.z() == Approx(1));
+        }
+    }
+
+    SECTION("convex intersection of touching polygons is empty")
+    {
+        vector<Vector3d> A = {Vector3d(0, 0, 0), Vector3d(1, 0, 0), Vector3d(1, 1, 0), Vector3d(0, 1, 0)};
+        vector<Vector3d> B = {Vector3d(1, 0, 0), Vector3d(1, 1, 0), Vector3d(2, 1, 0), Vector3d(2, 0, 0)};
+
+        vector<vector<Vector3d>> polyIntersec;
+        REQUIRE(polyBoolean.computePolygonsIntersection_Convex(A, B, polyIntersec));
+        REQUIRE(polyIntersec.empty());
+    }
+
+    SECTION("non-convex polygons fall back to Clipper")
+    {
+        vector<Vector3d> A = {Vector3d(0, 0, 0), Vector3d(2, 0, 0), Vector3d(2, 2, 0), Vector3d(1, 1, 0), Vector3d(0, 2, 0)};
+        vector<Vector3d> B = {Vector3d(0, 0, 0), Vector3d(2, 0, 0), Vector3d(2, 2, 0), Vector3d(0, 2, 0)};
+
+        vector<vector<Vector3d>> polyIntersec;
+        REQUIRE(polyBoolean.computePolygonsIntersection_Convex(A, B, polyIntersec) == false);
+        polyBoolean.computePolygonsIntersection(A, B, polyIntersec);
+        REQUIRE(polyIntersec.size() == 1);
+        REQUIRE(computeArea_ListVector3d(polyIntersec[0]) == Approx(3).margin(1e-4));
+    }
+}
+
+TEST_CASE("Benchmark PolyPolyBoolean on contact faces", "[.][benchmark]")
+{
+    shared_ptr<InputVarList> varList = make_shared<InputVarList>();
+    InitVar(varList.get());
+    PolyPolyBoolean<double> polyBoolean(varList);
+
+    // the faces of the bunny puzzle
+    vector<vector<Vector3d>> faces;
+    vector<int> partIDs;
+    for(int id = 1; id <= 80; id++){
+        char number[50];
+        sprintf(number, "%d.obj", id);
+        std::string part_filename = "data/Voxel/bunny/part_";
+        part_filename += number;
+        PolyMesh<double> polyMesh(varList);
+        polyMesh.readOBJModel(part_filename.c_str(), false);
+        for(size_t jd = 0; jd < polyMesh.polyList.size(); jd++){
+            faces.push_back(polyMesh.polyList[jd]->getVertices());
+            partIDs.push_back(id);
+        }
+    }
+
+    // two faces of different parts on a same plane with opposite normals
+    vector<std::pair<int, int>> pairs;
+    for(size_t id = 0; id < faces.size(); id++){
+        Vector3d nrmI = (faces[id][1] - faces[id][0]).cross(faces[id][2] - faces[id][0]).normalized();
+        for(size_t jd = id + 1; jd < faces.size(); jd++){
+            if(partIDs[id] == partIDs[jd]) continue;
+            Vector3d nrmJ = (faces[jd][1] - faces[jd][0]).cross(faces[jd][2] - faces[jd][0]).normalized();
+            if(std::abs(nrmI.dot(nrmJ) + 1) > 1e-5 || std::abs(nrmI.dot(faces[jd][0] - faces[id][0])) > 1e-5) continue;
+            pairs.push_back(std::make_pair(id, jd));
+        }
+    }
+    REQUIRE(!pairs.empty());
+
+    vector<double> convexAreas(pairs.size(), 0), clipperAreas(pairs.size(), 0);
+
+    tbb::tick_count sta = tbb::tick_count::now();
+    for(size_t id = 0; id < pairs.size(); id++){
+        vector<vector<Vector3d>> polyIntersec;
+        REQUIRE(polyBoolean.computePolygonsIntersection_Convex(faces[pairs[id].first], faces[pairs[id].second], polyIntersec));
+        for(const vector<Vector3d> &poly: polyIntersec) convexAreas[id] += computeArea_ListVector3d(poly);
+    }
+    std::cout << "Convex Intersection (" << pairs.size() << " pairs):\t" << (tbb::tick_count::now() - sta).seconds() << std::endl;
+
+    sta = tbb::tick_count::now();
+    for(size_t id = 0; id < pairs.size(); id++){
+        vector<vector<Vector3d>> polyIntersec;
+        polyBoolean.computePolygonsIntersection_Clipper(faces[pairs[id].first], faces[pairs[id].second], polyIntersec);
+        for(const vector<Vector3d> &poly: polyIntersec) clipperAreas[id] += computeArea_ListVector3d(poly);
+    }
+    std::cout << "Clipper Intersection (" << pairs.size() << " pairs):\t" << (tbb::tick_count::now() - sta).seconds() << std::endl;
 
-}
\ No newline at end of file
+    for(size_t id = 0; id < pairs.size(); id++){
+        REQUIRE(convexAreas[id] == Approx(clipperAreas[id]).margin(1e-5));
+    }
+}